@@ -24,7 +24,10 @@ GameManager::GameManager(unsigned int width, unsigned int height)
       language(ConfigManager::GetInstance().GetLanguage()),
       width(static_cast<float>(width)),
       height(static_cast<float>(height)),
-      score(ConfigManager::GetInstance().GetScore()) {}
+      score(ConfigManager::GetInstance().GetScore()) {
+  // Every color starts with a weight of 1.
+  colorWeight.fill(1.f);
+}
 
 GameManager::~GameManager() {
   // Clear all resources
@@ -827,8 +830,9 @@ void GameManager::Init() {
                    pages[languagePreferencePageName]->GetHeight() * 0.5f,
                this->gameBoard->GetPosition().y)));
 
-  // Initialize the timer
-  timer = std::make_shared<Timer>();
+  // Initialize the timer, which advances by one simulation step per update.
+  timer = std::make_shared<Timer>(
+      1.f / static_cast<float>(ConfigManager::GetInstance().GetTickRate()));
 
   // Set the target silk length for closing and opening the scroll
   scroll->SetTargetSilkLenForClosing(0.f);
@@ -968,6 +972,316 @@ void GameManager::Reload(const GameStateSnapshot& snapshot) {
   this->scroll->SetState(ScrollState::OPENED);
 }
 
+void GameManager::OnKey(int key, int action) {
+  if (key >= 0 && key < 1024) {
+    if (action == GLFW_PRESS)
+      this->keys[key] = true;
+    else if (action == GLFW_RELEASE) {
+      this->keys[key] = false;
+      this->keysLocked[key] = false;
+    }
+  }
+}
+
+void GameManager::OnMouseButton(int button, int action) {
+  if (button == GLFW_MOUSE_BUTTON_LEFT) {
+    if (action == GLFW_PRESS) {
+      if (this->leftMousePressed == false) {
+        this->leftMousePressed = true;
+        this->mouseLastX = this->mouseX;
+        this->mouseLastY = this->mouseY;
+      }
+    } else if (action == GLFW_RELEASE) {
+      // When left mouse button is released, stop dragging
+      this->leftMousePressed = false;
+      this->isReadyToDrag = true;
+      this->isDragging = false;
+    }
+  }
+}
+
+void GameManager::OnCursorPosition(float virtualX, float virtualY) {
+  this->mouseX = virtualX;
+  this->mouseY = virtualY;
+}
+
+void GameManager::OnScroll(float yOffset) { this->scrollYOffset = yOffset; }
+
+uint64_t GameManager::GetStateHash() const {
+  uint64_t hash = board.Hash();
+  const int64_t values[] = {static_cast<int64_t>(state), level, score,
+                            comboCount};
+  for (int64_t value : values) {
+    hash ^= static_cast<uint64_t>(value);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+namespace {
+
+// Characters whose health is kept in a snapshot, in the order they are saved.
+constexpr StringId kSnapshotCharacters[] = {"liuche", "weizifu", "guojie",
+                                            "weiqing"};
+
+}  // namespace
+
+std::vector<uint8_t> GameManager::SaveSnapshot() const {
+  SnapshotWriter writer;
+  writer.Write(state);
+  writer.Write(difficulty);
+  writer.Write(level);
+  writer.Write(gameLevel);
+  writer.Write(kBubbleRadius);
+  writer.Write(score);
+  writer.Write(comboCount);
+  writer.Write(isLevelFailed);
+  writer.Write(colorCount);
+  writer.Write(colorWeight);
+  timer->Save(writer);
+  for (int i = 0; i < static_cast<int>(RandomStream::kNumStreams); ++i) {
+    writer.Write(Random::Get(static_cast<RandomStream>(i)).GetState());
+  }
+
+  // Geometry of the scroll and of the part of the game board in play.
+  writer.Write(scroll->GetState());
+  writer.Write(scroll->GetCenter());
+  writer.Write(scroll->GetSilkLen());
+  writer.Write(scroll->GetTargetSilkLenForNarrowing());
+  writer.Write(scroll->GetCurrentSilkLenForNarrowing());
+  writer.Write(gameBoard->GetValidPosition());
+  writer.Write(gameBoard->GetValidSize());
+  writer.Write(texts.at("time")->GetPosition());
+
+  board.Save(writer);
+
+  // The shooter and the bubbles it carries.
+  writer.Write(shooter->GetPosition());
+  writer.Write(shooter->GetRoll());
+  writer.Write(shooter->GetCarriedBubble().GetColor());
+  writer.Write(shooter->GetNextBubble().GetColor());
+  writer.Write(shooter->HasPowerUp());
+  if (shooter->HasPowerUp()) {
+    writer.Write(static_cast<const PowerUp&>(shooter->GetCarriedBubble())
+                     .GetNumOfDaggers());
+  }
+
+  // The power-up being charged.
+  writer.Write(powerUp->GetPowerUpState());
+  writer.Write(powerUp->GetNumOfDaggers());
+
+  // The bubbles that have been shot and are still moving.
+  writer.Write(static_cast<uint64_t>(moves.size()));
+  for (const auto& [id, bubble] : moves) {
+    const auto* movingPowerUp = dynamic_cast<const PowerUp*>(bubble.get());
+    writer.Write(movingPowerUp != nullptr);
+    writer.Write(bubble->GetCenter());
+    writer.Write(bubble->GetRadius());
+    writer.Write(bubble->GetVelocity());
+    writer.Write(bubble->GetColor());
+    writer.Write(movingPowerUp ? movingPowerUp->GetNumOfDaggers() : 0);
+  }
+
+  for (StringId name : kSnapshotCharacters) {
+    auto it = gameCharacters.find(name);
+    bool hasCharacter = it != gameCharacters.end();
+    writer.Write(hasCharacter);
+    if (hasCharacter) {
+      writer.Write(it->second->GetHealth().GetCurrentHealth());
+    }
+  }
+  return writer.GetBuffer();
+}
+
+bool GameManager::LoadSnapshot(const std::vector<uint8_t>& snapshot) {
+  // Everything is read into locals first and applied only once the whole
+  // snapshot has been read and checked, so a snapshot that fails to load
+  // leaves the game as it was.
+  SnapshotReader reader(snapshot);
+  GameState snapshotState = GameState::UNDEFINED;
+  Difficulty snapshotDifficulty = Difficulty::UNDEFINED;
+  if (!reader.Read(snapshotState) || !reader.Read(snapshotDifficulty) ||
+      snapshotState != state || snapshotDifficulty != difficulty) {
+    return false;
+  }
+  int snapshotLevel = 0;
+  GameLevel snapshotGameLevel;
+  float bubbleRadius = 0.f;
+  int64_t snapshotScore = 0;
+  int snapshotComboCount = 0;
+  bool snapshotIsLevelFailed = false;
+  ColorArray<int> snapshotColorCount{};
+  ColorArray<float> snapshotColorWeight{};
+  reader.Read(snapshotLevel);
+  reader.Read(snapshotGameLevel);
+  reader.Read(bubbleRadius);
+  reader.Read(snapshotScore);
+  reader.Read(snapshotComboCount);
+  reader.Read(snapshotIsLevelFailed);
+  reader.Read(snapshotColorCount);
+  reader.Read(snapshotColorWeight);
+  Timer snapshotTimer = *timer;
+  if (!snapshotTimer.Load(reader)) {
+    return false;
+  }
+  std::array<std::array<uint64_t, 4>,
+             static_cast<size_t>(RandomStream::kNumStreams)>
+      rngStates{};
+  for (std::array<uint64_t, 4>& rngState : rngStates) {
+    reader.Read(rngState);
+  }
+
+  ScrollState scrollState = ScrollState::OPENED;
+  glm::vec2 scrollCenter{0.f}, validPosition{0.f}, validSize{0.f},
+      timeTextPosition{0.f};
+  float silkLen = 0.f, targetSilkLen = 0.f, currentSilkLen = 0.f;
+  reader.ReadEnum(scrollState, DISABLED);
+  reader.Read(scrollCenter);
+  reader.Read(silkLen);
+  reader.Read(targetSilkLen);
+  reader.Read(currentSilkLen);
+  reader.Read(validPosition);
+  reader.Read(validSize);
+  reader.Read(timeTextPosition);
+
+  BubbleBoard snapshotBoard = board;
+  if (!snapshotBoard.Load(reader)) {
+    return false;
+  }
+
+  glm::vec2 shooterPosition{0.f};
+  float shooterRoll = 0.f;
+  glm::vec4 carriedColor{0.f}, nextColor{0.f};
+  bool hasPowerUp = false;
+  int numOfCarriedDaggers = 0;
+  reader.Read(shooterPosition);
+  reader.Read(shooterRoll);
+  reader.Read(carriedColor);
+  reader.Read(nextColor);
+  reader.Read(hasPowerUp);
+  if (hasPowerUp) {
+    reader.Read(numOfCarriedDaggers);
+  }
+
+  PowerUpState powerUpState = PowerUpState::kInactive;
+  int numOfDaggers = 0;
+  reader.ReadEnum(powerUpState, PowerUpState::Undefined);
+  reader.Read(numOfDaggers);
+
+  struct MovingBubble {
+    bool isPowerUp{false};
+    glm::vec2 center{0.f};
+    float radius{0.f};
+    glm::vec2 velocity{0.f};
+    glm::vec4 color{0.f};
+    int numOfDaggers{0};
+  };
+  uint64_t numMoves = 0;
+  reader.Read(numMoves);
+  std::vector<MovingBubble> movingBubbles;
+  for (uint64_t i = 0; i < numMoves && reader.IsValid(); ++i) {
+    MovingBubble movingBubble;
+    reader.Read(movingBubble.isPowerUp);
+    reader.Read(movingBubble.center);
+    reader.Read(movingBubble.radius);
+    reader.Read(movingBubble.velocity);
+    reader.Read(movingBubble.color);
+    reader.Read(movingBubble.numOfDaggers);
+    movingBubbles.push_back(movingBubble);
+  }
+
+  std::array<std::optional<int>, std::size(kSnapshotCharacters)> healths;
+  for (std::optional<int>& health : healths) {
+    bool hasCharacter = false;
+    int currentHealth = 0;
+    reader.Read(hasCharacter);
+    if (hasCharacter) {
+      reader.Read(currentHealth);
+      health = currentHealth;
+    }
+  }
+  if (!reader.IsValid() || !reader.IsAtEnd()) {
+    return false;
+  }
+
+  // Apply the snapshot.
+  level = snapshotLevel;
+  gameLevel = snapshotGameLevel;
+  kBubbleRadius = bubbleRadius;
+  score = snapshotScore;
+  comboCount = snapshotComboCount;
+  isLevelFailed = snapshotIsLevelFailed;
+  colorCount = snapshotColorCount;
+  colorWeight = snapshotColorWeight;
+  *timer = std::move(snapshotTimer);
+  for (int i = 0; i < static_cast<int>(RandomStream::kNumStreams); ++i) {
+    Random::Get(static_cast<RandomStream>(i)).SetState(rngStates[i]);
+  }
+
+  scroll->SetState(scrollState);
+  scroll->SetCenter(scrollCenter);
+  scroll->SetSilkLen(silkLen);
+  scroll->SetTargetSilkLenForNarrowing(targetSilkLen);
+  scroll->SetCurrentSilkLenForNarrowing(currentSilkLen);
+  gameBoard->SetValidPosition(validPosition);
+  gameBoard->SetValidSize(validSize);
+  texts.at("time")->SetPosition(timeTextPosition);
+
+  board = std::move(snapshotBoard);
+
+  // The power-up is swapped for a new one, so its daggers match the snapshot.
+  if (shooter->HasPowerUp()) {
+    shooter->UnequipPowerUp();
+  }
+  shooter->UpdateCarriedBubbleRadius(kBubbleRadius);
+  if (hasPowerUp) {
+    auto carriedPowerUp = std::make_unique<PowerUp>(*powerUp);
+    carriedPowerUp->SetPowerUpState(PowerUpState::kActive);
+    carriedPowerUp->SetNumOfDaggers(numOfCarriedDaggers);
+    shooter->EquipPowerUp(std::move(carriedPowerUp));
+  }
+  shooter->SetPosition(shooterPosition);
+  shooter->SetRoll(shooterRoll);
+  shooter->RefreshCarriedBubbleColor(glm::vec3(carriedColor));
+  shooter->RefreshNextBubbleColor(glm::vec3(nextColor));
+  shooter->GetRay().MarkPathDirty();
+
+  powerUp->SetPowerUpState(powerUpState);
+  powerUp->SetNumOfDaggers(numOfDaggers);
+
+  moves.clear();
+  previousMovePositions.clear();
+  for (const MovingBubble& movingBubble : movingBubbles) {
+    std::unique_ptr<Bubble> bubble;
+    if (movingBubble.isPowerUp) {
+      auto movingPowerUp = std::make_unique<PowerUp>(*powerUp);
+      movingPowerUp->SetPowerUpState(PowerUpState::kActive);
+      movingPowerUp->SetNumOfDaggers(movingBubble.numOfDaggers);
+      movingPowerUp->SetDaggerRotationSpeed(20.f);
+      bubble = std::move(movingPowerUp);
+    } else {
+      bubble = std::make_unique<Bubble>(
+          movingBubble.center - glm::vec2(movingBubble.radius),
+          movingBubble.radius, movingBubble.velocity, movingBubble.color,
+          ResourceManager::GetInstance().GetTexture("bubble"));
+    }
+    bubble->SetRadius(movingBubble.radius);
+    bubble->SetCenter(movingBubble.center);
+    bubble->SetVelocity(movingBubble.velocity);
+    bubble->SetColor(movingBubble.color);
+    previousMovePositions[bubble->GetID()] = bubble->GetPosition();
+    moves.emplace(bubble->GetID(), std::move(bubble));
+  }
+
+  for (size_t i = 0; i < healths.size(); ++i) {
+    auto it = gameCharacters.find(kSnapshotCharacters[i]);
+    if (healths[i].has_value() && it != gameCharacters.end()) {
+      it->second->GetHealth().SetCurrentHealth(healths[i].value());
+    }
+  }
+  return true;
+}
+
 void GameManager::ProcessInput(float dt) {
   // If 'W' is pressed, then we toggle the windowed mode.
   if (this->keys[GLFW_KEY_W] && this->keysLocked[GLFW_KEY_W] == false) {
@@ -988,7 +1302,7 @@ void GameManager::ProcessInput(float dt) {
         shooter->SetRoll(shooter->GetRoll() - 0.008f);
       }
       shooter->GetRay().UpdatePath(this->gameBoard->GetValidBoundaries(),
-                                   this->statics);
+                                   board.GetGrid());
     } else if (this->keys[GLFW_KEY_RIGHT]) {
       // if the key 'ctrl' is hold, then we rotate the shooter in a smaller
       // angle.
@@ -998,7 +1312,7 @@ void GameManager::ProcessInput(float dt) {
         shooter->SetRoll(shooter->GetRoll() + 0.008f);
       }
       shooter->GetRay().UpdatePath(this->gameBoard->GetValidBoundaries(),
-                                   this->statics);
+                                   board.GetGrid());
     } else if (this->keys[GLFW_KEY_LEFT_SHIFT] &&
                this->keysLocked[GLFW_KEY_LEFT_SHIFT] == false) {
       // Swap the current bubble with the next bubble color.
@@ -1058,12 +1372,12 @@ void GameManager::ProcessInput(float dt) {
         // Set scroll state to be CLOSING
         this->scroll->SetState(ScrollState::CLOSING);
         // pause timer of related events if it is not paused yet.
-        if (!this->timer->IsPaused("beforenarrowing")) {
-          this->timer->PauseEventTimer("beforenarrowing");
+        if (!this->timer->IsPaused(kBeforeNarrowingEvent)) {
+          this->timer->PauseEventTimer(kBeforeNarrowingEvent);
         }
         // pause counting play time
-        if (!this->timer->IsPaused("playtime")) {
-          this->timer->PauseEventTimer("playtime");
+        if (!this->timer->IsPaused(kPlayTimeEvent)) {
+          this->timer->PauseEventTimer(kPlayTimeEvent);
         }
       }
     }
@@ -1103,7 +1417,7 @@ void GameManager::ProcessInput(float dt) {
       // postProcessor->SetBlur(false);
       postProcessor->SetGrayscale(false);
       // gradually fading out the blur effect
-      timer->SetEventTimer("deblurring", 2.f);
+      timer->SetEventTimer(kDeblurringEvent, 2.f);
       // reset the state of each game character
       this->ResetGameCharacters();
 
@@ -1111,7 +1425,7 @@ void GameManager::ProcessInput(float dt) {
       arrows.clear();
 
       // Delete all the static bubbles.
-      statics.clear();
+      board.ClearStatics();
 
       //// Reset score
       // this->ResetScore(ConfigManager::GetInstance().GetScore());
@@ -1124,8 +1438,8 @@ void GameManager::ProcessInput(float dt) {
       texts["defeated"]->SetScale(texts["defeated"]->GetTargetScale("max"));
 
       // Clean the timer for prompt to main menu
-      timer->CleanEvent("prompttomainmenu");
-      timer->CleanEvent("hideprompttomainmenu");
+      timer->CleanEvent(kPromptToMainMenuEvent);
+      timer->CleanEvent(kHidePromptToMainMenuEvent);
 
       // Set the scroll's y position to be out of the top of the screen
       scroll->Reset();
@@ -1324,7 +1638,7 @@ void GameManager::ProcessInput(float dt) {
                 arrows.clear();
 
                 // Delete all the static bubbles.
-                statics.clear();
+                board.ClearStatics();
 
                 // Delete all the moving bubbles.
                 moves.clear();
@@ -1345,7 +1659,7 @@ void GameManager::ProcessInput(float dt) {
                 arrows.clear();
 
                 // Delete all the static bubbles.
-                statics.clear();
+                board.ClearStatics();
 
                 // Delete all the moving bubbles.
                 moves.clear();
@@ -1483,6 +1797,16 @@ void GameManager::ProcessInput(float dt) {
 void GameManager::Update(float dt) {
   auto& soundEngine = SoundEngine::GetInstance();
   soundEngine.Update(dt);
+  if (timer != nullptr) {
+    timer->Tick();
+  }
+
+  // Remember where the bubbles are before this step for interpolated rendering.
+  bubbles.SavePreviousCenters();
+  previousMovePositions.clear();
+  for (auto& [id, bubble] : moves) {
+    previousMovePositions[id] = bubble->GetPosition();
+  }
 
   if (this->state == GameState::PRELOAD) {
     if (this->targetState == GameState::SPLASH_SCREEN) {
@@ -1492,16 +1816,15 @@ void GameManager::Update(float dt) {
     }
     return;
   } else if (this->state == GameState::SPLASH_SCREEN) {
-    if (soundEngine.IsPlaying("white_noise") &&
-        soundEngine.GetPlaybackPosition("white_noise") > 0.45f) {
-      float curVolume = soundEngine.GetVolume("white_noise");
-      float newVolume = curVolume - 0.35f * dt;
-      if (newVolume < 0.05f) {
-        newVolume = 0.05f;
-        soundEngine.SetVolume("white_noise", newVolume);
-      } else {
-        soundEngine.SetVolume("white_noise", newVolume);
-      }
+    // Fade the white noise out once the white noise event expires. The
+    // volume follows the simulation time, not the playback of the sound.
+    if (timer->HasEvent(kWhiteNoiseEvent) &&
+        timer->IsEventTimerExpired(kWhiteNoiseEvent)) {
+      float fadingTime = timer->GetEventUsedTime(kWhiteNoiseEvent) -
+                         timer->GetEventTimer(kWhiteNoiseEvent);
+      float newVolume = soundEngine.GetDefaultVolume("white_noise") -
+                        0.35f * fadingTime;
+      soundEngine.SetVolume("white_noise", std::max(newVolume, 0.05f));
     }
     if (this->targetState == GameState::UNDEFINED) {
       // Make the whole screen become clear from the chaos effect gradually.
@@ -1510,7 +1833,7 @@ void GameManager::Update(float dt) {
       float targetIntensity = 0.6f;
       float targetSampleOffsets = 1.f / 500.f;
       if (postProcessor->GetIntensity() > targetIntensity &&
-          !timer->HasEvent("splash")) {
+          !timer->HasEvent(kSplashEvent)) {
         float newIntensity = postProcessor->GetIntensity() - 0.08f * dt;
         float intensifyDiffProportion = (originalIntensity - newIntensity) /
                                         (originalIntensity - targetIntensity);
@@ -1520,11 +1843,14 @@ void GameManager::Update(float dt) {
                 (originalSampleOffsets - targetSampleOffsets);
         constexpr float thresholdSampleOffsets = 1.f / 1050.f;
         if (newSampleOffsets >= thresholdSampleOffsets &&
-            soundEngine.GetPlayCount("shock_wave") == 0) {
+            !timer->HasEvent(kSplashEndEvent)) {
           soundEngine.PlaySound("shock_wave");
           soundEngine.PlaySound("splash_end", false);
+          // Record that the end of the splash has started.
+          timer->SetEventTimer(kSplashEndEvent, 0.f);
+          timer->StartEventTimer(kSplashEndEvent);
         }
-        if (soundEngine.IsPlaying("splash_end")) {
+        if (timer->HasEvent(kSplashEndEvent)) {
           float sampleOffsetsDiffProportion =
               (thresholdSampleOffsets - newSampleOffsets) /
               (thresholdSampleOffsets - targetSampleOffsets);
@@ -1536,13 +1862,13 @@ void GameManager::Update(float dt) {
           newIntensity = targetIntensity;
           newSampleOffsets = targetSampleOffsets;
           // Stay at the target state for a while.
-          timer->SetEventTimer("splash", 3.f);
-          timer->StartEventTimer("splash");
+          timer->SetEventTimer(kSplashEvent, 3.f);
+          timer->StartEventTimer(kSplashEvent);
         }
         postProcessor->SetIntensity(newIntensity);
         postProcessor->SetSampleOffsets(newSampleOffsets);
-      } else if (timer->HasEvent("splash") &&
-                 (timer->IsEventTimerExpired("splash") ||
+      } else if (timer->HasEvent(kSplashEvent) &&
+                 (timer->IsEventTimerExpired(kSplashEvent) ||
                   postProcessor->GetIntensity() == 1.f)) {
         postProcessor->SetChaos(false);
         postProcessor->SetSampleOffsets(0.f);
@@ -1551,21 +1877,17 @@ void GameManager::Update(float dt) {
         // Unload the logo texture
         ResourceManager::GetInstance().UnloadTexture("logo");
         // Stop splash screen sound.
-        if (soundEngine.IsPlaying("splash_end")) {
-          soundEngine.StopSound("splash_end");
-        }
-        if (soundEngine.IsPlaying("shock_wave")) {
-          soundEngine.StopSound("shock_wave");
-        }
-        if (soundEngine.IsPlaying("white_noise")) {
-          soundEngine.StopSound("white_noise");
-        }
+        soundEngine.StopSound("splash_end");
+        soundEngine.StopSound("shock_wave");
+        soundEngine.StopSound("white_noise");
+        timer->CleanEvent(kWhiteNoiseEvent);
+        timer->CleanEvent(kSplashEndEvent);
         // Remove the splash screen sound
         soundEngine.UnloadSound("splash_end");
         soundEngine.UnloadSound("shock_wave");
         soundEngine.UnloadSound("white_noise");
-      } else if (timer->HasEvent("splash") &&
-                 !timer->IsEventTimerExpired("splash")) {
+      } else if (timer->HasEvent(kSplashEvent) &&
+                 !timer->IsEventTimerExpired(kSplashEvent)) {
         originalSampleOffsets = targetSampleOffsets;
         targetSampleOffsets = 1.f / 10000.f;
         originalIntensity = targetIntensity;
@@ -1597,30 +1919,30 @@ void GameManager::Update(float dt) {
     return;
   } else if (this->state == GameState::INTRO) {
     // typing the introduction text
-    if (!timer->HasEvent("intro") && !timer->HasEvent("introFadeOut") &&
+    if (!timer->HasEvent(kIntroEvent) && !timer->HasEvent(kIntroFadeOutEvent) &&
         !texts.at("introduction")->UpdateTypingEffect(dt)) {
       // stay for 1 second
-      timer->SetEventTimer("intro", 4.f);
-      timer->StartEventTimer("intro");
-    } else if (timer->HasEvent("intro")) {
+      timer->SetEventTimer(kIntroEvent, 4.f);
+      timer->StartEventTimer(kIntroEvent);
+    } else if (timer->HasEvent(kIntroEvent)) {
       // Update the typing effect of the introduction text is necessary to flash
       // the cursor.
       bool isTyping = texts.at("introduction")->UpdateTypingEffect(dt);
       assert(!isTyping &&
              "The introduction text should already be fully typed.");
       // jump to the next state when the timer is expired
-      if (timer->IsEventTimerExpired("intro")) {
+      if (timer->IsEventTimerExpired(kIntroEvent)) {
         // Play sound of pressing key 'Enter'
         soundEngine.PlaySound("key_enter");
         // Disable the typing effect of the introduction text
         texts.at("introduction")->DisableTypingEffect();
         // Set up timer for the introduction text to fade out
-        timer->SetEventTimer("introFadeOut", 1.5f);
-        timer->StartEventTimer("introFadeOut");
-        timer->CleanEvent("intro");
+        timer->SetEventTimer(kIntroFadeOutEvent, 1.5f);
+        timer->StartEventTimer(kIntroFadeOutEvent);
+        timer->CleanEvent(kIntroEvent);
       }
-    } else if (timer->HasEvent("introFadeOut") &&
-               timer->IsEventTimerExpired("introFadeOut")) {
+    } else if (timer->HasEvent(kIntroFadeOutEvent) &&
+               timer->IsEventTimerExpired(kIntroFadeOutEvent)) {
       this->SetState(GameState::INITIAL);
       this->GoToState(GameState::STORY);
       // Unload the splash screen texture
@@ -1639,12 +1961,12 @@ void GameManager::Update(float dt) {
   if (this->scroll->GetState() == ScrollState::CLOSING) {
     this->scroll->Close(dt, this->scroll->GetTargetSilkLenForClosing());
     if (this->scroll->GetState() == ScrollState::CLOSED) {
-      this->timer->SetEventTimer("scrollReadyToOpen", 0.15f);
-      this->timer->StartEventTimer("scrollReadyToOpen");
+      this->timer->SetEventTimer(kScrollReadyToOpenEvent, 0.15f);
+      this->timer->StartEventTimer(kScrollReadyToOpenEvent);
     }
   } else if (this->scroll->GetState() == ScrollState::OPENING &&
-             (!this->timer->HasEvent("scrollReadyToOpen") ||
-              this->timer->IsEventTimerExpired("scrollReadyToOpen"))) {
+             (!this->timer->HasEvent(kScrollReadyToOpenEvent) ||
+              this->timer->IsEventTimerExpired(kScrollReadyToOpenEvent))) {
     if (this->lastState != GameState::PREPARING &&
         this->state == GameState::ACTIVE) {
       this->scroll->Open(dt, this->scroll->GetCurrentSilkLenForNarrowing());
@@ -1665,8 +1987,8 @@ void GameManager::Update(float dt) {
     if (this->scroll->GetState() == ScrollState::RETRACTED) {
       if (this->level <= this->GetNumGameLevels() &&
           gameCharacters["weiqing"]->GetHealth().GetCurrentHealth() > 0) {
-        this->timer->SetEventTimer("scrollInSleeve", 0.8f);
-        this->timer->StartEventTimer("scrollInSleeve");
+        this->timer->SetEventTimer(kScrollInSleeveEvent, 0.8f);
+        this->timer->StartEventTimer(kScrollInSleeveEvent);
         this->scroll->SetState(ScrollState::DEPLOYING);
       } else {
         assert(this->targetState == GameState::LOSE &&
@@ -1679,10 +2001,10 @@ void GameManager::Update(float dt) {
       }
     }
   } else if (this->scroll->GetState() == ScrollState::DEPLOYING) {
-    if (this->timer->HasEvent("scrollInSleeve")) {
-      if (this->timer->IsEventTimerExpired("scrollInSleeve")) {
+    if (this->timer->HasEvent(kScrollInSleeveEvent)) {
+      if (this->timer->IsEventTimerExpired(kScrollInSleeveEvent)) {
         this->scroll->SetAlpha(1.f);
-        this->timer->CleanEvent("scrollInSleeve");
+        this->timer->CleanEvent(kScrollInSleeveEvent);
         soundEngine.PlaySound("scroll_out_sleeve");
       }
     } else {
@@ -1691,8 +2013,8 @@ void GameManager::Update(float dt) {
   } else if (this->scroll->GetState() == ScrollState::ATTACKING) {
     this->scroll->Attack(dt);
     if (this->scroll->GetState() == ScrollState::ATTACKED) {
-      this->timer->SetEventTimer("scrollHitting", 0.1f);
-      this->timer->StartEventTimer("scrollHitting");
+      this->timer->SetEventTimer(kScrollHittingEvent, 0.1f);
+      this->timer->StartEventTimer(kScrollHittingEvent);
       this->scroll->SetState(ScrollState::RETURNING);
       gameCharacters["weiqing"]->SetTargetRoll(glm::pi<float>() / 6.f);
       gameCharacters["weiqing"]->ActivateStun();
@@ -1700,7 +2022,7 @@ void GameManager::Update(float dt) {
       gameCharacters["weiqing"]->GetHealth().DecreaseHealth(1);
     }
   } else if (this->scroll->GetState() == ScrollState::RETURNING) {
-    if (this->timer->IsEventTimerExpired("scrollHitting")) {
+    if (this->timer->IsEventTimerExpired(kScrollHittingEvent)) {
       this->scroll->Return(dt);
     }
     if (gameCharacters["weiqing"]->IsStunned()) {
@@ -1732,26 +2054,24 @@ void GameManager::Update(float dt) {
     }
   }
 
-  if (this->timer->HasEvent("scrollvibrate")) {
-    if (this->timer->IsEventTimerExpired("scrollvibrate")) {
-      this->timer->CleanEvent("scrollvibrate");
+  if (this->timer->HasEvent(kScrollVibrateEvent)) {
+    if (this->timer->IsEventTimerExpired(kScrollVibrateEvent)) {
+      this->timer->CleanEvent(kScrollVibrateEvent);
       this->gameArenaShaking = false;
     } else {
       this->gameArenaShaking = true;
     }
-  } else if (this->timer->HasEvent("hittingwall")) {
-    if (this->timer->IsEventTimerExpired("hittingwall")) {
+  } else if (this->timer->HasEvent(kHittingWallEvent)) {
+    if (this->timer->IsEventTimerExpired(kHittingWallEvent)) {
       this->gameArenaShaking = false;
     } else {
       // Scroll would shake when hit by stone plate.
       this->gameArenaShaking = true;
     }
   }
-  if (!this->gameArenaShaking && soundEngine.IsPlaying("scroll_vibrate")) {
-    float volume = soundEngine.GetVolume("scroll_vibrate");
-    if (volume == 1.f) {
-      soundEngine.GraduallyChangeVolume("scroll_vibrate", 0.f, 0.5f);
-    }
+  if (!this->gameArenaShaking && this->isScrollVibrateSoundOn) {
+    this->isScrollVibrateSoundOn = false;
+    soundEngine.GraduallyChangeVolume("scroll_vibrate", 0.f, 0.5f);
   }
 
   // Update arrows
@@ -1862,9 +2182,9 @@ void GameManager::Update(float dt) {
     float scoreAlpha = texts.at("score")->GetAlpha();
     glm::vec3 scoreColor = texts.at("score")->GetColor();
     if (scoreAlpha != kScoreAlpha || scoreColor != kScoreColorOrange) {
-      if (!this->timer->HasEvent("displayscore")) {
-        this->timer->SetEventTimer("displayscore", 1.f);
-        this->timer->StartEventTimer("displayscore");
+      if (!this->timer->HasEvent(kDisplayScoreEvent)) {
+        this->timer->SetEventTimer(kDisplayScoreEvent, 1.f);
+        this->timer->StartEventTimer(kDisplayScoreEvent);
       }
     }
   }
@@ -1891,10 +2211,9 @@ void GameManager::Update(float dt) {
       gameBoardPostition = gameBoard->GetValidPosition();
       gameBoardBoundaries = gameBoard->GetValidBoundaries();
 
-      // move all the static bubbles downwards by the offset.
-      for (auto& [id, bubble] : statics) {
-        bubble->SetPosition(bubble->GetPosition() + glm::vec2(0.f, offsetY));
-      }
+      // move all the static bubbles downwards by the offset, which only moves
+      // their origin.
+      board.TranslateStatics(glm::vec2(0.f, offsetY));
 
       // Check and adjust the postisions of the moving bubbles if they are
       // hitting with the top wall or with the bottom wall.
@@ -1912,7 +2231,7 @@ void GameManager::Update(float dt) {
 
       // Move the shooter upwards by the offset.
       shooter->SetPosition(shooter->GetPosition() - glm::vec2(0.f, offsetY));
-      shooter->GetRay().UpdatePath(gameBoardBoundaries, this->statics);
+      shooter->GetRay().MarkPathDirty();
 
       // Move the timer's text downwards by the offset.
       texts["time"]->SetPosition(texts["time"]->GetPosition() +
@@ -1924,11 +2243,11 @@ void GameManager::Update(float dt) {
         // Reset the scroll state to OPENED.
         this->scroll->SetState(ScrollState::OPENED);
         // Resume the timer.
-        this->timer->ResumeEventTimer("beforenarrowing");
+        this->timer->ResumeEventTimer(kBeforeNarrowingEvent);
         // Set the time to be displayed on the screen.
         texts["time"]->SetParagraph(
-            0, intToU32String(static_cast<int64_t>(
-                   std::ceil(this->timer->GetEventTimer("beforenarrowing")))));
+            0, intToU32String(static_cast<int64_t>(std::ceil(
+                   this->timer->GetEventTimer(kBeforeNarrowingEvent)))));
       }
     }
 
@@ -1939,13 +2258,15 @@ void GameManager::Update(float dt) {
       bool isPenetrating = false;
       if (auto* movingPowerUp = dynamic_cast<PowerUp*>(bubble.get())) {
         movingPowerUp->Update(dt);
-        isPenetrating = movingPowerUp->Move(dt, gameBoardBoundaries, statics);
+        isPenetrating =
+            movingPowerUp->Move(dt, gameBoardBoundaries, board.GetGrid());
         if (movingPowerUp->IsStonePlateHittingBoundary()) {
-          this->timer->SetEventTimer("hittingwall", 0.06f);
-          this->timer->StartEventTimer("hittingwall");
+          soundEngine.PlaySound("wall_collide");
+          this->timer->SetEventTimer(kHittingWallEvent, 0.06f);
+          this->timer->StartEventTimer(kHittingWallEvent);
         }
       } else {
-        isPenetrating = bubble->Move(dt, gameBoardBoundaries, statics);
+        isPenetrating = bubble->Move(dt, gameBoardBoundaries, board.GetGrid());
       }
       if (!isPenetrating) {
         continue;
@@ -1953,48 +2274,36 @@ void GameManager::Update(float dt) {
 
       int id = id_ref;
       if (auto* movingPowerUp = dynamic_cast<PowerUp*>(bubble.get())) {
-        for (auto& toBeDestroyedId : movingPowerUp->GetBubblesToBeDestroyed()) {
-          assert(statics.count(toBeDestroyedId) > 0 &&
-                 "Failed to find the bubble by ID.");
-          --colorCount[statics[toBeDestroyedId]->GetColorEnum()];
-          explodings[toBeDestroyedId] = std::move(statics[toBeDestroyedId]);
-          // Reset the weight of the exploding bubble's color to 1.
-          colorWeight.at(explodings[toBeDestroyedId]->GetColorEnum()) = 1.f;
-          statics.erase(toBeDestroyedId);
-        }
         if (!movingPowerUp->GetBubblesToBeDestroyed().empty()) {
-          // Find all the bubbles that are falling after the explosion. A bubble
-          // is falling if it is not connected to the top wall or the static
-          // bubbles.
-          std::vector<int> fallingIds = FindAllFallingBubbles();
-          // Remove the falling bubbles from the static bubbles and push them
-          // into falling.
+          // Explode the bubbles hit by the daggers. The bubbles that are no
+          // longer connected to the top wall through the static bubbles fall.
+          auto [explodingIds, fallingIds] =
+              board.Pop(movingPowerUp->GetBubblesToBeDestroyed(),
+                        gameBoard->GetValidPosition().y);
+          for (int explodingId : explodingIds) {
+            // Reset the weight of the exploding bubble's color to 1.
+            colorWeight[toIndex(bubbles.GetColor(explodingId))] = 1.f;
+            --colorCount[toIndex(bubbles.GetColor(explodingId))];
+          }
           for (int fallingId : fallingIds) {
             // Reset the weight of the falling bubble's color
-            colorWeight.at(statics[fallingId]->GetColorEnum()) = 1.f;
-            // the falling bubble should be in the statics.
-            assert(statics.count(fallingId) > 0 &&
-                   "Failed to find the bubble by ID.");
-            --colorCount[statics[fallingId]->GetColorEnum()];
-            fallings.emplace(fallingId, std::move(statics[fallingId]));
-            // Remove the falling bubble from the static bubbles.
-            statics[fallingId] = nullptr;
-            statics.erase(fallingId);
+            colorWeight[toIndex(bubbles.GetColor(fallingId))] = 1.f;
+            --colorCount[toIndex(bubbles.GetColor(fallingId))];
           }
           // Calculate the score based on the number of bubbles exploded or
           // falling
           int totalScoreIncrement = 0;
-          if (!explodings.empty()) {
+          if (!explodingIds.empty()) {
             totalScoreIncrement += this->CalculateScore(
-                explodings.size(), explodings.begin()->second->GetRadius(),
+                explodingIds.size(), bubbles.GetRadius(explodingIds.front()),
                 BubbleState::Exploding,
-                this->timer->GetEventUsedTime("playtime"));
+                this->timer->GetEventUsedTime(kPlayTimeEvent));
           }
-          if (!fallings.empty()) {
+          if (bubbles.Count(BubbleState::Falling) > 0) {
             totalScoreIncrement += this->CalculateScore(
-                fallings.size(), fallings.begin()->second->GetRadius(),
+                bubbles.Count(BubbleState::Falling), kBubbleRadius,
                 BubbleState::Falling,
-                this->timer->GetEventUsedTime("playtime"));
+                this->timer->GetEventUsedTime(kPlayTimeEvent));
           }
           if (totalScoreIncrement > 0) {
             // Retrieve the exploding bubble that is closest to the stoneplate.
@@ -2003,135 +2312,99 @@ void GameManager::Update(float dt) {
             // Create a score text to show the score increment.
             AddScoreIncrementText(
                 totalScoreIncrement,
-                explodings.at(closestExplodingBubbleID)->GetPosition());
+                bubbles.GetPosition(closestExplodingBubbleID));
           }
 
           // clear all the exploding bubbles.
           std::vector<ExplosionInfo> explosionInfo;
-          for (auto& [id, bubble] : explodings) {
-            explosionInfo.emplace_back(bubble->GetCenter(), bubble->GetColor(),
-                                       isDeepColor(bubble->GetColor()), 150,
-                                       bubble->GetRadius() * 0.6f);
+          for (int explodingId : explodingIds) {
+            explosionInfo.emplace_back(
+                bubbles.GetCenter(explodingId),
+                glm::vec4(toRgb(bubbles.GetColor(explodingId)), kBubbleAlpha),
+                isDeepColor(bubbles.GetColor(explodingId)), 150,
+                bubbles.GetRadius(explodingId) * 0.6f);
+            bubbles.Destroy(explodingId);
           }
           explosionSystem->CreateExplosions(explosionInfo);
           soundEngine.PlaySound("dagger_swipe", false);
-          explodings.clear();
           // Destroy the powerup when running out of daggers.
           if (movingPowerUp->GetNumOfDaggers() == 0) {
             moves[id] = nullptr;
             moves.erase(id);
           }
-          shooter->GetRay().UpdatePath(gameBoardBoundaries, this->statics);
+          shooter->GetRay().MarkPathDirty();
         }
       } else {
-        // We would like to adjust the postion of the bubble to make it have at
-        // least two static neighbors if possible.
-        std::vector<int> neighborIds = GetNeighborIds(bubble);
-
-        bool funeTuneDone = false;
-
-        // If the new bubble only has 1 neighbor, then we try to adjust the
-        // position of the bubble to make it have more neighbors.
-        if (neighborIds.size() == 1) {
-          // Fine tuning the position of the collidef moving bubbles to the best
-          // free slot.
-          int staticBubbleId = neighborIds[0];
-          funeTuneDone = FineTuneToNeighbor(id, staticBubbleId);
-          if (!funeTuneDone) {
-            funeTuneDone = FineTuneToClose(id, staticBubbleId);
-          }
-        } else if (neighborIds.size() == 0) {
-          // If the bubble has no neighbor, it must be at the top of the game
-          // board.
-          assert(IsAtUpperBoundary(bubble->GetPosition()) &&
-                 "The bubble should be at the top of the game board.");
-          // Fine tuning the position of the collidef moving bubbles to the best
-          // free slot at the upper boundary of the game board.
-          funeTuneDone = FineTuneToCloseUpper(id);
-        }
-
-        if (!funeTuneDone) {
-          FineTuneToCorrectPosition(id);
-        }
+        // Snap the bubble to the nearest free slot next to the static bubbles
+        // it stopped against or in the top row.
+        bubble->SetCenter(board.FindLandingSlot(
+            bubble->GetCenter(), gameBoard->GetValidBoundaries()));
 
         // Add the bubble to the static bubbles
-        statics[id] = std::move(bubble);
-        ++colorCount[statics[id]->GetColorEnum()];
+        int staticId = board.Attach(bubble->GetCenter(), bubble->GetRadius(),
+                                    bubble->GetColorEnum());
+        ++colorCount[toIndex(bubbles.GetColor(staticId))];
 
         // Remove the bubble from the moving bubbles
         moves[id] = nullptr;
         moves.erase(id);
-        shooter->GetRay().UpdatePath(gameBoardBoundaries, this->statics);
+        // From now on, the bubble is referred to by its id in the store.
+        id = staticId;
+        shooter->GetRay().MarkPathDirty();
         // Check if the bubble connect to a group of bubbles of the same color.
         // And if they together form a group of more than 2 bubbles, then we
         // remove them.
         std::vector<int> connectedBubbleIds =
-            FindConnectedBubblesOfSameColor(id);
+            board.FindConnectedBubblesOfSameColor(id);
         if (connectedBubbleIds.size() > 2) {
           // Reset the weight of the current bubble's color
-          colorWeight.at(statics[id]->GetColorEnum()) = 1.f;
-          // Remove the connected bubbles from the static bubbles and push them
-          // into explodings.
-          for (int connectedBubbleId : connectedBubbleIds) {
-            --colorCount[statics[connectedBubbleId]->GetColorEnum()];
-            explodings[connectedBubbleId] =
-                std::move(statics[connectedBubbleId]);
-            statics[connectedBubbleId] = nullptr;
-            statics.erase(connectedBubbleId);
-            shooter->GetRay().UpdatePath(gameBoardBoundaries, this->statics);
+          colorWeight[toIndex(bubbles.GetColor(id))] = 1.f;
+          // Turn the connected bubbles from static bubbles into exploding
+          // bubbles. The bubbles that are no longer connected to the top wall
+          // through the static bubbles fall.
+          auto [explodingIds, fallingIds] =
+              board.Pop(connectedBubbleIds, gameBoard->GetValidPosition().y);
+          for (int explodingId : explodingIds) {
+            --colorCount[toIndex(bubbles.GetColor(explodingId))];
           }
-
-          // Find all the bubbles that are falling after the explosion. A bubble
-          // is falling if it is not connected to the top wall or the static
-          // bubbles.
-          std::vector<int> fallingIds = FindAllFallingBubbles();
-
-          // Remove the falling bubbles from the static bubbles and push them
-          // into falling.
           for (int fallingId : fallingIds) {
             // Reset the weight of the falling bubble's color
-            colorWeight.at(statics[fallingId]->GetColorEnum()) = 1.f;
-            // the falling bubble should be in the statics.
-            assert(statics.count(fallingId) > 0 &&
-                   "Failed to find the bubble by ID.");
-            --colorCount[statics[fallingId]->GetColorEnum()];
-            fallings.emplace(fallingId, std::move(statics[fallingId]));
-            // Remove the falling bubble from the static bubbles.
-            statics[fallingId] = nullptr;
-            statics.erase(fallingId);
-            shooter->GetRay().UpdatePath(gameBoardBoundaries, this->statics);
+            colorWeight[toIndex(bubbles.GetColor(fallingId))] = 1.f;
+            --colorCount[toIndex(bubbles.GetColor(fallingId))];
           }
 
           // Calculate the score based on the number of bubbles exploded or
           // falling
           int totalScoreIncrement = 0;
-          if (!explodings.empty()) {
+          if (!explodingIds.empty()) {
             totalScoreIncrement += this->CalculateScore(
-                explodings.size(), explodings.begin()->second->GetRadius(),
+                explodingIds.size(), bubbles.GetRadius(explodingIds.front()),
                 BubbleState::Exploding,
-                this->timer->GetEventUsedTime("playtime"));
+                this->timer->GetEventUsedTime(kPlayTimeEvent));
           }
-          if (!fallings.empty()) {
+          if (bubbles.Count(BubbleState::Falling) > 0) {
             totalScoreIncrement += this->CalculateScore(
-                fallings.size(), fallings.begin()->second->GetRadius(),
+                bubbles.Count(BubbleState::Falling), kBubbleRadius,
                 BubbleState::Falling,
-                this->timer->GetEventUsedTime("playtime"));
+                this->timer->GetEventUsedTime(kPlayTimeEvent));
           }
           if (totalScoreIncrement > 0) {
             // Create a score text to show the score increment.
             AddScoreIncrementText(totalScoreIncrement,
-                                  explodings.begin()->second->GetPosition());
+                                  bubbles.GetPosition(explodingIds.front()));
           }
 
           // clear all the exploding bubbles.
           std::vector<ExplosionInfo> explosionInfo;
-          for (auto& [id, bubble] : explodings) {
-            explosionInfo.emplace_back(bubble->GetCenter(), bubble->GetColor(),
-                                       isDeepColor(bubble->GetColor()), 150,
-                                       bubble->GetRadius() * 0.6f);
+          for (int explodingId : explodingIds) {
+            explosionInfo.emplace_back(
+                bubbles.GetCenter(explodingId),
+                glm::vec4(toRgb(bubbles.GetColor(explodingId)), kBubbleAlpha),
+                isDeepColor(bubbles.GetColor(explodingId)), 150,
+                bubbles.GetRadius(explodingId) * 0.6f);
+            bubbles.Destroy(explodingId);
           }
           explosionSystem->CreateExplosions(explosionInfo);
-          explodings.clear();
           // Insert dagger into the stone plate.
           powerUp->InsertDagger();
           if (this->powerUp->GetNumOfDaggers() == 1) {
@@ -2142,37 +2415,37 @@ void GameManager::Update(float dt) {
         } else if (connectedBubbleIds.size() == 2) {
           // Triple the weight of the current bubble's color when the number of
           // static bubbles are greater than 3.
-          if (statics.size() > 3) {
-            colorWeight.at(statics[id]->GetColorEnum()) *= 3.f;
+          if (bubbles.Count(BubbleState::Static) > 3) {
+            colorWeight[toIndex(bubbles.GetColor(id))] *= 3.f;
             // Further triple the weight of the current bubble's color if the
             // distance to the shooter's center is within the ellipse.
             Ellipse ellipse(shooter->GetCenter(), 6.f * kBaseUnit,
                             10.f * kBaseUnit);
-            if (ellipse.isWithin(statics[id]->GetCenter())) {
-              colorWeight.at(statics[id]->GetColorEnum()) *= 3.f;
+            if (ellipse.isWithin(bubbles.GetCenter(id))) {
+              colorWeight[toIndex(bubbles.GetColor(id))] *= 3.f;
             }
           } else {
-            colorWeight.at(statics[id]->GetColorEnum()) = 1.f;
+            colorWeight[toIndex(bubbles.GetColor(id))] = 1.f;
           }
           // If the color of the two connected bubbles are not the same, then we
           // reset the power up.
-          if (!isSameColor(
-                  statics[connectedBubbleIds[0]]->GetColorWithoutAlpha(),
-                  statics[connectedBubbleIds[1]]->GetColorWithoutAlpha())) {
+          if (bubbles.GetColor(connectedBubbleIds[0]) !=
+              bubbles.GetColor(connectedBubbleIds[1])) {
             powerUp->Reset();
           }
 
         } else if (connectedBubbleIds.size() < 2) {
           // Halve the weight of the current bubble's color
-          colorWeight.at(statics[id]->GetColorEnum()) /= 3.f;
+          colorWeight[toIndex(bubbles.GetColor(id))] /= 3.f;
           // Reset the power up.
           powerUp->Reset();
         }
       }
       // If all statuc bubbles are removed, we set the GameState to PREPAREING
       // and switch to the next level.
-      if (statics.empty() && this->isLevelFailed == false) {
-        for (const auto& [color, weight] : colorWeight) {
+      if (bubbles.Count(BubbleState::Static) == 0 &&
+          this->isLevelFailed == false) {
+        for (float weight : colorWeight) {
           assert(weight == 1.f &&
                  "The weight of each color should be 1.f when succeeding the "
                  "current level.");
@@ -2190,13 +2463,13 @@ void GameManager::Update(float dt) {
                           gameCharacters["guojie"]->GetSize().y * 0.53f);
 
         // Ready to fire an arrow.
-        this->timer->SetEventTimer("firearrow", 0.1f);
-        this->timer->StartEventTimer("firearrow");
+        this->timer->SetEventTimer(kFireArrowEvent, 0.1f);
+        this->timer->StartEventTimer(kFireArrowEvent);
 
         this->GoToState(GameState::PREPARING);
         numOfScoreIncrementsReady = scoreIncrements.size();
-        this->timer->SetEventTimer("refreshscore", 0.05f);
-        this->timer->StartEventTimer("refreshscore");
+        this->timer->SetEventTimer(kRefreshScoreEvent, 0.05f);
+        this->timer->StartEventTimer(kRefreshScoreEvent);
         // If it is on the final level, then we double the score increment if
         // the player has two lives left, or triple the score increment if the
         // player has three lives left.
@@ -2229,6 +2502,10 @@ void GameManager::Update(float dt) {
       }
     }
 
+    // Recompute the path of the ray once for this tick if the shooter or the
+    // static bubbles have changed.
+    shooter->GetRay().UpdatePath(gameBoardBoundaries, board.GetGrid());
+
     // Check if the current level is failed.
     if (!this->isLevelFailed && this->IsLevelFailed()) {
       // If the current level is failed, then we restart the current level.
@@ -2236,49 +2513,52 @@ void GameManager::Update(float dt) {
       this->scroll->SetState(ScrollState::CLOSING);
       if (!scoreIncrements.empty()) {
         numOfScoreIncrementsReady = scoreIncrements.size();
-        this->timer->SetEventTimer("refreshscore", 0.05f);
-        this->timer->StartEventTimer("refreshscore");
+        this->timer->SetEventTimer(kRefreshScoreEvent, 0.05f);
+        this->timer->StartEventTimer(kRefreshScoreEvent);
       }
     }
 
     if (this->scroll->GetState() == ScrollState::OPENED) {
-      if (this->timer->IsPaused("playtime")) {
-        this->timer->ResumeEventTimer("playtime");
+      if (this->timer->IsPaused(kPlayTimeEvent)) {
+        this->timer->ResumeEventTimer(kPlayTimeEvent);
       }
       // check if the event timer for narrowing the scroll is triggered.
-      if (this->timer->IsPaused("beforenarrowing")) {
-        this->timer->ResumeEventTimer("beforenarrowing");
+      if (this->timer->IsPaused(kBeforeNarrowingEvent)) {
+        this->timer->ResumeEventTimer(kBeforeNarrowingEvent);
       }
-      if (this->timer->IsEventTimerExpired("beforenarrowing")) {
+      if (this->timer->IsEventTimerExpired(kBeforeNarrowingEvent)) {
         // Stop the shake effect
         this->gameArenaShaking = false;
-        soundEngine.GraduallyChangeVolume("scroll_vibrate", 0.f, 0.5f);
+        if (this->isScrollVibrateSoundOn) {
+          this->isScrollVibrateSoundOn = false;
+          soundEngine.GraduallyChangeVolume("scroll_vibrate", 0.f, 0.5f);
+        }
         // Narrow the scroll
         this->scroll->SetState(ScrollState::NARROWING);
-        this->scroll->SetTargetSilkLenForNarrowing(gameBoardSize.y -
-                                                   2 * kBubbleRadius);
+        this->scroll->SetTargetSilkLenForNarrowing(
+            gameBoardSize.y - 2 * getNarrowingStep(kBubbleRadius));
         // Restart the event timer for narrowing the scroll.
-        this->timer->StartEventTimer("beforenarrowing");
+        this->timer->StartEventTimer(kBeforeNarrowingEvent);
         // Pause the event timer for narrowing the scroll.
-        this->timer->PauseEventTimer("beforenarrowing");
+        this->timer->PauseEventTimer(kBeforeNarrowingEvent);
       } else {
         // Update the time to be displayed on the screen.
         texts["time"]->SetParagraph(
-            0, intToU32String(static_cast<int64_t>(std::ceil(
-                   this->timer->GetEventRemainingTime("beforenarrowing")))));
+            0,
+            intToU32String(static_cast<int64_t>(std::ceil(
+                this->timer->GetEventRemainingTime(kBeforeNarrowingEvent)))));
         // Shaking the whole scroll if the time is less than 1.5s.
         float remainingTimeForNarrowing =
-            this->timer->GetEventRemainingTime("beforenarrowing");
+            this->timer->GetEventRemainingTime(kBeforeNarrowingEvent);
         if (!this->gameArenaShaking && remainingTimeForNarrowing < 1.5f) {
           this->gameArenaShaking = true;
-          this->timer->SetEventTimer("scrollvibrate",
+          this->timer->SetEventTimer(kScrollVibrateEvent,
                                      remainingTimeForNarrowing);
-          this->timer->StartEventTimer("scrollvibrate");
+          this->timer->StartEventTimer(kScrollVibrateEvent);
           // Stop play the vibrate sound if it is playing.
-          if (soundEngine.IsPlaying("scroll_vibrate")) {
-            soundEngine.StopSound("scroll_vibrate");
-          }
+          soundEngine.StopSound("scroll_vibrate");
           soundEngine.PlaySound("scroll_vibrate");
+          this->isScrollVibrateSoundOn = true;
         }
       }
     }
@@ -2297,10 +2577,9 @@ void GameManager::Update(float dt) {
 
     // Update the next bubble color of the shooter if the color does not exist
     // within the statics.
-    if (!statics.empty()) {
-      auto colorEnum = this->shooter->GetNextBubble().GetColorEnum();
-      if (colorCount.find(colorEnum) == colorCount.end() ||
-          colorCount.at(colorEnum) == 0) {
+    if (bubbles.Count(BubbleState::Static) > 0) {
+      Color colorEnum = this->shooter->GetNextBubble().GetColorEnum();
+      if (colorCount[toIndex(colorEnum)] == 0) {
         this->shooter->RefreshNextBubbleColor(GetNextBubbleColor());
       }
     }
@@ -2313,17 +2592,15 @@ void GameManager::Update(float dt) {
       moves.clear();
       // If the static bubbles are empty, then retract the scroll, else the
       // scroll would be attacking the player.
-      if (statics.empty() && !isLevelFailed) {
+      if (bubbles.Count(BubbleState::Static) == 0 && !isLevelFailed) {
         this->scroll->SetState(ScrollState::RETRACTING);
       } else {
         this->scroll->SetState(ScrollState::ATTACKING);
       }
-      statics.clear();
-      colorCount.clear();
+      board.ClearStatics();
+      colorCount.fill(0);
       // Reset the color weight of all colors to be 1.
-      for (auto it = colorMap.begin(); it != colorMap.end(); ++it) {
-        colorWeight[it->first] = 1.f;
-      }
+      colorWeight.fill(1.f);
     } else if (this->scroll->GetState() == ScrollState::DEPLOYED ||
                this->scroll->GetState() == ScrollState::RETURNED) {
       if (this->targetState != GameState::LOSE) {
@@ -2332,42 +2609,49 @@ void GameManager::Update(float dt) {
         this->scroll->SetState(ScrollState::RETRACTING);
       }
     }
-    if (statics.empty()) {
-      // Generate random static bubbles
-      GenerateRandomStaticBubbles();
-      // Reset the level failed flag.
-      this->isLevelFailed = false;
-      // refresh the color of the carried bubble and the next bubble based the
-      // existing colors of all static bubbles.
-      if (!shooter->HasPowerUp()) {
-        shooter->RefreshCarriedBubbleColor(GetNextBubbleColor());
+    if (bubbles.Count(BubbleState::Static) == 0) {
+      // Place the static bubbles once the layout of the level is generated.
+      if (IsLevelLayoutReady()) {
+        GenerateRandomStaticBubbles();
+        // Reset the level failed flag.
+        this->isLevelFailed = false;
+        // refresh the color of the carried bubble and the next bubble based the
+        // existing colors of all static bubbles.
+        if (!shooter->HasPowerUp()) {
+          shooter->RefreshCarriedBubbleColor(GetNextBubbleColor());
+        }
+        shooter->RefreshNextBubbleColor(GetNextBubbleColor());
+
+        // Get half total offset of the scroll narrowing
+        glm::vec2 halfOffset =
+            gameBoard->GetValidPosition() - gameBoard->GetPosition();
+
+        // Set the valid boundaries of the game board.
+        gameBoard->SetValidPosition(gameBoard->GetPosition());
+        gameBoard->SetValidSize(gameBoard->GetSize());
+        // reset the time text position
+        texts["time"]->SetPosition(texts["time"]->GetPosition() - halfOffset);
+        /*texts["time"]->SetCenter(texts["time"]->GetCenter() - halfOffset);*/
+        // reset the position of the shooter
+        shooter->SetPosition(shooter->GetPosition() + halfOffset);
+        shooter->GetRay().MarkPathDirty();
+        shooter->GetRay().UpdatePath(this->gameBoard->GetBoundaries(),
+                                     board.GetGrid());
       }
-      shooter->RefreshNextBubbleColor(GetNextBubbleColor());
-
-      // Get half total offset of the scroll narrowing
-      glm::vec2 halfOffset =
-          gameBoard->GetValidPosition() - gameBoard->GetPosition();
-
-      // Set the valid boundaries of the game board.
-      gameBoard->SetValidPosition(gameBoard->GetPosition());
-      gameBoard->SetValidSize(gameBoard->GetSize());
-      // reset the time text position
-      texts["time"]->SetPosition(texts["time"]->GetPosition() - halfOffset);
-      /*texts["time"]->SetCenter(texts["time"]->GetCenter() - halfOffset);*/
-      // reset the position of the shooter
-      shooter->SetPosition(shooter->GetPosition() + halfOffset);
-      shooter->GetRay().UpdatePath(this->gameBoard->GetBoundaries(),
-                                   this->statics);
     } else {
       if (scroll->GetState() == ScrollState::OPENED) {
         this->SetState(GameState::ACTIVE);
         this->targetState = GameState::UNDEFINED;
         float duration = GetNarrowingTimeInterval();
-        this->timer->SetEventTimer("beforenarrowing", duration);
-        this->timer->StartEventTimer("beforenarrowing");
+        this->timer->SetEventTimer(kBeforeNarrowingEvent, duration);
+        this->timer->StartEventTimer(kBeforeNarrowingEvent);
         // start counting the time
-        this->timer->SetEventTimer("playtime", 1000.f);
-        this->timer->StartEventTimer("playtime");
+        this->timer->SetEventTimer(kPlayTimeEvent, 1000.f);
+        this->timer->StartEventTimer(kPlayTimeEvent);
+        // Generate the next level in the background while this one is played.
+        if (this->level < this->GetNumGameLevels()) {
+          StartGeneratingLevelLayout(this->level + 1);
+        }
       }
     }
   } else if (this->state == GameState::WIN || this->state == GameState::LOSE) {
@@ -2375,7 +2659,8 @@ void GameManager::Update(float dt) {
     //     this->scroll->SetState(ScrollState::RETRACTING);
     // }
     const float targetFontScale = 0.2f / kFontScale;
-    std::string topic = this->state == GameState::WIN ? "victory" : "defeated";
+    StringId topic = this->state == GameState::WIN ? StringId("victory")
+                                                   : StringId("defeated");
     if (texts[topic]->GetScale() > targetFontScale) {
       /* 0.25 * kFontScale * dt;*/
       float newScale = texts[topic]->GetScale() - 1.f / kFontScale * dt;
@@ -2394,40 +2679,40 @@ void GameManager::Update(float dt) {
       if (this->state == GameState::LOSE) {
         postProcessor->SetGrayscale(true);
       }
-      if (!this->timer->HasEvent("prompttomainmenu")) {
+      if (!this->timer->HasEvent(kPromptToMainMenuEvent)) {
         // Make the whole screen blur immediately.
-        this->timer->SetEventTimer("prompttomainmenu", 1.5f);
-        this->timer->SetEventTimer("hideprompttomainmenu", 0.5f);
-        this->timer->SetEventTimer("beforegraduallyclear", 3.5f);
-        this->timer->StartEventTimer("prompttomainmenu");
-        this->timer->StartEventTimer("hideprompttomainmenu");
-        this->timer->PauseEventTimer("hideprompttomainmenu");
-        this->timer->StartEventTimer("beforegraduallyclear");
+        this->timer->SetEventTimer(kPromptToMainMenuEvent, 1.5f);
+        this->timer->SetEventTimer(kHidePromptToMainMenuEvent, 0.5f);
+        this->timer->SetEventTimer(kBeforeGraduallyClearEvent, 3.5f);
+        this->timer->StartEventTimer(kPromptToMainMenuEvent);
+        this->timer->StartEventTimer(kHidePromptToMainMenuEvent);
+        this->timer->PauseEventTimer(kHidePromptToMainMenuEvent);
+        this->timer->StartEventTimer(kBeforeGraduallyClearEvent);
         postProcessor->SetSampleOffsets(1.f / 240);
-      } else if (this->timer->HasEvent("beforegraduallyclear") &&
-                 this->timer->IsEventTimerExpired("beforegraduallyclear")) {
+      } else if (this->timer->HasEvent(kBeforeGraduallyClearEvent) &&
+                 this->timer->IsEventTimerExpired(kBeforeGraduallyClearEvent)) {
         // Make the whole screen clear gradually.
         float newSampleOffsets =
             postProcessor->GetSampleOffsets() - 0.00085f * dt;
         if (newSampleOffsets <= 0.f) {
           newSampleOffsets = 0.f;
-          this->timer->CleanEvent("beforegraduallyclear");
+          this->timer->CleanEvent(kBeforeGraduallyClearEvent);
         }
         postProcessor->SetSampleOffsets(newSampleOffsets);
       }
-      if (this->timer->HasEvent("prompttomainmenu") &&
-          !this->timer->IsPaused("prompttomainmenu")) {
-        if (this->timer->IsEventTimerExpired("prompttomainmenu")) {
-          this->timer->StartEventTimer("prompttomainmenu");
-          this->timer->PauseEventTimer("prompttomainmenu");
-          this->timer->StartEventTimer("hideprompttomainmenu");
+      if (this->timer->HasEvent(kPromptToMainMenuEvent) &&
+          !this->timer->IsPaused(kPromptToMainMenuEvent)) {
+        if (this->timer->IsEventTimerExpired(kPromptToMainMenuEvent)) {
+          this->timer->StartEventTimer(kPromptToMainMenuEvent);
+          this->timer->PauseEventTimer(kPromptToMainMenuEvent);
+          this->timer->StartEventTimer(kHidePromptToMainMenuEvent);
         }
-      } else if (this->timer->HasEvent("hideprompttomainmenu") &&
-                 !this->timer->IsPaused("hideprompttomainmenu")) {
-        if (this->timer->IsEventTimerExpired("hideprompttomainmenu")) {
-          this->timer->StartEventTimer("hideprompttomainmenu");
-          this->timer->PauseEventTimer("hideprompttomainmenu");
-          this->timer->StartEventTimer("prompttomainmenu");
+      } else if (this->timer->HasEvent(kHidePromptToMainMenuEvent) &&
+                 !this->timer->IsPaused(kHidePromptToMainMenuEvent)) {
+        if (this->timer->IsEventTimerExpired(kHidePromptToMainMenuEvent)) {
+          this->timer->StartEventTimer(kHidePromptToMainMenuEvent);
+          this->timer->PauseEventTimer(kHidePromptToMainMenuEvent);
+          this->timer->StartEventTimer(kPromptToMainMenuEvent);
         }
       }
       // Increase the opacity of the score gradually.
@@ -2605,11 +2890,11 @@ void GameManager::Update(float dt) {
         postProcessor->SetBlur(true);
         postProcessor->SetSampleOffsets(0.0005f);
         // Set time for shaking the screen.
-        this->timer->SetEventTimer("guojieshaking", 0.95f);
-        this->timer->StartEventTimer("guojieshaking");
+        this->timer->SetEventTimer(kGuojieShakingEvent, 0.95f);
+        this->timer->StartEventTimer(kGuojieShakingEvent);
         // Set the time for cracks on the ground.
-        this->timer->SetEventTimer("cracks", 1.5f);
-        this->timer->StartEventTimer("cracks");
+        this->timer->SetEventTimer(kCracksEvent, 1.5f);
+        this->timer->StartEventTimer(kCracksEvent);
         // Play the sound of guojie landing on the ground.
         soundEngine.PlaySound("wood_collide", false);
         soundEngine.PlaySound("earthquake", false);
@@ -2619,8 +2904,8 @@ void GameManager::Update(float dt) {
 
   // Set the state of the game characters after guojie arrives at the target
   // position.
-  if (this->timer->HasEvent("guojieshaking") &&
-      this->timer->GetEventUsedTime("guojieshaking") > 0.085f &&
+  if (this->timer->HasEvent(kGuojieShakingEvent) &&
+      this->timer->GetEventUsedTime(kGuojieShakingEvent) > 0.085f &&
       gameCharacters["weiqing"]->GetState() != GameCharacterState::FIGHTING) {
     gameCharacters["liuche"]->SetState(GameCharacterState::SAD);
     gameCharacters["weizifu"]->SetState(GameCharacterState::SAD);
@@ -2633,44 +2918,25 @@ void GameManager::Update(float dt) {
   }
 
   // Check if the event timer for shaking the screen has expired.
-  if (this->timer->HasEvent("guojieshaking") &&
-      this->timer->IsEventTimerExpired("guojieshaking")) {
+  if (this->timer->HasEvent(kGuojieShakingEvent) &&
+      this->timer->IsEventTimerExpired(kGuojieShakingEvent)) {
     postProcessor->SetShake(false);
     postProcessor->SetBlur(false);
-    if (soundEngine.GetVolume("earthquake") == 1.f) {
-      /*this->timer->CleanEvent("guojieshaking");*/
-      SoundEngine& soundEngine = SoundEngine::GetInstance();
-      if (soundEngine.IsPlaying("wood_collide")) {
-        soundEngine.StopSound("wood_collide");
-      }
-      if (soundEngine.IsPlaying("earthquake")) {
-        soundEngine.GraduallyChangeVolume("earthquake", 0.f, 0.8f);
-      }
-    }
-    this->timer->CleanEvent("guojieshaking");
+    // The landing sounds end with the shaking, whether or not they are still
+    // playing.
+    soundEngine.StopSound("wood_collide");
+    soundEngine.GraduallyChangeVolume("earthquake", 0.f, 0.8f);
+    this->timer->CleanEvent(kGuojieShakingEvent);
   }
 
   // Update all the particles
   shadowTrailSystem->Update(dt);
   explosionSystem->Update(dt);
 
-  // Update all the falling bubbles
-  std::vector<int> toRemove;
-  for (auto& [id, bubble] : fallings) {
-    // update the position of the falling bubble
-    bubble->Move(dt);
-    // Apply gravity to the falling bubble
-    bubble->ApplyGravity(dt);
-    // If the falling bubble pass the bottom of the game board, then we remove
-    // it from the falling bubbles.
-    if (bubble->GetPosition().y >
-        gameBoard->GetPosition().y + gameBoard->GetSize().y) {
-      toRemove.emplace_back(id);
-    }
-  }
-  for (const int id : toRemove) {
-    fallings.erase(id);
-  }
+  // Update all the falling bubbles by moving them and applying gravity. They
+  // are removed once they pass the bottom of the game board.
+  board.UpdateFalling(dt, glm::vec2(0.0f, 9.8f * kVelocityUnit),
+                      gameBoard->GetPosition().y + gameBoard->GetSize().y);
 
   if (!graduallyTransparentObjects.empty()) {
     // gruadully make the old-state characters invisible.
@@ -2724,13 +2990,13 @@ void GameManager::Update(float dt) {
   }
 
   // Gradually fading out the blur if the event "deblurring" exists.
-  if (this->timer->HasEvent("deblurring")) {
+  if (this->timer->HasEvent(kDeblurringEvent)) {
     float targetSampleOffsets = 0.f;
     if (postProcessor->GetSampleOffsets() > targetSampleOffsets) {
       float newSampleOffsets = postProcessor->GetSampleOffsets() - 0.002f * dt;
       if (newSampleOffsets < targetSampleOffsets) {
         newSampleOffsets = targetSampleOffsets;
-        this->timer->CleanEvent("deblurring");
+        this->timer->CleanEvent(kDeblurringEvent);
         postProcessor->SetBlur(false);
       }
       postProcessor->SetSampleOffsets(newSampleOffsets);
@@ -2738,8 +3004,8 @@ void GameManager::Update(float dt) {
   }
 
   // Refreshing the score
-  if (this->timer->HasEvent("refreshscore") &&
-      this->timer->IsEventTimerExpired("refreshscore")) {
+  if (this->timer->HasEvent(kRefreshScoreEvent) &&
+      this->timer->IsEventTimerExpired(kRefreshScoreEvent)) {
     assert(!this->scoreIncrements.empty() && numOfScoreIncrementsReady > 0 &&
            "The score increments should not be empty.");
     int increment = this->scoreIncrements.front();
@@ -2750,8 +3016,8 @@ void GameManager::Update(float dt) {
     }
     this->IncreaseScore(increment);
     if (numOfScoreIncrementsReady > 0) {
-      this->timer->SetEventTimer("refreshscore", 0.05f);
-      this->timer->StartEventTimer("refreshscore");
+      this->timer->SetEventTimer(kRefreshScoreEvent, 0.05f);
+      this->timer->StartEventTimer(kRefreshScoreEvent);
       // Increase the opacity of the score text.
       float alpha = this->texts.at("score")->GetAlpha();
       if (alpha < 1.f) {
@@ -2778,31 +3044,31 @@ void GameManager::Update(float dt) {
         }
         this->texts.at("score")->SetColor(color);
       }
-      if (!this->timer->HasEvent("reduceflipvolume")) {
-        this->timer->SetEventTimer("reduceflipvolume",
+      if (!this->timer->HasEvent(kReduceFlipVolumeEvent)) {
+        this->timer->SetEventTimer(kReduceFlipVolumeEvent,
                                    1.5f + 0.01f * numOfScoreIncrementsReady);
-        this->timer->StartEventTimer("reduceflipvolume");
+        this->timer->StartEventTimer(kReduceFlipVolumeEvent);
       }
 
       float volume = 0.f;
-      if (this->timer->HasEvent("reduceflipvolume") &&
-          !this->timer->IsEventTimerExpired("reduceflipvolume")) {
-        volume =
-            glm::mix(0.f, 1.f,
-                     this->timer->GetEventRemainingTime("reduceflipvolume") /
-                         this->timer->GetEventTimer("reduceflipvolume"));
+      if (this->timer->HasEvent(kReduceFlipVolumeEvent) &&
+          !this->timer->IsEventTimerExpired(kReduceFlipVolumeEvent)) {
+        volume = glm::mix(
+            0.f, 1.f,
+            this->timer->GetEventRemainingTime(kReduceFlipVolumeEvent) /
+                this->timer->GetEventTimer(kReduceFlipVolumeEvent));
       }
       if (volume > 0.f) {
         soundEngine.PlaySound("flip_paper", false, volume);
       }
     } else {
-      this->timer->CleanEvent("refreshscore");
-      this->timer->CleanEvent("reduceflipvolume");
-      this->timer->SetEventTimer("displayscore", 1.5f);
-      this->timer->StartEventTimer("displayscore");
+      this->timer->CleanEvent(kRefreshScoreEvent);
+      this->timer->CleanEvent(kReduceFlipVolumeEvent);
+      this->timer->SetEventTimer(kDisplayScoreEvent, 1.5f);
+      this->timer->StartEventTimer(kDisplayScoreEvent);
     }
-  } else if (this->timer->HasEvent("displayscore") &&
-             this->timer->IsEventTimerExpired("displayscore")) {
+  } else if (this->timer->HasEvent(kDisplayScoreEvent) &&
+             this->timer->IsEventTimerExpired(kDisplayScoreEvent)) {
     // Decrease the opacity of the score text if it is not gamestate::WIN or
     // LOSE.
     bool alphaChangeComplete = true;
@@ -2841,7 +3107,7 @@ void GameManager::Update(float dt) {
       }
     }
     if (alphaChangeComplete && colorChangeComplete) {
-      this->timer->CleanEvent("displayscore");
+      this->timer->CleanEvent(kDisplayScoreEvent);
     }
   }
 
@@ -2868,7 +3134,7 @@ void GameManager::Update(float dt) {
   }
 }
 
-void GameManager::Render() {
+void GameManager::Render(float alpha) {
   if (this->state == GameState::EXIT) {
     return;
   } else if (this->state == GameState::PRELOAD &&
@@ -2892,7 +3158,7 @@ void GameManager::Render() {
     /*   float targetIntensity = 0.6f;*/
     float targetSampleOffsets = 1.f / 1000.f;
     float redChannelMin = 0.f, greenChannelMin = 0.f, blueChannelMin = 0.f;
-    if (!timer->HasEvent("splash") &&
+    if (!timer->HasEvent(kSplashEvent) &&
         this->postProcessor->GetSampleOffsets() <= targetSampleOffsets) {
       const float interpolationFactor =
           this->postProcessor->GetSampleOffsets() / targetSampleOffsets;
@@ -2920,9 +3186,9 @@ void GameManager::Render() {
     texts.at("introduction")
         ->Draw(textRenderers.at(language), /*centered=*/true);
     // Draw a Black Overlay used for text fading
-    if (timer->HasEvent("introFadeOut")) {
-      float totalTime = timer->GetEventTimer("introFadeOut");
-      float remainingTime = timer->GetEventRemainingTime("introFadeOut");
+    if (timer->HasEvent(kIntroFadeOutEvent)) {
+      float totalTime = timer->GetEventTimer(kIntroFadeOutEvent);
+      float remainingTime = timer->GetEventRemainingTime(kIntroFadeOutEvent);
       float newAlpha = 1.0f - remainingTime / totalTime;
       colorRenderer->DrawColor(
           glm::vec2(0, 0), glm::vec2(this->width, this->height), 0.0f,
@@ -2947,8 +3213,8 @@ void GameManager::Render() {
   if (this->state == GameState::ACTIVE || this->state == GameState::PREPARING ||
       this->state == GameState::WIN || this->state == GameState::LOSE) {
     // Create cracks on the ground when guojie lands on the target position.
-    if (this->timer->HasEvent("cracks") ||
-        this->timer->HasEvent("cracksFading")) {
+    if (this->timer->HasEvent(kCracksEvent) ||
+        this->timer->HasEvent(kCracksFadingEvent)) {
       glm::vec2 cracksPosition =
           gameCharacters["guojie"]->GetPosition() +
           glm::vec2(gameCharacters["guojie"]->GetSize().x * 0.0f,
@@ -2960,10 +3226,10 @@ void GameManager::Render() {
       // Set the alpha channel range based on the remaining time of the event
       // timer.
       glm::vec2 alphaChannelRange = glm::vec2(0.0f, 1.0f);
-      if (this->timer->HasEvent("cracksFading")) {
-        alphaChannelRange =
-            glm::vec2(0.0f, this->timer->GetEventRemainingTime("cracksFading") /
-                                this->timer->GetEventTimer("cracksFading"));
+      if (this->timer->HasEvent(kCracksFadingEvent)) {
+        alphaChannelRange = glm::vec2(
+            0.0f, this->timer->GetEventRemainingTime(kCracksFadingEvent) /
+                      this->timer->GetEventTimer(kCracksFadingEvent));
       }
       partialTextureRenderer->DrawPartialTexture(
           resourceManager.GetTexture("cracks"),
@@ -2973,14 +3239,14 @@ void GameManager::Render() {
           /*greenChannelRange=*/glm::vec2(0.f, 0.07843f),
           /*blueChannelRange=*/glm::vec2(0.f, 0.03922f),
           /*alphaChannelRange=*/alphaChannelRange);
-      if (this->timer->HasEvent("cracks") &&
-          this->timer->IsEventTimerExpired("cracks")) {
-        this->timer->CleanEvent("cracks");
-        this->timer->SetEventTimer("cracksFading", 2.f);
-        this->timer->StartEventTimer("cracksFading");
-      } else if (this->timer->HasEvent("cracksFading") &&
-                 this->timer->IsEventTimerExpired("cracksFading")) {
-        this->timer->CleanEvent("cracksFading");
+      if (this->timer->HasEvent(kCracksEvent) &&
+          this->timer->IsEventTimerExpired(kCracksEvent)) {
+        this->timer->CleanEvent(kCracksEvent);
+        this->timer->SetEventTimer(kCracksFadingEvent, 2.f);
+        this->timer->StartEventTimer(kCracksFadingEvent);
+      } else if (this->timer->HasEvent(kCracksFadingEvent) &&
+                 this->timer->IsEventTimerExpired(kCracksFadingEvent)) {
+        this->timer->CleanEvent(kCracksFadingEvent);
       }
     }
 
@@ -3001,9 +3267,9 @@ void GameManager::Render() {
           spriteRenderer, colorRenderer, circleRenderer, textRenderer);
     }
 
-    if (this->timer->HasEvent("firearrow") &&
-        this->timer->IsEventTimerExpired("firearrow")) {
-      this->timer->CleanEvent("firearrow");
+    if (this->timer->HasEvent(kFireArrowEvent) &&
+        this->timer->IsEventTimerExpired(kFireArrowEvent)) {
+      this->timer->CleanEvent(kFireArrowEvent);
       // Initialize an arrow firing by Weiqing towards Guojie.
       // Get target position on the charactor guojie.
       glm::vec2 targetPostion =
@@ -3013,10 +3279,9 @@ void GameManager::Render() {
                         gameCharacters["guojie"]->GetSize().y * 0.53f);
       // Randomly add offset to the target position within a circle of
       // kBaseUnit.
-      float angle = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) *
-                    2 * glm::pi<float>();
-      float radius = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) *
-                     kBaseUnit * 0.65f;
+      Xoshiro256& rng = Random::Get(RandomStream::kGameplay);
+      float angle = rng.Uniform(0.f, 2 * glm::pi<float>());
+      float radius = rng.Uniform(0.f, kBaseUnit * 0.65f);
       glm::vec2 offset =
           glm::vec2(radius * std::cos(angle), radius * std::sin(angle));
       targetPostion += offset;
@@ -3043,45 +3308,13 @@ void GameManager::Render() {
     if (this->state == GameState::ACTIVE ||
         this->state == GameState::PREPARING) {
       if (scroll->GetState() != ScrollState::DISABLED) {
+        // The arena shakes by moving the view it is drawn with, which leaves
+        // the positions of its entities untouched.
+        glm::vec2 shakingOffset(0.f);
         if (this->gameArenaShaking) {
-          // Memorize the current positions for each shaking object.
-          originalPositionsForShaking.clear();
-          originalPositionsForShaking["scroll"] = this->scroll->GetCenter();
-          originalPositionsForShaking["gameboard"] = gameBoard->GetPosition();
-          originalPositionsForShaking["shooter"] = shooter->GetPosition();
-          for (auto& [id, bubble] : moves) {
-            originalPositionsForShaking[std::to_string(id)] =
-                bubble->GetPosition();
-          }
-          for (auto& [id, bubble] : statics) {
-            originalPositionsForShaking[std::to_string(id)] =
-                bubble->GetPosition();
-          }
-          originalPositionsForShaking["time"] = texts["time"]->GetPosition();
-
-          // start shake effect
-          glm::vec2 shakingOffets = CalculateScrollShakingOffsets(
-              this->timer->HasEvent("scrollvibrate"));
-          // shake the scroll
-          scroll->SetCenter(scroll->GetCenter() + shakingOffets);
-          // shake the game board
-          gameBoard->SetPosition(gameBoard->GetPosition() + shakingOffets);
-          // shake the shooter
-          shooter->SetPosition(shooter->GetPosition() + shakingOffets);
-          // Update the path of the ray
-          shooter->GetRay().UpdatePath(this->gameBoard->GetBoundaries(),
-                                       this->statics);
-          // shake the moving bubbles
-          for (auto& [id, bubble] : moves) {
-            bubble->SetPosition(bubble->GetPosition() + shakingOffets);
-          }
-          // shake the static bubbles
-          for (auto& [id, bubble] : statics) {
-            bubble->SetPosition(bubble->GetPosition() + shakingOffets);
-          }
-          // shake the time text
-          texts["time"]->SetPosition(texts["time"]->GetPosition() +
-                                     shakingOffets);
+          shakingOffset = CalculateScrollShakingOffsets(
+              this->timer->HasEvent(kScrollVibrateEvent));
+          SetArenaViewOffset(shakingOffset);
         }
 
         scroll->Draw(spriteRenderer);
@@ -3090,9 +3323,11 @@ void GameManager::Render() {
         ScissorBoxHandler& handler = ScissorBoxHandler::GetInstance();
         handler.EnableScissorTest();
 
-        // Set the scissor box based on the upper and lower scroll
+        // Set the scissor box based on the upper and lower scroll, where they
+        // are drawn.
         glm::vec4 silkBounds = scroll->GetSilkBounds();
-        handler.SetScissorBox(silkBounds[0], this->height - silkBounds[3],
+        handler.SetScissorBox(silkBounds[0] + shakingOffset.x,
+                              this->height - silkBounds[3] - shakingOffset.y,
                               scroll->GetSilkWidth(), scroll->GetSilkLen());
         /* glScissor(silkBounds[0], this->height - silkBounds[3],
          * scroll->GetSilkWidth(), scroll->GetSilkLen());*/
@@ -3111,14 +3346,54 @@ void GameManager::Render() {
         // Particles
         explosionSystem->Draw(/*isDarkBackground=*/false);
 
-        // Draw all moving bubbles
-        for (auto& bubble : moves) {
-          bubble.second->Draw(spriteRenderer);
+        // Draw all moving bubbles between their previous and current
+        // positions. The view is moved by how far a bubble lags behind its
+        // current position, so drawing leaves the bubbles where the
+        // simulation put them.
+        for (auto& [id, bubble] : moves) {
+          glm::vec2 lag(0.f);
+          auto it = previousMovePositions.find(id);
+          if (it != previousMovePositions.end()) {
+            lag = glm::mix(it->second, bubble->GetPosition(), alpha) -
+                  bubble->GetPosition();
+          }
+          if (lag != glm::vec2(0.f)) {
+            SetArenaViewOffset(shakingOffset + lag);
+          }
+          bubble->Draw(spriteRenderer);
+          if (lag != glm::vec2(0.f)) {
+            SetArenaViewOffset(shakingOffset);
+          }
         }
 
-        // Draw all static bubbles
-        for (auto& bubble : statics) {
-          bubble.second->Draw(spriteRenderer);
+        // Draw all static and falling bubbles. The static bubbles are kept
+        // relative to the static origin, which is added as a translation and
+        // glides with them while the board narrows.
+        Texture2D bubbleTexture =
+            ResourceManager::GetInstance().GetTexture("bubble");
+        const glm::vec2 staticOrigin =
+            glm::mix(bubbles.GetPreviousStaticOrigin(),
+                     bubbles.GetStaticOrigin(), alpha);
+        const std::vector<glm::vec2>& bubbleCenters = bubbles.GetCenters();
+        const std::vector<glm::vec2>& previousBubbleCenters =
+            bubbles.GetPreviousCenters();
+        const std::vector<float>& bubbleRadii = bubbles.GetRadii();
+        const std::vector<Color>& bubbleColors = bubbles.GetColors();
+        const std::vector<BubbleState>& bubbleStates = bubbles.GetStates();
+        for (size_t i = 0; i < bubbles.Size(); ++i) {
+          if (bubbleStates[i] != BubbleState::Static &&
+              bubbleStates[i] != BubbleState::Falling) {
+            continue;
+          }
+          glm::vec2 center =
+              glm::mix(previousBubbleCenters[i], bubbleCenters[i], alpha);
+          if (bubbleStates[i] == BubbleState::Static) {
+            center += staticOrigin;
+          }
+          spriteRenderer->DrawSprite(
+              bubbleTexture, center - glm::vec2(bubbleRadii[i]),
+              glm::vec2(2.f * bubbleRadii[i]), 0.f, glm::vec2(0.5f, 0.5f),
+              glm::vec4(toRgb(bubbleColors[i]), kBubbleAlpha));
         }
 
         //// Draw all the free slots
@@ -3129,43 +3404,25 @@ void GameManager::Render() {
         //     glm::vec2(0.5,0.5), glm::vec4(0.5,0.5,0.5,0.7));
         // }
 
-        // Draw all falling bubbles
-        for (auto& bubble : fallings) {
-          bubble.second->Draw(spriteRenderer);
-        }
-
         // Disable scissor test
         /*glDisable(GL_SCISSOR_TEST);*/
         handler.DisableScissorTest();
 
-        // Draw the score increment texts
-        for (const auto& [scoreIncrementText, timeToStartFadingOut] :
-             scoreIncrementTexts) {
-          scoreIncrementText->Draw(textRenderer);
-        }
-
         // Draw the time when the scroll is opened
         if (this->scroll->GetState() == ScrollState::OPENED) {
           texts.at("time")->Draw(textRenderer, /*centerAligned=*/false,
                                  /*rightAligned=*/true);
         }
 
-        // Restore the original positions for each shaking object
+        // The score increment texts do not shake with the arena.
         if (this->gameArenaShaking) {
-          this->scroll->SetCenter(originalPositionsForShaking["scroll"]);
-          gameBoard->SetPosition(originalPositionsForShaking["gameboard"]);
-          shooter->SetPosition(originalPositionsForShaking["shooter"]);
-          shooter->GetRay().UpdatePath(this->gameBoard->GetBoundaries(),
-                                       this->statics);
-          for (auto& [id, bubble] : moves) {
-            bubble->SetPosition(
-                originalPositionsForShaking[std::to_string(id)]);
-          }
-          for (auto& [id, bubble] : statics) {
-            bubble->SetPosition(
-                originalPositionsForShaking[std::to_string(id)]);
-          }
-          texts["time"]->SetPosition(originalPositionsForShaking["time"]);
+          SetArenaViewOffset(glm::vec2(0.f));
+        }
+
+        // Draw the score increment texts
+        for (const auto& [scoreIncrementText, timeToStartFadingOut] :
+             scoreIncrementTexts) {
+          scoreIncrementText->Draw(textRenderer);
         }
       }
     } else {
@@ -3262,8 +3519,8 @@ void GameManager::Render() {
     } else {
       texts["defeated"]->Draw(textRenderer, true);
     }
-    if (this->timer->HasEvent("prompttomainmenu") &&
-        !this->timer->IsPaused("prompttomainmenu")) {
+    if (this->timer->HasEvent(kPromptToMainMenuEvent) &&
+        !this->timer->IsPaused(kPromptToMainMenuEvent)) {
       texts["prompttomainmenu"]->Draw(textRenderer, true);
     }
   }
@@ -3287,69 +3544,11 @@ void GameManager::Render() {
 }
 
 int GameManager::GetNumGameLevels() {
-  switch (difficulty) {
-    case Difficulty::EASY:
-      return 15;
-    case Difficulty::MEDIUM:
-      return 30;
-    case Difficulty::HARD:
-      return 45;
-    case Difficulty::EXPERT:
-      return 60;
-    default:
-      return 30;
-  }
+  return getNumGameLevels(this->difficulty);
 }
 
-int GameManager::GetBubbleNumForLevel() {
-  if (this->level <= 10) {
-    int base = 10;
-    if (this->difficulty == Difficulty::MEDIUM) {
-      base += 5;
-    } else if (this->difficulty == Difficulty::HARD) {
-      base += 10;
-    } else if (this->difficulty == Difficulty::EXPERT) {
-      base += 15;
-    }
-    return base + this->level * 5;
-  } else if (this->level <= 20) {
-    int base = 40;
-    if (this->difficulty == Difficulty::MEDIUM) {
-      base += 5;
-    } else if (this->difficulty == Difficulty::HARD) {
-      base += 10;
-    } else if (this->difficulty == Difficulty::EXPERT) {
-      base += 15;
-    }
-    return base + (this->level - 10) * 5;
-  } else if (this->level <= 30) {
-    int base = 75;
-    if (this->difficulty == Difficulty::HARD) {
-      base += 10;
-    } else if (this->difficulty == Difficulty::EXPERT) {
-      base += 15;
-    }
-    return base + (this->level - 20) * 5;
-  } else if (this->level <= 40) {
-    int base = 105;
-    if (this->difficulty == Difficulty::HARD) {
-      base += 10;
-    } else if (this->difficulty == Difficulty::EXPERT) {
-      base += 15;
-    }
-    return base + (this->level - 30) * 5;
-  } else if (this->level <= 50) {
-    int base = 140;
-    if (this->difficulty == Difficulty::EXPERT) {
-      base += 15;
-    }
-    return base + (this->level - 40) * 5;
-  } else if (this->level <= 60) {
-    int base = 170;
-    return base + (this->level - 50) * 5;
-  } else {
-    return 120;
-  }
+int GameManager::GetBubbleNumForLevel(int level) {
+  return getBubbleNumForLevel(level, this->difficulty);
 }
 
 std::string GameManager::GetPageName(GameState gameState) {
@@ -3438,10 +3637,12 @@ void GameManager::SetState(GameState newState) {
     }*/
     soundEngine.StartBackgroundMusic(/*isFighting=*/false);
   } else if (this->state == GameState::SPLASH_SCREEN) {
-    // Play the white noise sound effect.
-    SoundEngine& soundEngine = SoundEngine::GetInstance();
-    if (!soundEngine.IsPlaying("white_noise")) {
-      soundEngine.PlaySound("white_noise", false);
+    // Play the white noise sound effect. It fades out after the white noise
+    // event.
+    if (!timer->HasEvent(kWhiteNoiseEvent)) {
+      SoundEngine::GetInstance().PlaySound("white_noise", false);
+      timer->SetEventTimer(kWhiteNoiseEvent, 0.45f);
+      timer->StartEventTimer(kWhiteNoiseEvent);
     }
   }
 }
@@ -3459,9 +3660,9 @@ void GameManager::GoToState(GameState newState) {
   // Stop scroll vibrating when the current game state is ACTIVE but the target
   // state is not.
   if (this->state == GameState::ACTIVE && newState != GameState::ACTIVE) {
-    if (this->timer->HasEvent("scrollvibrate")) {
+    if (this->timer->HasEvent(kScrollVibrateEvent)) {
       this->gameArenaShaking = false;
-      this->timer->CleanEvent("scrollvibrate");
+      this->timer->CleanEvent(kScrollVibrateEvent);
     }
   }
 }
@@ -3743,11 +3944,12 @@ void GameManager::LoadTexts() {
   std::vector<std::string> clickableOptionNames = {
       "fullscreen", "windowedborderless", "windowed"};
   for (const auto& clickableOptionName : clickableOptionNames) {
-    if (texts.find(clickableOptionName) != texts.end()) {
+    auto it = texts.find(StringId(clickableOptionName));
+    if (it != texts.end()) {
       if (clickableOptionName == "fullscreen" ||
           clickableOptionName == "windowedborderless" ||
           clickableOptionName == "windowed") {
-        texts[clickableOptionName]->SetParagraph(
+        it->second->SetParagraph(
             0, resourceManager.GetText("screenmode", clickableOptionName));
       }
     }
@@ -3755,8 +3957,9 @@ void GameManager::LoadTexts() {
 
   clickableOptionNames = {"easy", "medium", "hard", "expert"};
   for (const auto& clickableOptionName : clickableOptionNames) {
-    if (texts.find(clickableOptionName) != texts.end()) {
-      texts[clickableOptionName]->SetParagraph(
+    auto it = texts.find(StringId(clickableOptionName));
+    if (it != texts.end()) {
+      it->second->SetParagraph(
           0, resourceManager.GetText("difficulty", clickableOptionName));
     }
   }
@@ -3765,15 +3968,16 @@ void GameManager::LoadTexts() {
   std::vector<std::string> gameCharacterNames = {"liuche", "weizifu", "weiqing",
                                                  "guojie"};
   for (const auto& gameCharacterName : gameCharacterNames) {
-    if (texts.find(gameCharacterName + "intro") == texts.end()) {
-      texts[gameCharacterName + "intro"] = std::make_shared<Text>(
+    StringId introId(gameCharacterName + "intro");
+    if (texts.find(introId) == texts.end()) {
+      texts[introId] = std::make_shared<Text>(
           /*pos=*/glm::vec2(0.f),
           /*lineWidth=*/gameBoard->GetSize().x - kBaseUnit);
-      texts[gameCharacterName + "intro"]->AddParagraph(
+      texts[introId]->AddParagraph(
           resourceManager.GetText("characterintro", gameCharacterName));
-      texts[gameCharacterName + "intro"]->SetScale(0.0216f / kFontScale);
+      texts[introId]->SetScale(0.0216f / kFontScale);
     } else {
-      texts[gameCharacterName + "intro"]->SetParagraph(
+      texts[introId]->SetParagraph(
           0, resourceManager.GetText("characterintro", gameCharacterName));
     }
   }
@@ -3824,12 +4028,13 @@ void GameManager::ReloadTexts() {
   std::vector<std::string> clickableOptionNames = {
       "fullscreen", "windowedborderless", "windowed"};
   for (const auto& clickableOptionName : clickableOptionNames) {
-    if (texts.find(clickableOptionName) != texts.end()) {
+    auto it = texts.find(StringId(clickableOptionName));
+    if (it != texts.end()) {
       if (clickableOptionName == "fullscreen" ||
           clickableOptionName == "windowedborderless" ||
           clickableOptionName == "windowed") {
-        texts[clickableOptionName]->RemoveAllParagraphs(false);
-        texts[clickableOptionName]->AddParagraph(
+        it->second->RemoveAllParagraphs(false);
+        it->second->AddParagraph(
             resourceManager.GetText("screenmode", clickableOptionName));
       }
     }
@@ -3837,15 +4042,17 @@ void GameManager::ReloadTexts() {
 
   clickableOptionNames = {"easy", "medium", "hard", "expert"};
   for (const auto& clickableOptionName : clickableOptionNames) {
-    if (texts.find(clickableOptionName) != texts.end()) {
-      texts[clickableOptionName]->RemoveAllParagraphs(false);
-      texts[clickableOptionName]->AddParagraph(
+    auto it = texts.find(StringId(clickableOptionName));
+    if (it != texts.end()) {
+      it->second->RemoveAllParagraphs(false);
+      it->second->AddParagraph(
           resourceManager.GetText("difficulty", clickableOptionName));
     }
   }
 
   for (const auto& [languageEnum, clickableOptionName] : language_map) {
-    texts[clickableOptionName]->RemoveAllParagraphs(false);
+    auto& languageText = texts.at(StringId(clickableOptionName));
+    languageText->RemoveAllParagraphs(false);
     std::u32string languageName;
     switch (languageEnum) {
       case Language::GERMAN:
@@ -3885,15 +4092,16 @@ void GameManager::ReloadTexts() {
         languageName = U"中文（繁體）";
         break;
     }
-    texts[clickableOptionName]->AddParagraph(languageName);
+    languageText->AddParagraph(languageName);
   }
 
   // Create character introduction units
   std::vector<std::string> gameCharacterNames = {"liuche", "weizifu", "weiqing",
                                                  "guojie"};
   for (const auto& gameCharacterName : gameCharacterNames) {
-    texts[gameCharacterName + "intro"]->RemoveAllParagraphs(false);
-    texts[gameCharacterName + "intro"]->AddParagraph(
+    auto& introText = texts.at(StringId(gameCharacterName + "intro"));
+    introText->RemoveAllParagraphs(false);
+    introText->AddParagraph(
         resourceManager.GetText("characterintro", gameCharacterName));
   }
 }
@@ -3907,14 +4115,15 @@ void GameManager::LoadButtons() {
                                           "stop",       "displaysettings",
                                           "difficulty", "languagepreference"};
   for (const auto& buttonName : buttonNames) {
-    if (buttons.find(buttonName) == buttons.end()) {
-      buttons[buttonName] = std::make_shared<Button>(
+    StringId buttonId(buttonName);
+    if (buttons.find(buttonId) == buttons.end()) {
+      buttons[buttonId] = std::make_shared<Button>(
           glm::vec2(this->width / 2.0f - kBaseUnit * 4.5f,
                     this->height * 0.84f),
           glm::vec2(kBaseUnit * 6.5f, kBaseUnit * 3.0f),
           resourceManager.GetText("button", buttonName));
     } else {
-      buttons[buttonName]->GetText().SetParagraph(
+      buttons[buttonId]->GetText().SetParagraph(
           0, resourceManager.GetText("button", buttonName));
     }
   }
@@ -3929,8 +4138,9 @@ void GameManager::ReloadButtons() {
                                           "stop",       "displaysettings",
                                           "difficulty", "languagepreference"};
   for (const auto& buttonName : buttonNames) {
-    buttons[buttonName]->GetText().RemoveAllParagraphs();
-    buttons[buttonName]->GetText().AddParagraph(
+    auto& button = buttons.at(StringId(buttonName));
+    button->GetText().RemoveAllParagraphs();
+    button->GetText().AddParagraph(
         resourceManager.GetText("button", buttonName));
   }
 }
@@ -3964,6 +4174,28 @@ void GameManager::SetScrollState(ScrollState newScrollState) {
 
 ScrollState GameManager::GetScrollState() { return this->scroll->GetState(); }
 
+void GameManager::SetArenaViewOffset(glm::vec2 offset) {
+  ResourceManager& resourceManager = ResourceManager::GetInstance();
+  glm::mat4 view = glm::translate(glm::mat4(1.f), glm::vec3(offset, 0.f));
+  // The view is folded into the projections of the shaders the arena is drawn
+  // with. The text shader has its own projection, without the depth range.
+  glm::mat4 projection =
+      glm::ortho(0.0f, static_cast<float>(this->width),
+                 static_cast<float>(this->height), 0.0f, -1.0f, 1.0f) *
+      view;
+  for (const char* name :
+       {"sprite", "ray", "particle", "purecolor", "discard"}) {
+    resourceManager.GetShader(name).SetMatrix4("projection", projection,
+                                               /*useShader=*/true);
+  }
+  glm::mat4 textProjection =
+      glm::ortho(0.0f, static_cast<float>(this->width),
+                 static_cast<float>(this->height), 0.0f) *
+      view;
+  resourceManager.GetShader("text").SetMatrix4("projection", textProjection,
+                                               /*useShader=*/true);
+}
+
 glm::vec2 GameManager::CalculateScrollShakingOffsets(bool isScrollVibrating) {
   float shakeOffsetX = 0.f, shakeOffsetY = 0.f;
   if (isScrollVibrating) {
@@ -3998,570 +4230,42 @@ glm::vec2 GameManager::CalculateScrollShakingOffsets(bool isScrollVibrating) {
 
 std::vector<int> GameManager::GetNeighborIds(std::unique_ptr<Bubble>& bubble,
                                              float absError) {
-  std::vector<int> neighborIds;
-  for (auto& [id, staticBubble] : statics) {
-    if (IsNeighbor(staticBubble->GetCenter(), bubble->GetCenter(), absError)) {
-      neighborIds.push_back(id);
-    }
-  }
-  return neighborIds;
+  return GetNeighborIds(bubble->GetCenter(), absError);
+}
+
+std::vector<int> GameManager::GetNeighborIds(glm::vec2 center, float absError) {
+  return board.GetNeighborIds(center, absError);
 }
 
 std::vector<int> GameManager::GetNeighborIds(std::vector<Bubble*>& bubbles) {
   std::vector<int> neighborIds;
   for (auto& bubble : bubbles) {
-    for (auto& [id, staticBubble] : statics) {
-      if (IsNeighbor(staticBubble->GetCenter(), bubble->GetCenter())) {
-        neighborIds.push_back(id);
-      }
-    }
+    std::vector<int> ids = GetNeighborIds(bubble->GetCenter());
+    neighborIds.insert(neighborIds.end(), ids.begin(), ids.end());
   }
   return neighborIds;
 }
 
-std::vector<int> GameManager::GetNeighborIds(
-    std::unordered_map<int, std::unique_ptr<Bubble>>& bubbles) {
-  std::unordered_set<int> neighborIds;
-  for (auto& [id, bubble] : bubbles) {
-    for (auto& [staticId, staticBubble] : statics) {
-      if (IsNeighbor(staticBubble->GetCenter(), bubble->GetCenter())) {
-        neighborIds.insert(staticId);
-      }
-    }
-  }
-  return std::vector<int>(neighborIds.begin(), neighborIds.end());
-}
 bool GameManager::IsAtUpperBoundary(glm::vec2 pos) {
-  return areFloatsEqual(pos.y, gameBoard->GetValidPosition().y, 1.f);
-}
-
-bool GameManager::IsConnectedToTopHelper(std::unique_ptr<Bubble>& bubble,
-                                         bool* visited, bool* isConnectToTop) {
-  if (visited[bubble->GetID()]) {
-    return isConnectToTop[bubble->GetID()];
-  }
-
-  if (IsAtUpperBoundary(bubble->GetPosition())) {
-    return isConnectToTop[bubble->GetID()] = true;
-  }
-  visited[bubble->GetID()] = true;
-  std::vector<int> neighborIds = GetNeighborIds(bubble);
-  for (auto& neighborId : neighborIds) {
-    if (statics[neighborId] == nullptr) {
-      std::string str = "";
-    }
-    if (IsConnectedToTopHelper(statics[neighborId], visited, isConnectToTop)) {
-      isConnectToTop[bubble->GetID()] = true;
-    }
-  }
-
-  return isConnectToTop[bubble->GetID()];
-}
-
-bool GameManager::IsConnectedToTop(std::unique_ptr<Bubble>& bubble) {
-  const int maxAvailableID = ResourceManager::GetInstance().GetMaxAvailableID();
-  bool* visited = new bool[maxAvailableID + 1];
-  bool* isConnectToTop = new bool[maxAvailableID + 1];
-  for (int i = 0; i <= maxAvailableID; ++i) {
-    visited[i] = false;
-    isConnectToTop[i] = false;
-  }
-
-  bool isConnected = IsConnectedToTopHelper(bubble, visited, isConnectToTop);
-
-  delete[] visited;
-  delete[] isConnectToTop;
-  visited = nullptr;
-  isConnectToTop = nullptr;
-
-  return isConnected;
-}
-
-std::vector<int> GameManager::FindConnectedBubbles(
-    std::vector<int>& bubbleIds) {
-  std::vector<int> unvisited;
-  std::vector<int> connectedBubbles;
-  // push all the static bubbles ids into the unvisited set.
-  for (auto& [id, bubble] : statics) {
-    unvisited.emplace_back(id);
-  }
-  // push all the given bubble ids into the connectedBubblesSet.
-  for (auto& id : bubbleIds) {
-    connectedBubbles.emplace_back(id);
-  }
-  // Traverse all the unvisited bubbles and find the bubbles that are connected
-  // to the given bubble.
-  size_t i = 0;
-  while (i < unvisited.size()) {
-    int unvisitedId = unvisited[i++];
-    for (size_t j = 0; j < connectedBubbles.size(); ++j) {
-      if (IsNeighbor(statics[unvisitedId]->GetCenter(),
-                     statics[connectedBubbles[j]]->GetCenter())) {
-        connectedBubbles.emplace_back(unvisitedId);
-        std::swap(unvisited[i - 1], unvisited.back());
-        unvisited.pop_back();
-        if (unvisited.empty()) {
-          return connectedBubbles;
-        } else {
-          i = 0;
-          break;
-        }
-      }
-    }
-  }
-  return connectedBubbles;
-}
-
-std::vector<int> GameManager::FindAllFallingBubbles() {
-  const int maxAvailableID = ResourceManager::GetInstance().GetMaxAvailableID();
-
-  std::vector<int> topIds;
-  std::vector<int> fallingIds;
-
-  // First get the ids of all the bubbles that are on the top of the game board.
-  for (auto& [id, bubble] : statics) {
-    if (IsAtUpperBoundary(bubble->GetPosition())) {
-      topIds.emplace_back(id);
-    }
-  }
-
-  // Find all bubbles that are connected to those top bubbles.
-  std::vector<int> connectedIds = FindConnectedBubbles(topIds);
-
-  // Find all the statics bubbles that are not connected to the top of the game
-  // board and add them to the falling bubbles.
-  for (auto& [id, bubble] : statics) {
-    if (std::find(connectedIds.begin(), connectedIds.end(), id) ==
-        connectedIds.end()) {
-      fallingIds.emplace_back(id);
-    }
-  }
-
-  return fallingIds;
-}
-
-std::vector<int> GameManager::FindCloseUpperBubbles(
-    std::unique_ptr<Bubble>& bubble) {
-  std::vector<int> closeUpperIds;
-  for (auto& [id, staticBubble] : statics) {
-    if (IsAtUpperBoundary(staticBubble->GetPosition()) &&
-        glm::distance(staticBubble->GetCenter(), bubble->GetCenter()) <
-            (1.5f * bubble->GetRadius() + staticBubble->GetRadius())) {
-      closeUpperIds.emplace_back(id);
-    }
-  }
-  return closeUpperIds;
-}
-
-int GameManager::FindLeftBubble(std::unique_ptr<Bubble>& bubble) {
-  int leftId = -1;
-  float minDistance = std::numeric_limits<float>::max();
-  for (auto& [id, staticBubble] : statics) {
-    // the center y should be the same
-    if (areFloatsEqual(staticBubble->GetCenter().y, bubble->GetCenter().y,
-                       1e-1)) {
-      float distance = bubble->GetCenter().x - staticBubble->GetCenter().x;
-      if (distance > 0 && distance < minDistance) {
-        minDistance = distance;
-        leftId = id;
-      }
-    }
-  }
-  return leftId;
-}
-
-int GameManager::FindRightBubble(std::unique_ptr<Bubble>& bubble) {
-  int rightId = -1;
-  float minDistance = std::numeric_limits<float>::max();
-  for (auto& [id, staticBubble] : statics) {
-    // the center y should be the same
-    if (areFloatsEqual(staticBubble->GetCenter().y, bubble->GetCenter().y,
-                       1e-1)) {
-      float distance = staticBubble->GetCenter().x - bubble->GetCenter().x;
-      if (distance > 0 && distance < minDistance) {
-        minDistance = distance;
-        rightId = id;
-      }
-    }
-  }
-  return rightId;
-}
-
-bool GameManager::FineTuneToCloseUpper(int bubbleId) {
-  // Get all the static bubbles that are connected to the top of the game board
-  // and close to the current bubble.
-  auto& bubble = moves[bubbleId];
-  std::vector<int> closeUpperIds = FindCloseUpperBubbles(bubble);
-  if (closeUpperIds.empty()) {
-    return false;
-  }
-  // Iterate through all the close upper bubbles and find the best free slot
-  // center.
-  float highestWeight = 0.0f;
-  glm::vec2 bestFreeSlotCenter;
-  for (const auto& id : closeUpperIds) {
-    // Check if the bubble is to the left or to the right of the static bubble.
-    float deltaX = statics[id]->GetCenter().x - bubble->GetCenter().x;
-    bool isLeft = deltaX < 0.f;
-    // If the static bubble is to the left of the moving bubble,then the free
-    // slot center should be to the right of the static bubble.
-    glm::vec2 freeSlotCenter;
-    if (isLeft) {
-      freeSlotCenter =
-          statics[id]->GetCenter() +
-          glm::vec2(statics[id]->GetRadius() + bubble->GetRadius(), 0.0f);
-    } else {
-      freeSlotCenter =
-          statics[id]->GetCenter() -
-          glm::vec2(statics[id]->GetRadius() + bubble->GetRadius(), 0.0f);
-    }
-    // Get the weight of the free slot
-    float weight =
-        GetFreeSlotWeight(bubble->GetColorWithoutAlpha(), freeSlotCenter);
-
-    // If the weight is greater than the highest weight, then we update the
-    // highest weight and the free slot center.
-    if (weight > highestWeight) {
-      highestWeight = weight;
-      bestFreeSlotCenter = freeSlotCenter;
-    }
-  }
-  // If the highest weight is greater than 0, then we move the bubble to the
-  // best free slot center.
-  if (highestWeight > 0.0f) {
-    bubble->SetPosition(bestFreeSlotCenter -
-                        glm::vec2(kBubbleRadius, kBubbleRadius));
-    return true;
-  }
-  // No fine tuning happened.
-  return false;
-}
-
-bool GameManager::FineTuneToCorrectPosition(int bubbleId) {
-  assert(moves.count(bubbleId) > 0 && "Failed to find the bubble by ID.");
-  auto& bubble = moves[bubbleId];
-  std::vector<int> neighborIds = GetNeighborIds(bubble);
-  glm::vec4 boundaries = gameBoard->GetValidBoundaries();
-  glm::vec2 newPosition = bubble->GetPosition();
-  if (neighborIds.empty()) {
-    assert(IsAtUpperBoundary(bubble->GetPosition()) &&
-           "The bubble is not at the upper boundary.");
-    int leftId = FindLeftBubble(bubble);
-    int rightId = FindRightBubble(bubble);
-    assert((leftId != -1 || rightId != -1) &&
-           "At least one static bubble can be found at the upper boundary.");
-    float leftDistance = bubble->GetPosition().x - boundaries.x;
-    float rightDistance =
-        boundaries.z - 2 * kBubbleRadius - bubble->GetPosition().x;
-    float offSetToLeft = -1.f;
-    float offSetToRight = -1.f;
-    if (leftId != -1) {
-      // Get the distance between the left static bubble and the current bubble.
-      float leftDistance1 =
-          bubble->GetCenter().x - statics.at(leftId)->GetCenter().x;
-      // assert(leftDistance1 > 0 &&
-      //        !areFloatsGreater(leftDistance1, leftDistance) &&
-      //        "The distance calculation bettween bubbles is wrong");
-      leftDistance = leftDistance1;
-      while (leftDistance >= 4 * kBubbleRadius) {
-        leftDistance -= 4 * kBubbleRadius;
-        if (leftDistance < 0) {
-          leftDistance = 0;
-        }
-      }
-      if (leftDistance < 2 * std::sqrt(2) * kBubbleRadius) {
-        offSetToLeft = leftDistance;
-        offSetToRight = 2 * std::sqrt(2) * kBubbleRadius - leftDistance;
-      } else if (leftDistance < 2 * std::sqrt(3) * kBubbleRadius) {
-        offSetToLeft =
-            2 * std::sqrt(3) * kBubbleRadius - 2 * std::sqrt(2) * kBubbleRadius;
-        offSetToRight = 2 * std::sqrt(3) * kBubbleRadius - leftDistance;
-      } else if (leftDistance < 4 * kBubbleRadius) {
-        offSetToLeft = 4 * kBubbleRadius - 2 * std::sqrt(3) * kBubbleRadius;
-        offSetToRight = 4 * kBubbleRadius - leftDistance;
-      }
-    } else if (rightId != -1) {
-      // Get the distance between the right static bubble and the current
-      // bubble.
-      float rightDistance1 =
-          statics.at(rightId)->GetCenter().x - bubble->GetCenter().x;
-      // assert(rightDistance1 > 0 &&
-      //        !areFloatsGreater(rightDistance1, rightDistance) &&
-      //        "The distance calculation bettween bubbles is wrong");
-      rightDistance = rightDistance1;
-      while (rightDistance >= 4 * kBubbleRadius) {
-        rightDistance -= 4 * kBubbleRadius;
-        if (rightDistance < 0) {
-          rightDistance = 0;
-        }
-      }
-      if (rightDistance < 2 * std::sqrt(2) * kBubbleRadius) {
-        offSetToRight = rightDistance;
-        offSetToLeft = 2 * std::sqrt(2) * kBubbleRadius - rightDistance;
-      } else if (rightDistance < 2 * std::sqrt(3) * kBubbleRadius) {
-        offSetToRight =
-            2 * std::sqrt(3) * kBubbleRadius - 2 * std::sqrt(2) * kBubbleRadius;
-        offSetToLeft = 2 * std::sqrt(3) * kBubbleRadius - rightDistance;
-      } else if (rightDistance < 4 * kBubbleRadius) {
-        offSetToRight = 4 * kBubbleRadius - 2 * std::sqrt(3) * kBubbleRadius;
-        offSetToLeft = 4 * kBubbleRadius - rightDistance;
-      }
-    }
-    assert(offSetToLeft >= 0.f && offSetToRight >= 0.f &&
-           "The offset to the left and the right should be greater than or "
-           "equal to 0.");
-    if (offSetToLeft < offSetToRight) {
-      newPosition = bubble->GetPosition() - glm::vec2(offSetToLeft, 0.f);
-      /*bubble->SetPosition(bubble->GetPosition() - glm::vec2(offSetToLeft,
-       * 0.f));*/
-    } else {
-      newPosition = bubble->GetPosition() + glm::vec2(offSetToRight, 0.f);
-      // bubble->SetPosition(bubble->GetPosition() +
-      //                     glm::vec2(offSetToRight, 0.f));
-    }
-    // float weight =
-    //     GetFreeSlotWeight(bubble->GetColorWithoutAlpha(), newPosition);
-    // if (weight > 0.f) {
-    // bubble->SetPosition(newPosition);
-    // return true;
-    // }
-    // else {
-    //   return false;
-    // }
-    /*  return std::min(offSetToLeft, offSetToRight) == 0.f;*/
-  } else if (neighborIds.size() == 1) {
-    // Fine-tune the bubble's position to ensure its angle with a single
-    // neighbor is a multiple of 30 degrees, measured clockwise from the right
-    // side.
-    int neighborId = neighborIds[0];
-    auto& neighborBubble = statics[neighborId];
-    glm::vec2 curDirection =
-        glm::normalize(bubble->GetCenter() - neighborBubble->GetCenter());
-    glm::vec2 baseDirection = glm::vec2(1.f, 0.f);
-    // calculate the cosine of the angle between the two vectors
-    float cosAngle = glm::dot(curDirection, baseDirection);
-    float curAngle = glm::acos(cosAngle);
-    if (curDirection.y < 0.f) {
-      curAngle = 2 * glm::pi<float>() - curAngle;
-    }
-    float targetAngle =
-        std::floor(curAngle / (glm::pi<float>() / 6)) * glm::pi<float>() / 6;
-    if (targetAngle <= curAngle) {
-      float diff1 = curAngle - targetAngle;
-      float diff2 = targetAngle + glm::pi<float>() / 6 - curAngle;
-      if (diff1 > diff2) {
-        targetAngle += glm::pi<float>() / 6;
-      }
-    }
-    targetAngle = std::round(targetAngle / (glm::pi<float>() / 6)) *
-                  (glm::pi<float>() / 6);
-    glm::vec2 targetDirection = rotateVector(baseDirection, targetAngle);
-    glm::vec2 targetCenter =
-        neighborBubble->GetCenter() + 2 * kBubbleRadius * targetDirection;
-    newPosition = targetCenter - glm::vec2(kBubbleRadius, kBubbleRadius);
-    // bubble->SetPosition(targetCenter - glm::vec2(kBubbleRadius,
-    // kBubbleRadius)); return true;
-  }
-  float weight = GetFreeSlotWeight(bubble->GetColorWithoutAlpha(), newPosition);
-  if (weight > 0.f) {
-    bubble->SetPosition(newPosition);
-    return true;
-  } else {
-    return false;
-  }
-  /* return false;*/
-}
-
-bool GameManager::FineTuneToNeighbor(int bubbleId, int staticBubbleId) {
-  assert(moves.count(bubbleId) > 0 && statics.count(staticBubbleId) > 0 &&
-         "Failed to find the bubble by ID.");
-  // bubbles.
-  auto& bubble = moves[bubbleId];
-  auto& staticBubble = statics[staticBubbleId];
-  float highestWeight = 0.0f;
-  glm::vec2 bestFreeSlotCenter;
-  // Get the normalized vector from the static bubble to the bubble
-  glm::vec2 bubbleDirection =
-      glm::normalize(bubble->GetCenter() - staticBubble->GetCenter());
-  for (auto& [id, neighborBubble] : statics) {
-    if (id == staticBubbleId) {
-      continue;
-    }
-    if (IsNeighbor(neighborBubble->GetCenter(), staticBubble->GetCenter())) {
-      // Get the normalized vector from the static bubble to the neighbor
-      glm::vec2 neighborDirection = glm::normalize(neighborBubble->GetCenter() -
-                                                   staticBubble->GetCenter());
-
-      // Get the cosine of the angle between the two vectors
-      float cosAngle = glm::dot(neighborDirection, bubbleDirection);
-      // If the angle is less than 60 degrees or greater than 100 degrees, then
-      // we won't consider it.
-      if (cosAngle < 0.0f || cosAngle > 0.5f) {
-        continue;
-      }
-      // Get the free slot center. It should form a 60 degree angle with the
-      // static bubble and the neighbor bubble.
-      glm::vec2 freeSlotCenter;
-      int a = getSignOfCrossProduct(neighborDirection, bubbleDirection);
-      // if a is 0, then the two vectors are parallel. We don't consider this
-      // case.
-      if (a == 0) {
-        continue;
-      } else if (a > 0) {
-        freeSlotCenter = rotateVector(
-            staticBubble->GetCenter() + 2 * kBubbleRadius * neighborDirection,
-            glm::pi<float>() / 3, staticBubble->GetCenter());
-      } else {
-        freeSlotCenter = rotateVector(
-            staticBubble->GetCenter() + 2 * kBubbleRadius * neighborDirection,
-            -glm::pi<float>() / 3, staticBubble->GetCenter());
-      }
-
-      // Get the weight of the free slot
-      float weight =
-          GetFreeSlotWeight(bubble->GetColorWithoutAlpha(), freeSlotCenter);
-
-      // If the weight is greater than the highest weight, then we update the
-      // highest weight and the free slot center.
-      if (weight > highestWeight) {
-        highestWeight = weight;
-        bestFreeSlotCenter = freeSlotCenter;
-      }
-    }
-  }
-  // If the highest weight is greater than 0, then we move the bubble to the
-  // best free slot center.
-  if (highestWeight > 0.0f) {
-    bubble->SetPosition(bestFreeSlotCenter -
-                        glm::vec2(kBubbleRadius, kBubbleRadius));
-    return true;
-  }
-
-  // No fine tuning happened.
-  return false;
-}
-
-bool GameManager::FineTuneToClose(int bubbleId, int staticBubbleId) {
-  // bubbles.
-  auto& bubble = moves[bubbleId];
-  auto& staticBubble = statics[staticBubbleId];
-  float highestWeight = 0.0f;
-  glm::vec2 bestFreeSlotCenter;
-  // Get the normalized vector from the static bubble to the bubble
-  glm::vec2 bubbleDirection =
-      glm::normalize(bubble->GetCenter() - staticBubble->GetCenter());
-  // If the highest weight is 0, we get the closest static bubbles that are not
-  // neighbors of the static bubble, but its distance to the static bubble is
-  // less than or equal to 4*kBubbleRadius.
-  for (auto& [id, closeBubble] : statics) {
-    if (id == staticBubbleId) {
-      continue;
-    }
-    // If it is a neighbor of the static bubble, then we don't consider it.
-    if (IsNeighbor(closeBubble->GetCenter(), staticBubble->GetCenter())) {
-      continue;
-    }
-    // If the distance between the two bubbles is greater than 4*kBubbleRadius,
-    // then we don't consider it.
-    float distance =
-        glm::distance(closeBubble->GetCenter(), staticBubble->GetCenter());
-    if (distance > 4 * kBubbleRadius) {
-      continue;
-    }
-    // Get the normalized vector from the static bubble to the close bubble
-    glm::vec2 closeBubbleDirection =
-        glm::normalize(closeBubble->GetCenter() - staticBubble->GetCenter());
-    // Get the cosine of the angle between the two vectors
-    float cosAngle = glm::dot(closeBubbleDirection, bubbleDirection);
-    // If the angle is less than 60 degrees or greater than 90 degrees, then we
-    // won't consider it.
-    if (cosAngle < 0.0f || cosAngle > 0.866f) {
-      continue;
-    }
-    // calculate the angle from the cosAngle using glm::acos
-    float rotationAngle =
-        lawOfCosinesAngle(distance, 2 * kBubbleRadius, 2 * kBubbleRadius);
-    // Get the free slot center. This free slot should be a circle neighboring
-    // both the static bubble and the close bubble.
-    glm::vec2 freeSlotCenter;
-    int a = getSignOfCrossProduct(closeBubbleDirection, bubbleDirection);
-    // if a is 0, then the two vectors are parallel. We don't consider this
-    // case.
-    if (a == 0) {
-      continue;
-    } else if (a > 0) {
-      freeSlotCenter = rotateVector(
-          staticBubble->GetCenter() + 2 * kBubbleRadius * closeBubbleDirection,
-          rotationAngle, staticBubble->GetCenter());
-    } else {
-      freeSlotCenter = rotateVector(
-          staticBubble->GetCenter() + 2 * kBubbleRadius * closeBubbleDirection,
-          -rotationAngle, staticBubble->GetCenter());
-    }
-    // Get the weight of the free slot
-    float weight =
-        GetFreeSlotWeight(bubble->GetColorWithoutAlpha(), freeSlotCenter);
-
-    // If the weight is greater than the highest weight, then we update the
-    // highest weight and the free slot center.
-    if (weight > highestWeight) {
-      highestWeight = weight;
-      bestFreeSlotCenter = freeSlotCenter;
-    }
-  }
-
-  // If the highest weight is greater than 0, then we move the bubble to the
-  // best free slot center.
-  if (highestWeight > 0.0f) {
-    bubble->SetPosition(bestFreeSlotCenter -
-                        glm::vec2(kBubbleRadius, kBubbleRadius));
-    return true;
-  }
-
-  // No fine tuning happaned.
-  return false;
-}
-
-std::vector<int> GameManager::FindConnectedBubblesOfSameColor(int bubbleId) {
-  // bubble should be in the statics.
-  assert(statics.count(bubbleId) > 0 && "Failed to find the bubble by ID.");
-  std::vector<int> connectedBubbleIds;
-  // Get the color of the bubble
-  glm::vec3 color = statics[bubbleId]->GetColorWithoutAlpha();
-  // Use BFS to find all connected bubbles of the same color
-  std::queue<int> q;
-  q.emplace(bubbleId);
-  while (!q.empty()) {
-    int currentId = q.front();
-    q.pop();
-    // If the current id already exists in the connected bubble ids, then we
-    // skip it.
-    if (std::find(connectedBubbleIds.begin(), connectedBubbleIds.end(),
-                  currentId) != connectedBubbleIds.end()) {
-      continue;
-    }
-    connectedBubbleIds.push_back(currentId);
-    // Get the neighbors of the current bubble
-    std::vector<int> neighborIds = GetNeighborIds(statics[currentId]);
-    for (auto& neighborId : neighborIds) {
-      // If the neighbor has the same color as the bubble and it is not in the
-      // connected bubble ids, then we add it to the queue.
-      if (isSameColor(color, statics[neighborId]->GetColorWithoutAlpha())) {
-        q.emplace(neighborId);
-      }
-    }
-  }
-  return connectedBubbleIds;
+  return board.IsAtUpperBoundary(pos, gameBoard->GetValidPosition().y);
 }
 
 std::vector<int> GameManager::IsCollidingWithStaticBubbles(
     std::unique_ptr<Bubble>& bubble) {
   std::vector<int> ids;
-  for (auto& other : statics) {
-    if (areFloatsEqual(
-            glm::distance(bubble->GetCenter(), other.second->GetCenter()),
-            2 * kBubbleRadius)) {
-      ids.push_back(other.first);
+  // The bubble touches the static bubbles whose centers are two radii away
+  // from its center, within the tolerance of areFloatsEqual. The centers of
+  // the static bubbles are relative to the static origin.
+  circleIndices.resize(bubbles.Size());
+  size_t numIndices = findCentersInRange(
+      bubbles.GetCenters().data(), bubbles.Size(),
+      bubble->GetCenter() - bubbles.GetStaticOrigin(),
+      2 * kBubbleRadius - 1e-4f, 2 * kBubbleRadius + 1e-4f,
+      circleIndices.data());
+  for (size_t i = 0; i < numIndices; ++i) {
+    int index = circleIndices[i];
+    if (bubbles.GetStates()[index] == BubbleState::Static) {
+      ids.push_back(bubbles.GetIds()[index]);
     }
   }
   return ids;
@@ -4569,8 +4273,7 @@ std::vector<int> GameManager::IsCollidingWithStaticBubbles(
 
 bool GameManager::IsNeighbor(glm::vec2 bubbleCenter, glm::vec2 slotCenter,
                              float absError) {
-  return areFloatsEqual(glm::distance(bubbleCenter, slotCenter),
-                        2 * kBubbleRadius, absError);
+  return board.IsNeighbor(bubbleCenter, slotCenter, absError);
 }
 
 std::vector<glm::vec2> GameManager::GetCommonFreeSlots(
@@ -4598,7 +4301,7 @@ std::vector<glm::vec2> GameManager::GetCommonFreeSlots(
   for (auto& slot : candidateFreeSlots) {
     bool common = true;
     for (auto& id : bubbleIds) {
-      if (!IsNeighbor(statics[id]->GetCenter(), slot)) {
+      if (!IsNeighbor(bubbles.GetCenter(id), slot)) {
         common = false;
         break;
       }
@@ -4610,346 +4313,89 @@ std::vector<glm::vec2> GameManager::GetCommonFreeSlots(
   return commonFreeSlots;
 }
 
-float GameManager::GetFreeSlotWeight(glm::vec3 color, glm::vec2 slotCenter) {
-  // Check if the free slot is outside the boundaries of the game board.
-  auto boundaries = gameBoard->GetBoundaries();
-  if (areFloatsLess(slotCenter.x - kBubbleRadius, boundaries[0]) ||
-      areFloatsGreater(slotCenter.x + kBubbleRadius, boundaries[2]) ||
-      areFloatsLess(slotCenter.y - kBubbleRadius, boundaries[1]) ||
-      areFloatsGreater(slotCenter.y + kBubbleRadius, boundaries[3])) {
-    return -1.0f;
-  }
-
-  // First check if the slot is already occupied by a static bubble. That case,
-  // the distance between the slot center and the center of the static bubble is
-  // less than 2*kBubbleRadius.
-  for (auto& other : statics) {
-    if (glm::distance(slotCenter, other.second->GetCenter()) <
-        2 * kBubbleRadius - 1.0f) {
-      // return -1.0f to indicate that the slot is not free.
-      return -1.0f;
-    }
-  }
-
-  float weight = 0.0f;
-  for (auto& other : statics) {
-    if (IsNeighbor(other.second->GetCenter(), slotCenter)) {
-      if (isSameColor(other.second->GetColorWithoutAlpha(), color)) {
-        weight += 1.0f;
-      } else {
-        weight += 0.1f;
-      }
-    }
-  }
+LevelGenerationParams GameManager::GetLevelGenerationParams(int level) {
+  LevelGenerationParams params;
+  params.level = level;
+  params.bubbleRadius = getBubbleRadiusForLevel(level, kBaseUnit);
+  params.gameLevel = makeGameLevel(level, this->difficulty, kBaseUnit);
 
-  // incrase weight if it's at the upper boundary
-  if (IsAtUpperBoundary(slotCenter - glm::vec2(kBubbleRadius, kBubbleRadius))) {
-    weight += 1.0f;
-  }
+  // Get the boundaries of the game board (left, upper, right, lower)
+  params.boundaries =
+      glm::vec4(gameBoard->GetPosition().x, gameBoard->GetPosition().y,
+                gameBoard->GetPosition().x + gameBoard->GetSize().x,
+                gameBoard->GetPosition().y + gameBoard->GetSize().y);
 
-  return weight;
+  // The level starts with the game board fully open. The upper boundary has
+  // moved down by the offset of the valid position and the shooter has moved
+  // up by the same offset, so it is moved back down by all of it, as Update
+  // does once the bubbles are placed.
+  glm::vec2 narrowingOffset =
+      gameBoard->GetValidPosition() - gameBoard->GetPosition();
+  params.shooterCenter =
+      this->shooter->GetCarriedBubble().GetCenter() + narrowingOffset;
+
+  params.seed = generateRandomInt<unsigned int>(
+      0, std::numeric_limits<unsigned int>::max(), RandomStream::kLevel);
+  return params;
 }
 
-std::vector<glm::vec2> GameManager::GetPotentialNeighborFreeSlots(
-    glm::vec2 bubbleCenter) {
-  std::vector<glm::vec2> neighborCenters;
-  // The angle between two neighbors is mutiple of 30 degrees.
-  constexpr float angle = glm::radians(30.0f);
-  float totalNeighborNum = std::round(2 * glm::pi<float>() / angle);
-  // The first neighbor is the right neighbor.
-  glm::vec2 rightNeighbor = bubbleCenter + glm::vec2(2 * kBubbleRadius, 0.0f);
-  neighborCenters.emplace_back(rightNeighbor);
-
-  // Get the other 5 neighbors
-  for (size_t neighborNum = 1; neighborNum < totalNeighborNum; ++neighborNum) {
-    glm::vec2 neighborCenter =
-        rotateVector(rightNeighbor, angle * neighborNum, bubbleCenter);
-    neighborCenters.emplace_back(neighborCenter);
-  }
-
-  // Remove the neighbors that are outside the boundaries
-  auto boundaries = gameBoard->GetBoundaries();
-  for (auto it = neighborCenters.begin(); it != neighborCenters.end();) {
-    bool lessThenXBegin = areFloatsLess(it->x - kBubbleRadius, boundaries[0]);
-    bool greaterThenXEnd =
-        areFloatsGreater(it->x + kBubbleRadius, boundaries[2]);
-    bool lessThenYBegin = areFloatsLess(it->y - kBubbleRadius, boundaries[1]);
-    bool greaterThenYEnd =
-        areFloatsGreater(it->y + kBubbleRadius, boundaries[3]);
-    if (lessThenXBegin || greaterThenXEnd || lessThenYBegin ||
-        greaterThenYEnd) {
-      it = neighborCenters.erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  // Remove the neighbors that are overlapping with the static bubbles
-  for (auto it = neighborCenters.begin(); it != neighborCenters.end();) {
-    bool overlap = false;
-    for (auto& [id, bubble] : statics) {
-      if (areFloatsLess(glm::distance(*it, bubble->GetCenter()),
-                        2 * kBubbleRadius)) {
-        overlap = true;
-        break;
-      }
-    }
-    if (overlap) {
-      it = neighborCenters.erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  return neighborCenters;
+void GameManager::StartGeneratingLevelLayout(int level) {
+  JoinLevelGenerationThread();
+  hasNextLevelLayout = false;
+  nextLevelDifficulty = this->difficulty;
+  isNextLevelLayoutReady.store(false, std::memory_order_relaxed);
+  // The generation works on a copy of the parameters and only writes the next
+  // level layout, which is not read until the ready flag is set.
+  LevelGenerationParams params = GetLevelGenerationParams(level);
+  levelGenerationThreadId = ThreadHandler::GetInstance().CreateThread(
+      [this, params]() {
+        nextLevelLayout = LevelGenerator(params).Generate();
+        isNextLevelLayoutReady.store(true, std::memory_order_release);
+      });
 }
 
-void GameManager::UpdateFreeSlots(std::unique_ptr<Bubble>& bubble,
-                                  float minDistanceToBottom,
-                                  float minHorizontalDistanceToShooter,
-                                  float minVerticalDistanceToShooter) {
-  // Get the center of the bubble
-  glm::vec2 bubbleCenter = bubble->GetCenter();
-  // Remove the free slots whose distance to the bubble center is less than
-  // 2*kBubbleRadius.
-  freeSlots.erase(std::remove_if(freeSlots.begin(), freeSlots.end(),
-                                 [&](glm::vec2 slotCenter) {
-                                   return glm::distance(slotCenter,
-                                                        bubbleCenter) <
-                                          2 * kBubbleRadius;
-                                 }),
-                  freeSlots.end());
-
-  // Get potential free slots
-  std::vector<glm::vec2> potentialFreeSlots =
-      GetPotentialNeighborFreeSlots(bubble->GetCenter());
-
-  // Remove the potential free slots whose distance to the shooter is less than
-  // minDistanceToShooter and whose distance to the bottom is less than
-  // minDistanceToBottom.
-  glm::vec2 shooterCenter = this->shooter->GetCarriedBubble().GetCenter();
-  float gameBoardBottomBound = this->gameBoard->GetBoundaries()[3];
-  Ellipse ellipse(shooterCenter, minHorizontalDistanceToShooter,
-                  minVerticalDistanceToShooter);
-  potentialFreeSlots.erase(
-      std::remove_if(potentialFreeSlots.begin(), potentialFreeSlots.end(),
-                     [&](glm::vec2 slotCenter) {
-                       return slotCenter.y >
-                                  gameBoardBottomBound - minDistanceToBottom ||
-                              ellipse.isWithin(slotCenter);
-                     }),
-      potentialFreeSlots.end());
-
-  // Add the potential free slots to the free slots if they are not in free
-  // slots.
-  for (auto& center1 : potentialFreeSlots) {
-    bool alreadyInFreeSlots = false;
-    for (auto& center2 : freeSlots) {
-      if (areFloatsEqual(glm::distance(center1, center2), 0.0f)) {
-        alreadyInFreeSlots = true;
-        break;
-      }
-    }
-    if (!alreadyInFreeSlots) {
-      freeSlots.emplace_back(center1);
-    }
+void GameManager::JoinLevelGenerationThread() {
+  if (!levelGenerationThreadId.has_value()) {
+    return;
   }
+  ThreadHandler::GetInstance().JoinThread(levelGenerationThreadId.value());
+  levelGenerationThreadId.reset();
+  hasNextLevelLayout = true;
 }
 
-void GameManager::GenerateRandomStaticBubblesHelper(GameLevel gameLevel) {
-  // Randomly get N colors from the color map
-  std::vector<int> colorSet;
-  for (auto& [colorEnum, colorVal] : colorMap) {
-    colorSet.push_back(static_cast<int>(colorEnum));
-  }
-  std::vector<glm::vec3> colorPool;
-  for (int i = 0; i < gameLevel.numColors; ++i) {
-    int randomIndex = generateRandomInt<int>(0, colorSet.size() - 1);
-    colorPool.push_back(colorMap[static_cast<Color>(colorSet[randomIndex])]);
-    colorSet.erase(colorSet.begin() + randomIndex);
-  }
-
-  glm::vec2 centerForNewBubble(-1.f, -1.f);
-  std::vector<int> addedBubbleIds;
-  int lastAddedBubbleID = -1;
-
-  //// Record the number of bubbles of each color. The key is the index of the
-  /// color in the color pool and the value is the number of bubbles of that
-  /// color.
-  // std::unordered_map<int, int> colorCount;
-
-  // Generate bubble one by one
-  for (int i = 0; i < gameLevel.numInitialBubbles; ++i) {
-    bool hasExistingBubble = !statics.empty();
-    bool toBeNeighborOfBubble =
-        randomBool(gameLevel.probabilityNewBubbleIsNeighborOfBubble) &&
-        hasExistingBubble;
-    bool toBeNeighborOfLastAdded =
-        randomBool(gameLevel.probabilityNewBubbleIsNeighborOfLastAdded) &&
-        toBeNeighborOfBubble;
-    bool toBeNeighborOfBubbleOfSameColor =
-        randomBool(
-            gameLevel.probabilityNewBubbleIsNeighborOfBubbleOfSameColor) &&
-        toBeNeighborOfBubble;
-    // toBeNeighborOfBubble = false;
-    // toBeNeighborOfLastAdded = false;
-    // toBeNeighborOfBubbleOfSameColor = false;
-    if (toBeNeighborOfLastAdded) {
-      assert(lastAddedBubbleID != -1 && "Have not added any bubble yet.");
-      // Get potential neighbors of the last added bubble
-      std::vector<glm::vec2> lastAddedFreeSlots;
-      lastAddedFreeSlots = GetPotentialNeighborFreeSlots(
-          statics[lastAddedBubbleID]->GetCenter());
-      while (lastAddedFreeSlots.empty()) {
-        addedBubbleIds.pop_back();
-        assert(!addedBubbleIds.empty() &&
-               "There should always be a static bubble that has available "
-               "neighbor free slots.");
-        lastAddedBubbleID = addedBubbleIds.back();
-        lastAddedFreeSlots = GetPotentialNeighborFreeSlots(
-            statics[lastAddedBubbleID]->GetCenter());
-      }
-      // Get the common free slots of the last added free slots and the
-      // available free slots.
-      std::vector<glm::vec2> commonFreeSlots =
-          GetCommonFreeSlots(lastAddedFreeSlots, freeSlots);
-      if (commonFreeSlots.empty()) {
-        // If there is no common free slot, then we simply choose a free slot
-        // that is a neighbor of a bubble;
-        do {
-          int randomIndex = rand() % freeSlots.size();
-          centerForNewBubble = freeSlots[randomIndex];
-        } while (!IsNeighborOfStaticBubbles(centerForNewBubble));
-      } else {
-        //  Randomly select a free slot from the common free slots.
-        int randomIndex = rand() % commonFreeSlots.size();
-        centerForNewBubble = commonFreeSlots[randomIndex];
-      }
-    } else if (toBeNeighborOfBubble) {
-      // Randomly select a free slot that is a neighbor of an existing static
-      // bubble.
-      do {
-        int randomIndex = rand() % freeSlots.size();
-        centerForNewBubble = freeSlots[randomIndex];
-      } while (!IsNeighborOfStaticBubbles(centerForNewBubble));
-    } else {
-      // Randomly select a free slot from the provided free slots.
-      int randomIndex = rand() % freeSlots.size();
-      centerForNewBubble = freeSlots[randomIndex];
+bool GameManager::IsLevelLayoutReady() {
+  if (levelGenerationThreadId.has_value()) {
+    // Wait for the generating thread in later frames.
+    if (!isNextLevelLayoutReady.load(std::memory_order_acquire)) {
+      return false;
     }
-
-    // Create a new bubble
-    std::unique_ptr<Bubble> newBubble = std::make_unique<Bubble>(
-        centerForNewBubble - glm::vec2(kBubbleRadius, kBubbleRadius),
-        kBubbleRadius, glm::vec2(0.0f, 0.0f),
-        glm::vec4(colorPool[rand() % colorPool.size()], 0.8),
-        ResourceManager::GetInstance().GetTexture("bubble"));
-
-    if (toBeNeighborOfBubbleOfSameColor) {
-      // Get the ids of the bubbles that are neighbors of the new bubble.
-      std::vector<int> neighborIds = GetNeighborIds(newBubble);
-      assert(!neighborIds.empty() && "Failed to get neighbor ids");
-      // Randomly select a neighbor and set the color of the new bubble to the
-      // color of the selected neighbor.
-      int randomIndex = rand() % neighborIds.size();
-      // Get the color of the selected neighbor.
-      glm::vec4 color = statics[neighborIds[randomIndex]]->GetColor();
-      // Set the color of the new bubble to the color of the selected neighbor.
-      newBubble->SetColor(color);
-    }
-    // Set the last added bubble id to the id of the new bubble.
-    lastAddedBubbleID = newBubble->GetID();
-
-    // Add the new bubble to the static bubbles.
-    statics[lastAddedBubbleID] = std::move(newBubble);
-
-    // Update the free slots
-    UpdateFreeSlots(statics[lastAddedBubbleID], gameLevel.minDistanceToBottom,
-                    gameLevel.minHorizontalDistanceToShooter,
-                    gameLevel.minVerticalDistanceToShooter);
-
-    // Memorize the id of the new bubble
-    addedBubbleIds.emplace_back(lastAddedBubbleID);
-
-    // Update the color count
-    ++colorCount[statics[lastAddedBubbleID]->GetColorEnum()];
+    JoinLevelGenerationThread();
+  }
+  // The layout is generated ahead of time, so it may be outdated if the level
+  // has been failed or the difficulty has been changed since.
+  if (hasNextLevelLayout && nextLevelLayout.level == this->level &&
+      nextLevelDifficulty == this->difficulty) {
+    return true;
   }
+  StartGeneratingLevelLayout(this->level);
+  return false;
 }
 
 void GameManager::GenerateRandomStaticBubbles() {
-  // The radius of the bubble decreases as per 10 levels.
-  kBubbleRadius = kBaseUnit * std::pow(0.9f, (level - 1) / 10);
-
-  // Update the game level
-  gameLevel.numColors =
-      level < colorMap.size() ? std::sqrt(level * 4.f - 3.f) : colorMap.size();
-  gameLevel.numInitialBubbles = GetBubbleNumForLevel();
-  gameLevel.minDistanceToBottom = 4 * kBaseUnit + kBubbleRadius;
-  gameLevel.minHorizontalDistanceToShooter = 3 * kBaseUnit + kBubbleRadius;
-  gameLevel.minVerticalDistanceToShooter = 6 * kBaseUnit;
-  float difficultyScalingFactor = 0.75f;
-  switch (this->difficulty) {
-    case Difficulty::MEDIUM:
-      difficultyScalingFactor += 0.03f;
-      break;
-    case Difficulty::HARD:
-      difficultyScalingFactor += 0.06f;
-      break;
-    case Difficulty::EXPERT:
-      difficultyScalingFactor += 0.09f;
-      break;
-    default:
-      break;
-  }
-  gameLevel.probabilityNewBubbleIsNeighborOfLastAdded =
-      1.f - difficultyScalingFactor / GetNumGameLevels() * level;
-  gameLevel.probabilityNewBubbleIsNeighborOfBubble =
-      1.f - difficultyScalingFactor / GetNumGameLevels() * level;
-  gameLevel.probabilityNewBubbleIsNeighborOfBubbleOfSameColor =
-      1.f - difficultyScalingFactor / GetNumGameLevels() * level;
-
-  float baseTime = 9.f, initialTime = 18.f;
-  switch (this->difficulty) {
-    case Difficulty::MEDIUM:
-      initialTime -= 1.f;
-      break;
-    case Difficulty::HARD:
-      baseTime -= 1.f;
-      initialTime -= 2.f;
-      break;
-    case Difficulty::EXPERT:
-      baseTime -= 2.f;
-      initialTime -= 3.f;
-      break;
-  }
-  gameLevel.narrowingTimeInterval =
-      glm::mix(initialTime, baseTime, (level - 1) * 1.f / GetNumGameLevels());
-
-  // Get the boundaries of the game board (left, upper, right, lower)
-  glm::vec4 boundaries =
-      glm::vec4(gameBoard->GetPosition().x, gameBoard->GetPosition().y,
-                gameBoard->GetPosition().x + gameBoard->GetSize().x,
-                gameBoard->GetPosition().y + gameBoard->GetSize().y);
-
-  // generate random static bubble either on the top or as the neighbor of an
-  // existing static bubble.
-  freeSlots.clear();
-
-  // First get all the free slots on the top of the game board.
-  for (float x = boundaries.x + kBubbleRadius;
-       !areFloatsGreater(x, boundaries.z - kBubbleRadius); x += kBubbleRadius) {
-    freeSlots.emplace_back(x, boundaries.y + kBubbleRadius);
-  }
-
-  // Use a random number engine with a seed based on the current time
-  auto rng = std::default_random_engine(
-      std::chrono::system_clock::now().time_since_epoch().count());
-
-  // Shuffle the free slots
-  std::shuffle(freeSlots.begin(), freeSlots.end(), rng);
+  assert(hasNextLevelLayout && nextLevelLayout.level == this->level &&
+         "The layout of the level has not been generated.");
+  kBubbleRadius = nextLevelLayout.bubbleRadius;
+  gameLevel = nextLevelLayout.gameLevel;
+
+  board.Resize(gameBoard->GetBoundaries(), kBubbleRadius);
+  board.LoadLayout(nextLevelLayout);
+  // Update the color count
+  bubbles.ForEach(BubbleState::Static,
+                  [&](int id) { ++colorCount[toIndex(bubbles.GetColor(id))]; });
+  // The layout is consumed.
+  hasNextLevelLayout = false;
 
   this->shooter->UpdateCarriedBubbleRadius(kBubbleRadius);
-  GenerateRandomStaticBubblesHelper(gameLevel);
 }
 
 float GameManager::GetNarrowingTimeInterval() {
@@ -4968,60 +4414,41 @@ float GameManager::GetNarrowingTimeInterval() {
   return this->gameLevel.narrowingTimeInterval;
 }
 
-std::vector<glm::vec2> GameManager::GetCommonFreeSlots(
-    std::vector<glm::vec2> freeSlots1, std::vector<glm::vec2> freeSlots2) {
-  std::vector<glm::vec2> commonFreeSlots;
-  for (auto& slot1 : freeSlots1) {
-    for (auto& slot2 : freeSlots2) {
-      if (areFloatsEqual(slot1.x, slot2.x) &&
-          areFloatsEqual(slot1.y, slot2.y)) {
-        commonFreeSlots.push_back(slot2);
-      }
-    }
-  }
-  return commonFreeSlots;
-}
-
 bool GameManager::IsNeighborOfStaticBubbles(glm::vec2 freeSlotCenter) {
-  for (auto& [id, bubble] : statics) {
-    if (IsNeighbor(bubble->GetCenter(), freeSlotCenter)) {
-      return true;
-    }
-  }
-  return false;
+  return !GetNeighborIds(freeSlotCenter).empty();
 }
 
 glm::vec4 GameManager::GetNextBubbleColor() {
   // If statics is empty, then we randomly select a color from the color map.
-  if (statics.empty()) {
+  if (bubbles.Count(BubbleState::Static) == 0) {
     // Get a random color from Color predefined in the resource manager
-    int randomColorIdx =
-        generateRandomInt<int>(0, static_cast<int>(colorMap.size()) - 1);
+    int randomColorIdx = generateRandomInt<int>(0, kNumColors - 1);
     Color randomColor = static_cast<Color>(randomColorIdx);
     // Set the color
-    return glm::vec4(colorMap[randomColor], 0.8);
+    return glm::vec4(toRgb(randomColor), kBubbleAlpha);
   }
   // If statics is not empty, then we determine the new color based on the count
   // of bubbles of each color.
   else {
     std::vector<Color> colors;
     std::vector<float> weights;
-    int sum = 0;
-    for (const auto& [color, count] : colorCount) {
-      sum += count;
+    for (int i = 0; i < kNumColors; ++i) {
+      int count = colorCount[i];
       assert(count >= 0 && "Color count should be non-negative.");
-      colors.emplace_back(color);
-      weights.emplace_back(static_cast<float>(count) * colorWeight.at(color));
+      if (count > 0) {
+        colors.emplace_back(static_cast<Color>(i));
+        weights.emplace_back(static_cast<float>(count) * colorWeight[i]);
+      }
     }
     // Determine the new color based on the counts of bubbles of each color
     // using random weighted selection.
     int randomIndex = randomWeightedSelect(weights);
-    return glm::vec4(colorMap[colors[randomIndex]], 0.8);
+    return glm::vec4(toRgb(colors[randomIndex]), kBubbleAlpha);
   }
 }
 
 void GameManager::AdjustButtonsHorizontalPosition(
-    const std::vector<std::string>& buttonName, float interval) {
+    const std::vector<StringId>& buttonName, float interval) {
   if (buttonName.empty()) {
     return;
   }
@@ -5057,19 +4484,13 @@ bool GameManager::IsLevelFailed() {
   // Get the radius and center of the carried bubble
   float radius = carriedBubble.GetRadius();
   glm::vec2 center = carriedBubble.GetCenter();
-  // If part of the carried bubble is outside the actual upper boundary of the
-  // game board, then the current level is failed.
-  if (areFloatsLess(center.y - radius, gameBoard->GetValidPosition().y)) {
+  // The level is failed if the carried bubble sticks out of the actual upper
+  // boundary of the game board or overlaps the static bubbles. The headless
+  // game shares the rule.
+  if (board.HasReachedShooter(center, radius,
+                              gameBoard->GetValidPosition().y)) {
     return isLevelFailed = true;
   }
-  // If the carried bubble is overlapping with the static bubbles, then the
-  // current level is failed.
-  for (auto& [id, bubble] : statics) {
-    if (glm::distance(center, bubble->GetCenter()) <
-        radius + bubble->GetRadius()) {
-      return isLevelFailed = true;
-    }
-  }
   return false;
 }
 
@@ -5083,16 +4504,17 @@ std::shared_ptr<OptionUnit> GameManager::CreateClickableOptionUnit(
       /*texture=*/ResourceManager::GetInstance().GetTexture("bubble"),
       this->spriteRenderer);
   // Create the text unit
-  texts[name] = std::make_shared<Text>(
+  std::shared_ptr<Text>& optionText = texts[StringId(name)];
+  optionText = std::make_shared<Text>(
       /*pos=*/glm::vec2(0.f),
       /*lineWidth=*/gameBoard->GetSize().x - kBaseUnit);
-  texts[name]->AddParagraph(text);
-  texts[name]->SetScale(0.0018f * imageUnit->GetHeight());
+  optionText->AddParagraph(text);
+  optionText->SetScale(0.0018f * imageUnit->GetHeight());
   if (textRenderer == nullptr) {
     textRenderer = this->GetTextRenderer();
   }
   std::shared_ptr<TextUnit> textUnit =
-      std::make_shared<TextUnit>(name, texts.at(name), textRenderer);
+      std::make_shared<TextUnit>(name, optionText, textRenderer);
   // Create the option unit
   std::shared_ptr<OptionUnit> optionUnit = std::make_shared<OptionUnit>(
       name, imageUnit, textUnit, OptionState::kNormal);
@@ -5158,29 +4580,13 @@ void GameManager::ResetGameCharacters() {
 
 int GameManager::CalculateScore(int numBubbles, float bubbleRadius,
                                 BubbleState bubbleType, float timeUsed) {
-  float score = 40.f - 0.5f * bubbleRadius +
-                0.5f * this->level * std::sqrt(this->level) -
-                timeUsed / std::sqrt(this->gameLevel.numInitialBubbles);
-  if (score < 0.f) {
-    // Map (-inf, 0) to (0, 1).
-    score = std::exp(score);
-  } else {
-    // Map [0, inf) to [1, inf).
-    ++score;
-  }
-  if (bubbleType == BubbleState::Falling) {
-    score *= 1.5f;
-  }
   int totalIncrement = 0;
-  for (int i = 0; i < numBubbles; ++i) {
-    if (i > 2) {
-      score *= 1.2f;
-    }
-    scoreIncrements.push(static_cast<int>(std::ceil(score)));
-    totalIncrement += scoreIncrements.back();
+  for (int scoreIncrement : calculateScoreIncrements(
+           numBubbles, bubbleRadius, bubbleType == BubbleState::Falling,
+           this->level, this->gameLevel.numInitialBubbles, timeUsed)) {
+    scoreIncrements.push(scoreIncrement);
+    totalIncrement += scoreIncrement;
   }
-  // score *= numBubbles + 0.1f * (numBubbles - 2) * (numBubbles - 3);
-  // scoreIncrements.push_back(static_cast<int>(std::ceil(score)));
   return totalIncrement;
 }
 
@@ -5217,12 +4623,14 @@ void GameManager::ResetScore(int64_t value) {
   numOfScoreIncrementsReady = 0;
 
   // Clean the score increment event
-  if (this->timer->HasEvent("refreshscore")) {
-    this->timer->CleanEvent("refreshscore");
+  if (this->timer->HasEvent(kRefreshScoreEvent)) {
+    this->timer->CleanEvent(kRefreshScoreEvent);
   }
 }
 
 void GameManager::ClearResources() {
+  // Wait for the background level generation
+  JoinLevelGenerationThread();
   // Clear text characters texClearResources()tures
   for (auto textureID : TextRenderer::characterMap) {
     glDeleteTextures(1, &textureID.second[CharStyle::REGULAR].TextureID);
@@ -3,12 +3,16 @@
 #include <glfw3.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <bit>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <glm/glm.hpp>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <random>
 #include <set>
@@ -18,15 +22,18 @@
 
 #include "Arrow.h"
 #include "Bubble.h"
+#include "BubbleBoard.h"
 #include "Button.h"
 #include "CJTextRenderer.h"
 #include "Capsule.h"
+#include "CircleKernels.h"
 #include "CircleRenderer.h"
 #include "ColorRenderer.h"
 #include "ConfigManager.h"
 #include "ExplosionSystem.h"
 #include "GameBoard.h"
 #include "GameCharacter.h"
+#include "LevelGenerator.h"
 #include "LineRenderer.h"
 #include "Page.h"
 #include "PartialTextureRenderer.h"
@@ -35,14 +42,18 @@
 #include "RayRenderer.h"
 #include "ResourceManager.h"
 #include "ScissorBoxHandler.h"
+#include "Scoring.h"
 #include "Scroll.h"
 #include "ShadowTrailSystem.h"
 #include "Shooter.h"
+#include "Snapshot.h"
 #include "SoundEngine.h"
 #include "SpriteDynamicRenderer.h"
 #include "SpriteRenderer.h"
+#include "StringId.h"
 #include "Text.h"
 #include "TextRenderer.h"
+#include "ThreadHandler.h"
 #include "Timer.h"
 #include "WesternTextRenderer.h"
 
@@ -69,29 +80,31 @@ enum class GameState {
 // Transition between states
 enum class TransitionState { START, TRANSITION, END };
 
-struct GameLevel {
-  // Num of colors
-  int numColors{};
-  // The number of bubbles that are generated at the beginning of the game
-  int numInitialBubbles{};
-  // The least distance between the bubble and the bottom of the game board
-  float minDistanceToBottom{};
-  // The parameters for the ellipse centered at the shooter and the new bubble
-  // should be generated outside of it.
-  float minHorizontalDistanceToShooter{}, minVerticalDistanceToShooter{};
-  // Probability that a new bubble is generated adjacent to the most recently
-  // added bubble
-  float probabilityNewBubbleIsNeighborOfLastAdded{};
-  // Probability that a new bubble is generated as a neighbor of an existing
-  // bubble
-  float probabilityNewBubbleIsNeighborOfBubble{};
-  // Probability that a new bubble is generated as a neighbor of an existing
-  // bubble of the same color
-  float probabilityNewBubbleIsNeighborOfBubbleOfSameColor{};
-  // possibility that the new bubble is new color compared to the last bubble
-  float probabilityNewBubbleIsNewColor{};
-  // time interval for narrowing the game board vertically
-  float narrowingTimeInterval{};
+// Timed events of the game. They are the handles of the events on the timer.
+enum TimerEvent {
+  kSplashEvent,
+  kIntroEvent,
+  kIntroFadeOutEvent,
+  kDeblurringEvent,
+  kScrollReadyToOpenEvent,
+  kScrollInSleeveEvent,
+  kScrollHittingEvent,
+  kScrollVibrateEvent,
+  kHittingWallEvent,
+  kBeforeNarrowingEvent,
+  kPlayTimeEvent,
+  kFireArrowEvent,
+  kGuojieShakingEvent,
+  kCracksEvent,
+  kCracksFadingEvent,
+  kRefreshScoreEvent,
+  kReduceFlipVolumeEvent,
+  kDisplayScoreEvent,
+  kPromptToMainMenuEvent,
+  kHidePromptToMainMenuEvent,
+  kBeforeGraduallyClearEvent,
+  kWhiteNoiseEvent,
+  kSplashEndEvent,
 };
 
 struct GameStateSnapshot {
@@ -118,6 +131,9 @@ class GameManager {
   bool isReadyToDrag{true};
   bool isDragging{false};
   bool gameArenaShaking{false};
+  // Whether the vibrating sound of the scroll has been played and not faded
+  // out yet. The sound follows the simulation instead of its playback.
+  bool isScrollVibrateSoundOn{false};
   float scrollYOffset{0.f};
   float scrollSensitivity{25.f};
   float mouseX{0.f}, mouseY{0.f}, mouseLastX{0.f}, mouseLastY{0.f};
@@ -139,9 +155,30 @@ class GameManager {
   void Init();
   void LoadSounds();
   void LoadStreams();
+  // Apply the input fed through the GLFW callbacks. The cursor position is in
+  // the virtual screen.
+  void OnKey(int key, int action);
+  void OnMouseButton(int button, int action);
+  void OnCursorPosition(float virtualX, float virtualY);
+  void OnScroll(float yOffset);
+  // Hash the game board together with the state, level, score and combo of the
+  // game, to check that a replay ends where its recording did.
+  uint64_t GetStateHash() const;
+  // Write the level in play to a binary snapshot: the board, the moving
+  // bubbles, the shooter, the power-up, the health of the characters, the
+  // timers, the random number generators, the parameters and bubble radius of
+  // the level and the geometry of the scroll. A snapshot can only be loaded
+  // into a game that is in the state it was taken in, whose pages and entities
+  // are set up already. Return false if the snapshot cannot be loaded, in
+  // which case the game is left as it was.
+  std::vector<uint8_t> SaveSnapshot() const;
+  bool LoadSnapshot(const std::vector<uint8_t>& snapshot);
   void ProcessInput(float dt);
   void Update(float dt);
-  void Render();
+  // Render the game. alpha is the fraction of a time step that has passed
+  // since the last update, by which the moving and falling bubbles are drawn
+  // between their previous and current positions.
+  void Render(float alpha = 1.f);
   GameStateSnapshot PrepareToReload();
   void Reload(const GameStateSnapshot& snapshot);
 
@@ -174,20 +211,20 @@ class GameManager {
   std::unique_ptr<ExplosionSystem> explosionSystem;
 
   // Characters
-  std::unordered_map<std::string, std::shared_ptr<GameCharacter>>
-      gameCharacters;
+  std::unordered_map<StringId, std::shared_ptr<GameCharacter>> gameCharacters;
 
   // Bubbbles that are moving.
   std::unordered_map<int, std::unique_ptr<Bubble>> moves;
+  // Positions of the moving bubbles before the last update.
+  std::unordered_map<int, glm::vec2> previousMovePositions;
 
-  // Bubbles that are static.
-  std::unordered_map<int, std::unique_ptr<Bubble>> statics;
-
-  // Bubbles that are falling.
-  std::unordered_map<int, std::unique_ptr<Bubble>> fallings;
-
-  // Bubbles that are exploding.
-  std::unordered_map<int, std::unique_ptr<Bubble>> explodings;
+  // The board simulation, which holds the bubbles that are static, falling or
+  // exploding and the grid of the static bubbles.
+  BubbleBoard board;
+  // The bubble store of the board.
+  BubbleStore& bubbles{board.GetStore()};
+  // Indices into the bubble store written by the circle kernels.
+  std::vector<int> circleIndices;
 
   // Stores individual scores gained during game play.
   std::queue<int> scoreIncrements;
@@ -205,10 +242,10 @@ class GameManager {
   std::vector<std::shared_ptr<Arrow>> arrows;
 
   // Texts
-  std::unordered_map<std::string, std::shared_ptr<Text>> texts;
+  std::unordered_map<StringId, std::shared_ptr<Text>> texts;
 
   // Buttons
-  std::unordered_map<std::string, std::shared_ptr<Button>> buttons;
+  std::unordered_map<StringId, std::shared_ptr<Button>> buttons;
 
   // Pages
   std::unordered_map<std::string, std::unique_ptr<Page>> pages;
@@ -216,17 +253,26 @@ class GameManager {
   // Active page
   std::string activePage{""};
 
-  // Free slots on the game board.
-  std::vector<glm::vec2> freeSlots;
+  // Layout of the level generated in the background.
+  LevelLayout nextLevelLayout;
+
+  // Difficulty the next level layout is generated for.
+  Difficulty nextLevelDifficulty{Difficulty::UNDEFINED};
+
+  // Id of the thread generating the next level layout.
+  std::optional<std::thread::id> levelGenerationThreadId;
+
+  // Whether the generating thread has finished writing the next level layout.
+  std::atomic<bool> isNextLevelLayoutReady{false};
+
+  // Whether the next level layout holds a generated level.
+  bool hasNextLevelLayout{false};
 
   // Count of bubbles of each color.
-  std::unordered_map<Color, int> colorCount;
+  ColorArray<int> colorCount{};
 
   // Weight of bubbles of each color.
-  std::unordered_map<Color, float> colorWeight;
-
-  // original positions for shaking.
-  std::unordered_map<std::string, glm::vec2> originalPositionsForShaking;
+  ColorArray<float> colorWeight{};
 
   // objects that gradually become transparent. strucutre: <object name,
   // <object, speedToBeTransparent>>
@@ -242,7 +288,7 @@ class GameManager {
   int GetNumGameLevels();
 
   // Get bubble number for each level range.
-  int GetBubbleNumForLevel();
+  int GetBubbleNumForLevel(int level);
 
   // Get the page name for a given game state.
   std::string GetPageName(GameState gameState);
@@ -322,6 +368,10 @@ class GameManager {
   // Calculate the offsets when scroll is shaking.
   glm::vec2 CalculateScrollShakingOffsets(bool isScrollVibrating = true);
 
+  // Offset the view of the game arena. The arena is drawn shifted by the
+  // offset while its entities stay where they are.
+  void SetArenaViewOffset(glm::vec2 offset);
+
   // Check if the bubble collides with the existing static bubbles
   std::vector<int> IsCollidingWithStaticBubbles(
       std::unique_ptr<Bubble>& bubble);
@@ -339,106 +389,38 @@ class GameManager {
   std::vector<glm::vec2> GetCommonFreeSlots(
       std::vector<int>& bubbleIds, std::vector<glm::vec2> candidateFreeSlots);
 
-  // Given the bubble's color, get the weight of a free slot. The weight is
-  // calculated by counting the number of neighbors. If a neighbor has the same
-  // color, the weight is 1. Otherwise, the weight is 0.1.
-  float GetFreeSlotWeight(glm::vec3 color, glm::vec2 slotCenter);
-
   // Get the unique id of all neighbor static bubbles of the given bubble.
   std::vector<int> GetNeighborIds(std::unique_ptr<Bubble>& bubble,
                                   float absError = 0.5f);
 
-  // Get the unique id of all neighbor static bubbles of the given group of
-  // bubbles.
-  std::vector<int> GetNeighborIds(std::vector<Bubble*>& bubbles);
+  // Get the unique id of all neighbor static bubbles of the given center.
+  std::vector<int> GetNeighborIds(glm::vec2 center, float absError = 0.5f);
 
   // Get the unique id of all neighbor static bubbles of the given group of
   // bubbles.
-  std::vector<int> GetNeighborIds(
-      std::unordered_map<int, std::unique_ptr<Bubble>>& bubbles);
+  std::vector<int> GetNeighborIds(std::vector<Bubble*>& bubbles);
 
   // Check if a poistion is at the upper boundary of the game board.
   bool IsAtUpperBoundary(glm::vec2 pos);
 
-  // Find all the bubbles that have no path to the top of the game board.
-  std::vector<int> FindAllFallingBubbles();
-
-  // Find a group of bubbles that are connected to the given bubble and have the
-  // same color as the given bubble.
-  std::vector<int> FindConnectedBubblesOfSameColor(int bubbleId);
-
-  // Find all the bubbles that have path to the given bubble ids.
-  std::vector<int> FindConnectedBubbles(std::vector<int>& bubbleIds);
-
-  // Find all the statics bubbles that are at the upper boundary of the game
-  // board and close to the given bubble.
-  std::vector<int> FindCloseUpperBubbles(std::unique_ptr<Bubble>& bubble);
-
-  // Find the left bubble of the given bubble in the same row.
-  int FindLeftBubble(std::unique_ptr<Bubble>& bubble);
-
-  // Find the right bubble of the given bubble in the same row.
-  int FindRightBubble(std::unique_ptr<Bubble>& bubble);
-
-  // Fine tune the position of the collided moving bubble to a free slot
-  // neighboring a neighbor of the colliding static bubble.
-  bool FineTuneToNeighbor(int bubbleId, int staticBubbleId);
-
-  // Fine tune the position of the collided moving bubble to a free slot
-  // neighboring both the colliding static bubble and a close static bubble.
-  bool FineTuneToClose(int bubbleId, int staticBubbleId);
-
-  // Fine tune the position of the collided moving bubble to a free slot
-  // neighboring a close static bubble at the upper boundary of the game board.
-  bool FineTuneToCloseUpper(int bubbleId);
-
-  // Adjusts the position of a moving bubble to ensure it correctly occupies a
-  // free slot after collision.
-  //
-  // This function fine-tunes the position of a bubble when it collides with
-  // another or reaches the boundary:
-  // 1. When adjacent to a static bubble:
-  //    - The function aligns the moving bubble into a free neighboring slot.
-  //    - The alignment is based on the angle with the static bubble's right
-  //    neighbor, which must be a multiple of 30 degrees.
-  // 2. When the bubble reaches the upper boundary of the game board:
-  //    - The function places it in a slot along the boundary.
-  //    - The distance to the nearest slot is determined by one of the following
-  //    formulas, where n is a non-negative integer (n >= 0):
-  //      a. 2*sqrt(2) + n*4
-  //      b. 2*sqrt(3) + n*4
-  //      c. n*4
-  //
-  // Returns true if fine tunning succeessfully updates the bubble's position.
-  bool FineTuneToCorrectPosition(int bubbleId);
-
-  // Helper function of IsConnectedToTop
-  bool IsConnectedToTopHelper(std::unique_ptr<Bubble>& bubble, bool* visited,
-                              bool* isConnectToTop);
-
-  // Check if the given bubble is connected to the top of the game board.
-  bool IsConnectedToTop(std::unique_ptr<Bubble>& bubble);
-
-  // Get the common free slots of the given two free slot vectors.
-  std::vector<glm::vec2> GetCommonFreeSlots(std::vector<glm::vec2> freeSlots1,
-                                            std::vector<glm::vec2> freeSlots2);
-
   // Check if a free slot center is a neighbor of static bubbles.
   bool IsNeighborOfStaticBubbles(glm::vec2 freeSlotCenter);
 
-  // Get potential neighbor free slots of the given bubble.
-  std::vector<glm::vec2> GetPotentialNeighborFreeSlots(glm::vec2 bubbleCenter);
+  // Get the parameters for generating the static bubbles of the given level.
+  LevelGenerationParams GetLevelGenerationParams(int level);
+
+  // Start generating the layout of the given level on a background thread.
+  // Waits for the previous generation to finish if it is still running.
+  void StartGeneratingLevelLayout(int level);
 
-  // Update the free slots of the game board after inserting a new bubble.
-  void UpdateFreeSlots(std::unique_ptr<Bubble>& bubble,
-                       float minDistanceToBottom = 0.f,
-                       float minHorizontalDistanceToShooter = 0.f,
-                       float minVerticalDistanceToShooter = 0.f);
+  // Wait for the background level generation to finish if it is running.
+  void JoinLevelGenerationThread();
 
-  // Generate random static bubbles on the free slots of the game board.
-  void GenerateRandomStaticBubblesHelper(GameLevel gameLevel);
+  // Check if the layout of the current level is ready to be placed on the game
+  // board. Starts generating it if there is no matching layout.
+  bool IsLevelLayoutReady();
 
-  // Generate random static bubbles on the game board.
+  // Place the static bubbles of the generated level layout on the game board.
   void GenerateRandomStaticBubbles();
 
   // Get the time interval for narrowing the game board vertically in the
@@ -449,8 +431,8 @@ class GameManager {
   glm::vec4 GetNextBubbleColor();
 
   // Adjust the horizontal position of the buttons.
-  void AdjustButtonsHorizontalPosition(
-      const std::vector<std::string>& buttonName, float interval = 0.f);
+  void AdjustButtonsHorizontalPosition(const std::vector<StringId>& buttonName,
+                                       float interval = 0.f);
 
   // Check if it is failed to pass the current level.
   bool IsLevelFailed();
@@ -20,14 +20,20 @@
 #include <GLFW/glfw3.h>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <mutex>
+#include <random>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "ConfigManager.h"
 #include "GameManager.h"
+#include "InputReplay.h"
 #include "Renderer.h"
 #include "ResourceManager.h"
 #include "SoundEngine.h"
@@ -43,6 +49,13 @@ glm::vec2 kWindowSize = glm::vec2(3840, 2160);
 
 std::atomic<bool> windowShouldClose(false);
 
+// Number of simulation ticks run so far. Input is recorded with the tick it is
+// applied before.
+int64_t currentTick = 0;
+// Whether the input is being recorded, and the recording.
+bool isRecordingInput = false;
+InputRecording inputRecording;
+
 // void showTaskbar();
 // void hideTaskbar();
 
@@ -70,7 +83,29 @@ void recreateWindow(GLFWwindow*& window, int width, int height,
 void handleScreenModeChange(GLFWwindow*& window, GameManager& gameManager,
                             bool& isFromWindowedBorderlessMode);
 
-int main() {
+void initGame(GLFWwindow* window, GameManager& gameManager);
+
+int replayInput(GLFWwindow* window, GameManager& gameManager,
+                const InputRecording& recording, float timeStep);
+
+// Check that a snapshot of the game loads back into the same state, and that a
+// truncated snapshot is refused without changing the game.
+bool checkSnapshotRoundTrip(GameManager& gameManager);
+
+int main(int argc, char* argv[]) {
+  // "--record <file>" records the input of the session to the file, and
+  // "--replay <file>" plays a recorded session back in a hidden window.
+  std::string recordPath, replayPath;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--record") == 0) {
+      recordPath = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--replay") == 0) {
+      replayPath = argv[i + 1];
+    }
+  }
+  bool isReplaying = !replayPath.empty();
+  isRecordingInput = !recordPath.empty() && !isReplaying;
+
   // Load configurations
   ConfigManager& configManager = ConfigManager::GetInstance();
   configManager.SetConfigPath("settings/config.json");
@@ -78,6 +113,35 @@ int main() {
     std::cerr << "Failed to load configurations." << std::endl;
     return EXIT_FAILURE;
   }
+
+  // Seed the random number streams, with the seed of the recording when
+  // replaying one.
+  uint32_t seed = std::random_device{}();
+  if (isReplaying) {
+    if (!inputRecording.Load(replayPath)) {
+      std::cerr << "Failed to load the input recording " << replayPath
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (inputRecording.GetTickRate() != configManager.GetTickRate() ||
+        inputRecording.GetDifficulty() !=
+            static_cast<int>(configManager.GetDifficulty()) ||
+        inputRecording.GetLanguage() !=
+            static_cast<int>(configManager.GetLanguage())) {
+      std::cerr << "The tick rate, difficulty or language of the recording "
+                   "differs from the configuration."
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    seed = inputRecording.GetSeed();
+  } else if (isRecordingInput) {
+    inputRecording.SetTickRate(configManager.GetTickRate());
+    inputRecording.SetDifficulty(
+        static_cast<int>(configManager.GetDifficulty()));
+    inputRecording.SetLanguage(static_cast<int>(configManager.GetLanguage()));
+    inputRecording.SetSeed(seed);
+  }
+  Random::Seed(seed);
   // Set the default locale based on the system language if it is the first run
   // of the game.
   if (configManager.IsFirstRun()) {
@@ -92,6 +156,10 @@ int main() {
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
   glfwWindowHint(GLFW_RESIZABLE, true);
+  // A replay only needs the context of the window to render into.
+  if (isReplaying) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  }
 
   // Set the opengl window width to 80% of the screen width and height to 90% of
   // the screen height
@@ -114,7 +182,8 @@ int main() {
                                 kWindowedModeSizePadding.height);
   initParametersForCurrentWindowSize(kVirtualScreenSize.x,
                                      kVirtualScreenSize.y);
-  ScreenMode initialScreenMode = configManager.GetScreenMode();
+  ScreenMode initialScreenMode =
+      isReplaying ? ScreenMode::WINDOWED : configManager.GetScreenMode();
 
   // By default, the screen mode is set to full screen mode
   SizePadding SCREEN_SIZE_PADDING = kFullScreenSizePadding;
@@ -195,8 +264,20 @@ int main() {
   bool isFromWindowedBorderlessMode =
       initialScreenMode == ScreenMode::WINDOWED_BORDERLESS;
 
-  // fixed time step
-  const float kTimeStep = 1.f / 240.f;
+  // Fixed time step of the simulation, and the maximum number of steps run
+  // within a frame. When a frame takes longer than that, the remaining time is
+  // dropped, so that the simulation slows down instead of falling further
+  // behind with every frame.
+  const float kTimeStep = 1.f / static_cast<float>(configManager.GetTickRate());
+  const int kMaxCatchUpSteps = configManager.GetMaxCatchUpSteps();
+
+  if (isReplaying) {
+    int status = replayInput(window, gameManager, inputRecording, kTimeStep);
+    ResourceManager::GetInstance().Clear();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return status;
+  }
 
   float accumulator = 0.f;
   float deltaTime = 0.0f;
@@ -212,14 +293,10 @@ int main() {
     if (gameManager.state == GameState::PRELOAD &&
         gameManager.targetState == GameState::UNDEFINED &&
         currentFrame - startFrame >= 2.85f) {
-      gameManager.Init();
-      gameManager.LoadSounds();
-      gameManager.LoadStreams();
-      assert(gameManager.targetState == GameState::SPLASH_SCREEN &&
-             "Failed to initialize the game.");
-      int framebufferWidth, framebufferHeight;
-      glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
-      reconfigureWindowSize(window, framebufferWidth, framebufferHeight);
+      if (isRecordingInput) {
+        inputRecording.Add(currentTick, InputEventType::kInit);
+      }
+      initGame(window, gameManager);
       accumulator = 0.f;
       currentFrame = static_cast<float>(glfwGetTime());
       lastFrame = currentFrame;
@@ -235,7 +312,8 @@ int main() {
     }
 
     // Process the input at fixed time step and update the game state.
-    while (accumulator >= kTimeStep) {
+    int numSteps = 0;
+    while (accumulator >= kTimeStep && numSteps < kMaxCatchUpSteps) {
       // Process input
       gameManager.ProcessInput(kTimeStep);
 
@@ -248,6 +326,11 @@ int main() {
       // Update game state
       gameManager.Update(kTimeStep);
       accumulator -= kTimeStep;
+      ++numSteps;
+      ++currentTick;
+    }
+    if (accumulator >= kTimeStep) {
+      accumulator = std::fmod(accumulator, kTimeStep);
     }
 
     // Set the clear color
@@ -260,13 +343,23 @@ int main() {
     } else {
       glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
     }
-    // Render
-    gameManager.Render();
+    // Render between the last two simulation steps by the fraction of a time
+    // step that is left in the accumulator.
+    gameManager.Render(accumulator / kTimeStep);
 
     // Swap the screen buffers
     glfwSwapBuffers(window);
   }
 
+  if (isRecordingInput) {
+    inputRecording.SetNumTicks(currentTick);
+    inputRecording.SetFinalHash(gameManager.GetStateHash());
+    if (!inputRecording.Save(recordPath)) {
+      std::cerr << "Failed to save the input recording " << recordPath
+                << std::endl;
+    }
+  }
+
   // Delete all resources.
   ResourceManager::GetInstance().Clear();
 
@@ -401,14 +494,10 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action,
   // Retrieve the pointer to gamemanager
   GameManager* gameManager =
       static_cast<GameManager*>(glfwGetWindowUserPointer(window));
-  if (key >= 0 && key < 1024) {
-    if (action == GLFW_PRESS)
-      gameManager->keys[key] = true;
-    else if (action == GLFW_RELEASE) {
-      gameManager->keys[key] = false;
-      gameManager->keysLocked[key] = false;
-    }
+  if (isRecordingInput) {
+    inputRecording.Add(currentTick, InputEventType::kKey, key, action);
   }
+  gameManager->OnKey(key, action);
 }
 
 void scroll_callback(GLFWwindow* window, double xOffset, double yOffset) {
@@ -417,7 +506,11 @@ void scroll_callback(GLFWwindow* window, double xOffset, double yOffset) {
       static_cast<GameManager*>(glfwGetWindowUserPointer(window));
 
   // Handle the scroll event
-  gameManager->scrollYOffset = static_cast<float>(yOffset);
+  if (isRecordingInput) {
+    inputRecording.Add(currentTick, InputEventType::kScroll, 0, 0, 0.f,
+                       static_cast<float>(yOffset));
+  }
+  gameManager->OnScroll(static_cast<float>(yOffset));
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action,
@@ -425,20 +518,11 @@ void mouse_button_callback(GLFWwindow* window, int button, int action,
   GameManager* gameManager =
       static_cast<GameManager*>(glfwGetWindowUserPointer(window));
 
-  if (button == GLFW_MOUSE_BUTTON_LEFT) {
-    if (action == GLFW_PRESS) {
-      if (gameManager->leftMousePressed == false) {
-        gameManager->leftMousePressed = true;
-        gameManager->mouseLastX = gameManager->mouseX;
-        gameManager->mouseLastY = gameManager->mouseY;
-      }
-    } else if (action == GLFW_RELEASE) {
-      // When left mouse button is released, stop dragging
-      gameManager->leftMousePressed = false;
-      gameManager->isReadyToDrag = true;
-      gameManager->isDragging = false;
-    }
+  if (isRecordingInput) {
+    inputRecording.Add(currentTick, InputEventType::kMouseButton, button,
+                       action);
   }
+  gameManager->OnMouseButton(button, action);
 
   // Set the window to be close when the game state is EXIT
   if (gameManager->state == GameState::EXIT) {
@@ -462,8 +546,11 @@ void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
                         expectedWindowSizePadding.height /
                         actualWindowSizePadding.height;
 
-  gameManager->mouseX = virtualMouseX;
-  gameManager->mouseY = virtualMouseY;
+  if (isRecordingInput) {
+    inputRecording.Add(currentTick, InputEventType::kCursorPosition, 0, 0,
+                       virtualMouseX, virtualMouseY);
+  }
+  gameManager->OnCursorPosition(virtualMouseX, virtualMouseY);
 }
 
 // void focus_callback(GLFWwindow* window, int focused) {
@@ -575,3 +662,95 @@ void handleScreenModeChange(GLFWwindow*& window, GameManager& gameManager,
     isFromWindowedBorderlessMode = true;
   }
 }
+
+void initGame(GLFWwindow* window, GameManager& gameManager) {
+  gameManager.Init();
+  gameManager.LoadSounds();
+  gameManager.LoadStreams();
+  assert(gameManager.targetState == GameState::SPLASH_SCREEN &&
+         "Failed to initialize the game.");
+  int framebufferWidth, framebufferHeight;
+  glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+  reconfigureWindowSize(window, framebufferWidth, framebufferHeight);
+}
+
+int replayInput(GLFWwindow* window, GameManager& gameManager,
+                const InputRecording& recording, float timeStep) {
+  const std::vector<InputEvent>& events = recording.GetEvents();
+  std::vector<double> updateTimes, renderTimes;
+  updateTimes.reserve(recording.GetNumTicks());
+  renderTimes.reserve(recording.GetNumTicks());
+  size_t nextEvent = 0;
+  for (currentTick = 0; currentTick < recording.GetNumTicks(); ++currentTick) {
+    // Apply the input that was fed through the callbacks before this tick.
+    for (; nextEvent < events.size() && events[nextEvent].tick == currentTick;
+         ++nextEvent) {
+      const InputEvent& event = events[nextEvent];
+      if (event.type == InputEventType::kKey) {
+        gameManager.OnKey(event.code, event.action);
+      } else if (event.type == InputEventType::kMouseButton) {
+        gameManager.OnMouseButton(event.code, event.action);
+      } else if (event.type == InputEventType::kCursorPosition) {
+        gameManager.OnCursorPosition(event.x, event.y);
+      } else if (event.type == InputEventType::kScroll) {
+        gameManager.OnScroll(event.y);
+      } else if (event.type == InputEventType::kInit) {
+        initGame(window, gameManager);
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    gameManager.ProcessInput(timeStep);
+    // The window is hidden, so only the game follows the screen mode.
+    if (gameManager.targetScreenMode != ScreenMode::UNDEFINED) {
+      gameManager.SetToTargetScreenMode();
+    }
+    gameManager.Update(timeStep);
+    auto updated = std::chrono::steady_clock::now();
+    glClear(GL_COLOR_BUFFER_BIT);
+    gameManager.Render();
+    auto rendered = std::chrono::steady_clock::now();
+    updateTimes.push_back(
+        std::chrono::duration<double, std::micro>(updated - start).count());
+    renderTimes.push_back(
+        std::chrono::duration<double, std::micro>(rendered - updated).count());
+  }
+
+  std::cout << "ticks: " << recording.GetNumTicks() << std::endl;
+  printTickTimePercentiles(std::cout, "update", updateTimes);
+  printTickTimePercentiles(std::cout, "render", renderTimes);
+  uint64_t hash = gameManager.GetStateHash();
+  if (hash != recording.GetFinalHash()) {
+    std::cerr << "The replay diverged: the final hash is " << std::hex << hash
+              << " instead of " << recording.GetFinalHash() << std::dec
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "The final hash matches the recording." << std::endl;
+  if (!checkSnapshotRoundTrip(gameManager)) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+bool checkSnapshotRoundTrip(GameManager& gameManager) {
+  uint64_t hash = gameManager.GetStateHash();
+  std::vector<uint8_t> snapshot = gameManager.SaveSnapshot();
+  std::vector<uint8_t> truncated(snapshot.begin(),
+                                 snapshot.begin() + snapshot.size() / 2);
+  if (gameManager.LoadSnapshot(truncated) ||
+      gameManager.GetStateHash() != hash) {
+    std::cerr << "A truncated snapshot was not refused cleanly." << std::endl;
+    return false;
+  }
+  if (!gameManager.LoadSnapshot(snapshot) ||
+      gameManager.GetStateHash() != hash ||
+      gameManager.SaveSnapshot().size() != snapshot.size()) {
+    std::cerr << "The snapshot did not load back into the same state."
+              << std::endl;
+    return false;
+  }
+  std::cout << "The snapshot of the final state loads back identically."
+            << std::endl;
+  return true;
+}
@@ -198,6 +198,27 @@ int64_t ConfigManager::GetScore() const {
   return config_.at("score").get<int64_t>();
 }
 
+int ConfigManager::GetTickRate() const {
+  int tickRate = config_.value("tickRate", kDefaultTickRate);
+  if (tickRate <= 0) {
+    std::cerr << "Invalid tick rate in configuration file: " << tickRate
+              << std::endl;
+    return kDefaultTickRate;
+  }
+  return tickRate;
+}
+
+int ConfigManager::GetMaxCatchUpSteps() const {
+  int maxCatchUpSteps =
+      config_.value("maxCatchUpSteps", kDefaultMaxCatchUpSteps);
+  if (maxCatchUpSteps <= 0) {
+    std::cerr << "Invalid catch-up steps in configuration file: "
+              << maxCatchUpSteps << std::endl;
+    return kDefaultMaxCatchUpSteps;
+  }
+  return maxCatchUpSteps;
+}
+
 std::pair<char32_t, std::string> ConfigManager::GetFontFilePath(
     char32_t character, CharStyle style) const {
   std::string style_str = char_style_map.at(style);
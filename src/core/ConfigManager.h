@@ -6,7 +6,7 @@
 #include <string>
 #include <unordered_map>
 
-enum class Difficulty { UNDEFINED, EASY, MEDIUM, HARD, EXPERT };
+#include "LevelRules.h"
 
 enum class ScreenMode { UNDEFINED, FULLSCREEN, WINDOWED_BORDERLESS, WINDOWED };
 
@@ -116,6 +116,10 @@ inline std::unordered_map<CharStyle, std::string> char_style_map = {
 
 class ConfigManager {
  public:
+  // Default simulation settings, used when the config file does not set them.
+  static constexpr int kDefaultTickRate = 120;
+  static constexpr int kDefaultMaxCatchUpSteps = 5;
+
   // Get the singleton instance
   static ConfigManager& GetInstance();
   // Set the config file path
@@ -140,6 +144,11 @@ class ConfigManager {
   void SetScore(int64_t score);
   // Get the score.
   int64_t GetScore() const;
+  // Get the number of simulation steps per second.
+  int GetTickRate() const;
+  // Get the maximum number of simulation steps run within a single frame to
+  // catch up with the real time.
+  int GetMaxCatchUpSteps() const;
   // Get path to font file for a certain character
   std::pair<char32_t, std::string> GetFontFilePath(char32_t character,
                                                    CharStyle style) const;
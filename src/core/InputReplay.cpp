@@ -0,0 +1,123 @@
+/*
+ * InputReplay.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "InputReplay.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+// Fields are written with the byte order of the machine, which is little
+// endian on every platform the game ships on.
+template <typename T>
+void writeField(std::ofstream& file, T value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readField(std::ifstream& file, T& value) {
+  file.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return static_cast<bool>(file);
+}
+
+}  // namespace
+
+void InputRecording::Add(int64_t tick, InputEventType type, int32_t code,
+                         int32_t action, float x, float y) {
+  assert((events.empty() || events.back().tick <= tick) &&
+         "Events must be added in the order of their ticks.");
+  events.push_back({tick, type, code, action, x, y});
+}
+
+bool InputRecording::Save(const std::string& path) const {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  writeField(file, kMagic);
+  writeField(file, kVersion);
+  writeField(file, static_cast<int32_t>(tickRate));
+  writeField(file, static_cast<int32_t>(difficulty));
+  writeField(file, static_cast<int32_t>(language));
+  writeField(file, seed);
+  writeField(file, numTicks);
+  writeField(file, finalHash);
+  writeField(file, static_cast<uint64_t>(events.size()));
+  for (const InputEvent& event : events) {
+    writeField(file, event.tick);
+    writeField(file, static_cast<uint8_t>(event.type));
+    writeField(file, event.code);
+    writeField(file, event.action);
+    writeField(file, event.x);
+    writeField(file, event.y);
+  }
+  return static_cast<bool>(file);
+}
+
+bool InputRecording::Load(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  uint32_t magic = 0, version = 0;
+  if (!file || !readField(file, magic) || !readField(file, version) ||
+      magic != kMagic || version != kVersion) {
+    return false;
+  }
+  int32_t tickRate = 0, difficulty = 0, language = 0;
+  uint64_t numEvents = 0;
+  if (!readField(file, tickRate) || !readField(file, difficulty) ||
+      !readField(file, language) || !readField(file, seed) ||
+      !readField(file, numTicks) || !readField(file, finalHash) ||
+      !readField(file, numEvents)) {
+    return false;
+  }
+  this->tickRate = tickRate;
+  this->difficulty = difficulty;
+  this->language = language;
+  events.clear();
+  for (uint64_t i = 0; i < numEvents; ++i) {
+    InputEvent event;
+    uint8_t type = 0;
+    if (!readField(file, event.tick) || !readField(file, type) ||
+        !readField(file, event.code) || !readField(file, event.action) ||
+        !readField(file, event.x) || !readField(file, event.y) ||
+        type > static_cast<uint8_t>(InputEventType::kInit)) {
+      return false;
+    }
+    event.type = static_cast<InputEventType>(type);
+    events.push_back(event);
+  }
+  return true;
+}
+
+void printTickTimePercentiles(std::ostream& out, const std::string& name,
+                              std::vector<double> microseconds) {
+  if (microseconds.empty()) {
+    return;
+  }
+  std::sort(microseconds.begin(), microseconds.end());
+  auto percentile = [&microseconds](double p) {
+    size_t index = static_cast<size_t>(p * (microseconds.size() - 1));
+    return microseconds[index];
+  };
+  out << std::fixed << std::setprecision(1) << name << " (us): p50 "
+      << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 "
+      << percentile(0.99) << ", max " << microseconds.back()
+      << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Kind of an input event. kInit marks the tick at which the game was
+// initialized, which depends on the wall clock when the game is played.
+enum class InputEventType : uint8_t {
+  kKey,
+  kMouseButton,
+  kCursorPosition,
+  kScroll,
+  kInit,
+};
+
+// An input event as it was fed through the GLFW callbacks, tagged with the
+// simulation tick it was applied before.
+struct InputEvent {
+  int64_t tick{0};
+  InputEventType type{InputEventType::kKey};
+  // Key or mouse button, and its action.
+  int32_t code{0};
+  int32_t action{0};
+  // Cursor position in the virtual screen, or the scroll offset in y.
+  float x{0.f};
+  float y{0.f};
+};
+
+// InputRecording holds the input of a play session together with what the
+// session depends on besides its input: the tick rate, the difficulty, the
+// language, which lays out the buttons, and the seed of the random number
+// generators. Playing its events back on the same ticks makes the game go
+// through the same states, which is checked against the hash of the game at
+// the last tick.
+class InputRecording {
+ public:
+  static constexpr uint32_t kMagic = 0x50524444;  // "DDRP"
+  static constexpr uint32_t kVersion = 1;
+
+  InputRecording() = default;
+  ~InputRecording() = default;
+
+  // Add an event applied before the given tick. Events must be added in the
+  // order of their ticks.
+  void Add(int64_t tick, InputEventType type, int32_t code = 0,
+           int32_t action = 0, float x = 0.f, float y = 0.f);
+
+  // Write the recording to a binary file, or read it from one. Return false
+  // if the file cannot be written or is not a recording of this version.
+  bool Save(const std::string& path) const;
+  bool Load(const std::string& path);
+
+  // Getters and setters
+  const std::vector<InputEvent>& GetEvents() const { return events; }
+  int GetTickRate() const { return tickRate; }
+  void SetTickRate(int tickRate) { this->tickRate = tickRate; }
+  int GetDifficulty() const { return difficulty; }
+  void SetDifficulty(int difficulty) { this->difficulty = difficulty; }
+  int GetLanguage() const { return language; }
+  void SetLanguage(int language) { this->language = language; }
+  uint32_t GetSeed() const { return seed; }
+  void SetSeed(uint32_t seed) { this->seed = seed; }
+  int64_t GetNumTicks() const { return numTicks; }
+  void SetNumTicks(int64_t numTicks) { this->numTicks = numTicks; }
+  uint64_t GetFinalHash() const { return finalHash; }
+  void SetFinalHash(uint64_t finalHash) { this->finalHash = finalHash; }
+
+ private:
+  int tickRate{0};
+  int difficulty{0};
+  int language{0};
+  uint32_t seed{0};
+  int64_t numTicks{0};
+  uint64_t finalHash{0};
+  std::vector<InputEvent> events;
+};
+
+// Print the 50th, 90th and 99th percentiles and the maximum of the given
+// per-tick times in microseconds.
+void printTickTimePercentiles(std::ostream& out, const std::string& name,
+                              std::vector<double> microseconds);
@@ -23,23 +23,6 @@
 #include <iostream>
 #include <sstream>
 
-std::unordered_map<Color, glm::vec3> colorMap = {
-    {Color::Red, glm::vec3(1.0f, 0.0f, 0.0f)},
-    {Color::Green, glm::vec3(0.0f, 1.0f, 0.0f)},
-    {Color::Blue, glm::vec3(0.0f, 0.0f, 1.0f)},
-    {Color::Yellow, glm::vec3(1.0f, 1.0f, 0.0f)},
-    {Color::Pink, glm::vec3(0.949f, 0.4078f, 0.5725f)},
-    {Color::Purple, glm::vec3(0.5f, 0.0f, 0.5f)},
-    {Color::Orange, glm::vec3(1.0f, 0.65f, 0.0f)},
-    {Color::Cyan, glm::vec3(0.0f, 1.0f, 1.0f)},
-    {Color::White, glm::vec3(1.0f, 1.0f, 1.0f)},
-    {Color::LightBlue, glm::vec3(0.678f, 0.847f, 0.902f)},
-    {Color::Brown, glm::vec3(0.6471, 0.1647, 0.1647)},
-    {Color::JadeGreen, glm::vec3(0.0, 0.6588, 0.4196)},
-};
-
-std::mt19937 eng(std::random_device{}());
-
 float screenScale = 1.0f;
 float kBaseUnit = kWindowSize.y / 42.f;
 float kBubbleRadius = kBaseUnit;
@@ -48,80 +31,18 @@ glm::vec2 kBubbleSize = glm::vec2(kBubbleRadius * 2, kBubbleRadius * 2);
 float kFontScale = 0.2f;
 float kFontSize = kWindowSize.y * kFontScale;
 
-bool areFloatsEqual(float a, float b, float epsilon) {
-  return std::abs(a - b) < epsilon;
-}
-
-bool areFloatsEqual(const glm::vec2& a, const glm::vec2& b, float epsilon) {
-  return areFloatsEqual(a.x, b.x, epsilon) && areFloatsEqual(a.y, b.y, epsilon);
-}
-
-bool areFloatsEqual(const glm::vec3& a, const glm::vec3& b, float epsilon) {
-  return areFloatsEqual(a.r, b.r, epsilon) &&
-         areFloatsEqual(a.g, b.g, epsilon) && areFloatsEqual(a.b, b.b, epsilon);
-}
-
-bool areFloatsLess(float a, float b, float epsilon) {
-  return a < b && !areFloatsEqual(a, b, epsilon);
-}
-
-bool areFloatsGreater(float a, float b, float epsilon) {
-  return a > b && !areFloatsEqual(a, b, epsilon);
-}
-
-float lawOfCosines(float a, float b, float cosgamma) {
-  return std::sqrt(a * a + b * b - 2 * a * b * cosgamma);
-}
-
-std::pair<float, float> lawOfCosinesB(float a, float c, float cosgamma) {
-  float firstPart = a * cosgamma;
-  float secondPart = a * std::sqrt(cosgamma * cosgamma - 1 + (c * c) / (a * a));
-  return std::make_pair(firstPart - secondPart, firstPart + secondPart);
-}
-
-float lawOfCosinesCos(float a, float b, float c) {
-  return (a * a + b * b - c * c) / (2 * a * b);
-}
-
-float lawOfCosinesAngle(float a, float b, float c) {
-  return glm::acos(lawOfCosinesCos(a, b, c));
-}
-
 float timeToTravel(float distance, glm::vec2 velocity) {
   return distance / glm::length(velocity);
 }
 
-glm::vec2 rotateVector(glm::vec2 point, float angle, glm::vec2 pivot) {
-  // translate the vector so that the point is at the origin
-  point -= pivot;
-  // rotate the vector using glm::rotate
-  point = glm::rotate(point, angle);
-  // translate the vector back to its original position
-  point += pivot;
-  return point;
-}
-
-int getSignOfCrossProduct(glm::vec2 a, glm::vec2 b) {
-  // Use glm::cross to calculate the cross product of a and b
-  float crossProduct = glm::cross(glm::vec3(a, 0.0f), glm::vec3(b, 0.0f)).z;
-  // return 1 if crossProduct is positive, -1 if crossProduct is negative, and 0
-  // if crossProduct is 0
-  if (crossProduct > 0) {
-    return 1;
-  } else if (crossProduct < 0) {
-    return -1;
-  } else {
-    return 0;
-  }
-}
-
 double generateGaussianRandom(double min, double max, double mean) {
   if (mean == std::numeric_limits<double>::infinity()) {
     mean = (min + max) / 2.0;
   }
   double stddev = (max - min) / 6.0;
   std::normal_distribution<> distr(mean, stddev);
-  double value = distr(eng);  // Generate a Gaussian-distributed value
+  // Generate a Gaussian-distributed value
+  double value = distr(Random::Get(RandomStream::kGameplay));
   value = std::max(min, std::min(value, max));  // Clip the value to the range
   return value;
 }
@@ -130,11 +51,6 @@ bool randomBool(float probability) {
   return generateRandom(0.0f, 1.0f) < probability;
 }
 
-bool isSameColor(glm::vec3 rgb1, glm::vec3 rgb2) {
-  return areFloatsEqual(rgb1.r, rgb2.r) && areFloatsEqual(rgb1.g, rgb2.g) &&
-         areFloatsEqual(rgb1.b, rgb2.b);
-}
-
 std::string colorToString(glm::vec4 color) {
   std::stringstream ss;
   ss << "(" << color.r << ", " << color.g << ", " << color.b << ", " << color.a
@@ -142,22 +58,6 @@ std::string colorToString(glm::vec4 color) {
   return ss.str();
 }
 
-Color colorToEnum(glm::vec3 rgb) {
-  for (auto it : colorMap) {
-    if (isSameColor(it.second, rgb)) {
-      return it.first;
-    }
-  }
-  return Color::Red;
-}
-
-bool isDeepColor(glm::vec3 rgb) {
-  Color color = colorToEnum(rgb);
-  return color == Color::Pink || color == Color::Purple ||
-         color == Color::Blue || color == Color::Red || color == Color::Brown ||
-         color == Color::JadeGreen;
-}
-
 glm::vec3 rgb2hsv(glm::vec3 rgb) {
   float r = rgb.r, g = rgb.g, b = rgb.b;
   float max = std::max({r, g, b});
@@ -320,19 +220,6 @@ bool isPointOnLine(glm::vec2 point, glm::vec3 lineParams) {
       lineParams.x * point.x + lineParams.y * point.y + lineParams.z, 0.0f);
 }
 
-std::optional<std::pair<float, float>> solveQuadratic(float a, float b,
-                                                      float c) {
-  float discriminant = b * b - 4 * a * c;
-  if (discriminant < 0) {
-    // No real roots
-    return std::nullopt;
-  }
-  float sqrtDiscriminant = std::sqrt(discriminant);
-  float root1 = (-b + sqrtDiscriminant) / (2 * a);
-  float root2 = (-b - sqrtDiscriminant) / (2 * a);
-  return std::make_pair(root1, root2);
-}
-
 std::optional<std::pair<float, float>> solveTwoVariableLinear(
     float a1, float b1, float c1, float a2, float b2, float c2) {
   float determinant = a1 * b2 - a2 * b1;
@@ -519,15 +406,16 @@ Shader ResourceManager::GetShader(std::string name) {
 }
 
 Texture2D ResourceManager::LoadTexture(const char* file, bool alpha,
-                                       std::string name) {
+                                       StringId name) {
   /* std::lock_guard<std::mutex> lock(resourceMutex);*/
   Textures[name] = loadTextureFromFile(file, alpha);
   return Textures.at(name);
 }
 
-Texture2D ResourceManager::GetTexture(std::string name) {
-  assert(Textures.count(name) > 0 && "The texture does not exist.");
-  return Textures.at(name);
+Texture2D ResourceManager::GetTexture(StringId name) {
+  auto it = Textures.find(name);
+  assert(it != Textures.end() && "The texture does not exist.");
+  return it->second;
 }
 
 bool ResourceManager::LoadText(const char* jsonFile) {
@@ -541,7 +429,7 @@ bool ResourceManager::LoadText(const char* jsonFile) {
   return true;
 }
 
-void ResourceManager::UnloadTexture(const std::string& name) {
+void ResourceManager::UnloadTexture(StringId name) {
   glDeleteTextures(1, &Textures.at(name).ID);
   Textures.erase(name);
 }
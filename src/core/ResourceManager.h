@@ -16,26 +16,14 @@
 #include <string>
 #include <unordered_map>
 
+#include "Random.h"
 #include "Shader.h"
+#include "SimulationUtils.h"
+#include "StringId.h"
 #include "Texture.h"
 
 #include "stb_image.h"
 
-enum class Color {
-  Red,
-  Green,
-  Blue,
-  Yellow,
-  Pink,
-  Purple,
-  Orange,
-  Cyan,
-  White,
-  LightBlue,
-  Brown,
-  JadeGreen,
-};
-
 struct SizePadding {
   int width;
   int height;
@@ -75,11 +63,6 @@ struct ViewPortInfo {
       : x(x), y(y), width(width), height(height) {}
 };
 
-extern std::unordered_map<Color, glm::vec3> colorMap;
-
-// Engine for generating random numbers.
-extern std::mt19937 eng;
-
 constexpr glm::vec3 kScoreColorPink = glm::vec3(1.0f, 0.0f, 0.56471f);
 constexpr glm::vec3 kScoreColorOrange = glm::vec3(1.0f, 0.65f, 0.0f);
 constexpr float kScoreAlpha = 0.5f;
@@ -116,6 +99,8 @@ extern float kBaseUnit;
 // Regular bubbble's radius and size.
 extern float kBubbleRadius;
 extern glm::vec2 kBubbleSize;
+// Opacity of the bubbles.
+const float kBubbleAlpha = 0.8f;
 
 // font size
 extern float kFontScale;
@@ -124,21 +109,6 @@ extern float kFontSize;
 // unit for velocity
 extern float kVelocityUnit;
 
-// number of directions of a neighbor bubble
-const int kNumNeighborDirections = 12;
-
-struct Ellipse {
-  glm::vec2 center;
-  float a;
-  float b;
-  // Checks if a point is within the ellipse (including the boundary).
-  bool isWithin(const glm::vec2& point) const {
-    return (point.x - center.x) * (point.x - center.x) / (a * a) +
-               (point.y - center.y) * (point.y - center.y) / (b * b) <=
-           1;
-  }
-};
-
 struct Circle {
   glm::vec2 center;
   float radius;
@@ -148,64 +118,33 @@ struct Line {
   float A, B, C;  // Line equation: Ax + By + C = 0
 };
 
-bool areFloatsEqual(float a, float b, float epsilon = 1e-4);
-
-bool areFloatsEqual(const glm::vec2& a, const glm::vec2& b,
-                    float epsilon = 1e-4);
-
-bool areFloatsEqual(const glm::vec3& a, const glm::vec3& b,
-                    float epsilon = 1e-4);
-
-bool areFloatsLess(float a, float b, float epsilon = 1e-4);
-
-bool areFloatsGreater(float a, float b, float epsilon = 1e-4);
-
-// Calculate the length of C using the law of cosines
-float lawOfCosines(float a, float b, float cosgamma);
-
-// Calculate the lengthn of B using the law of cosines
-std::pair<float, float> lawOfCosinesB(float a, float c, float cosgamma);
-
-// Calculate the cosine of the angle using the law of cosines
-float lawOfCosinesCos(float a, float b, float c);
-
-// Calculate the angle using the law of cosines
-float lawOfCosinesAngle(float a, float b, float c);
-
 // Calculate the amount of time to travel a distance with a given velocity
 // glm::vec2
 float timeToTravel(float distance, glm::vec2 velocity);
 
-// Rotate a vector by a given angle around a point. clockwise is positive while
-// counter-clockwise is negative
-glm::vec2 rotateVector(glm::vec2 point, float angle,
-                       glm::vec2 pivot = glm::vec2(0.0f, 0.0f));
-
-// Get the sign of the cross product of two vectors
-int getSignOfCrossProduct(glm::vec2 a, glm::vec2 b);
-
 // Generate a random number with data type T between min and max
 template <typename T>
-T generateRandom(T min, T max) {
+T generateRandom(T min, T max, RandomStream stream = RandomStream::kGameplay) {
   if (min == max) {
     return min;
   } else if (min > max) {
     std::swap(min, max);
   }
   std::uniform_real_distribution<T> distr(min, max);  // Define the range
-  return distr(eng);
+  return distr(Random::Get(stream));
 }
 
 // Generate a random integer between min and max
 template <typename T>
-T generateRandomInt(T min, T max) {
+T generateRandomInt(T min, T max,
+                    RandomStream stream = RandomStream::kGameplay) {
   if (min == max) {
     return min;
   } else if (min > max) {
     std::swap(min, max);
   }
   std::uniform_int_distribution<T> distr(min, max);  // Define the range
-  return distr(eng);
+  return distr(Random::Get(stream));
 }
 
 // Generate a Gaussian random number between min and max.
@@ -222,15 +161,6 @@ int randomWeightedSelect(std::vector<float> weights);
 // Convert color to string
 std::string colorToString(glm::vec4 color);
 
-// Check if two colors are the same
-bool isSameColor(glm::vec3 rgb1, glm::vec3 rgb2);
-
-// Convert a color to a Color enum
-Color colorToEnum(glm::vec3 rgb);
-
-// Color is deep or not
-bool isDeepColor(glm::vec3 rgb);
-
 // ggb to hsv
 glm::vec3 rgb2hsv(glm::vec3 rgb);
 
@@ -255,10 +185,6 @@ bool isPointLowerXThanLine(glm::vec2 point, glm::vec3 lineParams);
 // Check if a point is on a line
 bool isPointOnLine(glm::vec2 point, glm::vec3 lineParams);
 
-// Solve a quadratic equation
-std::optional<std::pair<float, float>> solveQuadratic(float a, float b,
-                                                      float c);
-
 // Solve a two-variable linear equation
 std::optional<std::pair<float, float>> solveTwoVariableLinear(
     float a1, float b1, float c1, float a2, float b2, float c2);
@@ -342,9 +268,9 @@ class ResourceManager {
   // retrieves a stored sader
   Shader GetShader(std::string name);
   // loads (and generates) a texture from file
-  Texture2D LoadTexture(const char* file, bool alpha, std::string name);
+  Texture2D LoadTexture(const char* file, bool alpha, StringId name);
   // retrieves a stored texture
-  Texture2D GetTexture(std::string name);
+  Texture2D GetTexture(StringId name);
 
   // Load text from a json file
   bool LoadText(const char* file);
@@ -384,7 +310,7 @@ class ResourceManager {
   int GetMaxAvailableID();
 
   // Unloads a specific texture
-  void UnloadTexture(const std::string& name);
+  void UnloadTexture(StringId name);
 
   // properly de-allocates all loaded resources
   void Clear();
@@ -392,7 +318,7 @@ class ResourceManager {
  private:
   // resource storage
   std::unordered_map<std::string, Shader> Shaders;
-  std::unordered_map<std::string, Texture2D> Textures;
+  std::unordered_map<StringId, Texture2D> Textures;
   // text storage
   nlohmann::json texts{};
 
@@ -31,7 +31,8 @@ void BackgroundMusicInfo::Refresh() {
   const auto& targetMusicVec =
       (state == BackgroundMusicState::Fighting) ? fightingMusic : relaxingMusic;
   assert(!targetMusicVec.empty() && "No music available");
-  size_t nextMusicIdx = generateRandomInt<size_t>(0, targetMusicVec.size() - 1);
+  size_t nextMusicIdx = generateRandomInt<size_t>(
+      0, targetMusicVec.size() - 1, RandomStream::kAudio);
   while ((targetMusicVec[nextMusicIdx] == currentMusic ||
           targetMusicVec[nextMusicIdx] == lastMusic)) {
     if (targetMusicVec.size() <= 1) {
@@ -114,7 +115,7 @@ SoundEngine::SoundEngine() {
 SoundEngine::~SoundEngine() { Clear(); }
 
 void SoundEngine::CleanUpSources(bool force) {
-  std::vector<std::string> sourceNamesToDelete;
+  std::vector<StringId> sourceNamesToDelete;
   std::unordered_set<ALuint> sourcesVisited;
   for (auto& source : sources_) {
     ALint state;
@@ -200,8 +201,7 @@ void SoundEngine::Update(float dt) {
   RefreshBackgroundMusic(dt);
 }
 
-ALuint SoundEngine::LoadSound(const std::string& name,
-                              const std::string& filename,
+ALuint SoundEngine::LoadSound(StringId name, const std::string& filename,
                               float defaultVolume) {
   enum FormatType sample_format = Int16;
   ALint byteblockalign = 0;
@@ -420,7 +420,7 @@ ALuint SoundEngine::LoadSound(const std::string& name,
   return buffer;
 }
 
-void SoundEngine::UnloadSound(const std::string& name) {
+void SoundEngine::UnloadSound(StringId name) {
   alDeleteBuffers(1, &buffers_.at(name));
   ALenum error = alGetError();
   if (error != AL_NO_ERROR) {
@@ -431,12 +431,13 @@ void SoundEngine::UnloadSound(const std::string& name) {
   play_counts_.erase(name);
 }
 
-int SoundEngine::GetPlayCount(const std::string& sourceName) {
+int SoundEngine::GetPlayCount(StringId sourceName) {
   assert(buffers_.count(sourceName) > 0 && "Sound not found");
-  return play_counts_.count(sourceName) > 0 ? play_counts_.at(sourceName) : 0;
+  auto it = play_counts_.find(sourceName);
+  return it != play_counts_.end() ? it->second : 0;
 }
 
-void SoundEngine::PlaySound(const std::string& name, bool loop, float volume) {
+void SoundEngine::PlaySound(StringId name, bool loop, float volume) {
   auto buffer = buffers_.at(name);
   if (volume < 0.f) {
     volume = default_volumes_.at(name);
@@ -453,9 +454,12 @@ void SoundEngine::PlaySound(const std::string& name, bool loop, float volume) {
   ++play_counts_[name];
 }
 
-void SoundEngine::StopSound(const std::string& name) {
-  auto sources =
-      sources_.at(name);  // Get the source associated with this sound name
+void SoundEngine::StopSound(StringId name) {
+  auto it = sources_.find(name);
+  if (it == sources_.end()) {
+    return;
+  }
+  auto sources = it->second;  // Get the source associated with this sound name
 
   for (const auto& source : sources) {
     // Stop the source
@@ -477,7 +481,7 @@ bool SoundEngine::LoadStream(const std::string& name,
     return false;
   }
   this->SetStreamState(name, StreamState::READY);
-  default_volumes_[name] = defaultVolume;
+  default_volumes_[StringId(name)] = defaultVolume;
   return true;
 }
 
@@ -501,7 +505,7 @@ void SoundEngine::PlayStream(const std::string& name, float volume) {
     ResetStream(name);
   }
   if (volume < 0.f) {
-    volume = default_volumes_.at(name);
+    volume = default_volumes_.at(StringId(name));
   }
   auto& stream = streams_.at(name);
   // Check if there is already a thread for this stream. If so, terminate it.
@@ -529,12 +533,14 @@ void SoundEngine::ResetStream(const std::string& name) {
   this->SetStreamState(name, StreamState::READY);
   streams_.at(name)->Reset();
   // Also reset the volume to the default one
-  this->SetVolume(streams_.at(name)->mSource, default_volumes_.at(name));
+  this->SetVolume(streams_.at(name)->mSource,
+                  default_volumes_.at(StringId(name)));
 }
 
-bool SoundEngine::IsPlaying(const std::string& sourceName) {
-  if (sources_.find(sourceName) != sources_.end()) {
-    ALuint source = sources_[sourceName].back();
+bool SoundEngine::IsPlaying(StringId sourceName) {
+  auto it = sources_.find(sourceName);
+  if (it != sources_.end()) {
+    ALuint source = it->second.back();
     ALint state;
     alGetSourcei(source, AL_SOURCE_STATE, &state);
     return (state == AL_PLAYING);
@@ -561,8 +567,8 @@ bool SoundEngine::IsStreamEnded(const std::string& sourceName) {
   return GetStreamState(sourceName) == StreamState::ENDED;
 }
 
-void SoundEngine::GraduallyChangeVolume(const std::string& sourceName,
-                                        float targetVolume, float duration) {
+void SoundEngine::GraduallyChangeVolume(StringId sourceName, float targetVolume,
+                                        float duration) {
   targetVolume = std::clamp(targetVolume, 0.0f, 1.0f);
   // Check if the source still exists. It may have been removed if the
   // application lost focus for an extended period.
@@ -594,7 +600,7 @@ void SoundEngine::GraduallyChangeStreamVolume(const std::string& sourceName,
       solveQuadratic(curVolume, glm::vec2(duration, targetVolume));
 }
 
-bool SoundEngine::IsGraduallyChangingVolume(const std::string& sourceName) {
+bool SoundEngine::IsGraduallyChangingVolume(StringId sourceName) {
   return gradually_changing_volumes_.find(sourceName) !=
          gradually_changing_volumes_.end();
 }
@@ -606,7 +612,7 @@ bool SoundEngine::IsGraduallyChangingStreamVolume(
 }
 
 void SoundEngine::UpdateSourcesVolume(float dt) {
-  std::vector<std::string> sourceNamesToDelete;
+  std::vector<StringId> sourceNamesToDelete;
   for (auto& sourceName : gradually_changing_volumes_) {
     // If the source is not in the sources map, remove it from the gradually
     // changing volumes map.
@@ -689,20 +695,26 @@ void SoundEngine::UpdateStreamsVolume(float dt) {
   }
 }
 
-void SoundEngine::SetVolume(const std::string& sourceName, float volume) {
-  SetVolume(sources_.at(sourceName).back(), volume);
+void SoundEngine::SetVolume(StringId sourceName, float volume) {
+  auto it = sources_.find(sourceName);
+  if (it != sources_.end()) {
+    SetVolume(it->second.back(), volume);
+  }
+}
+
+float SoundEngine::GetDefaultVolume(StringId sourceName) const {
+  return default_volumes_.at(sourceName);
 }
 
-float SoundEngine::GetVolume(const std::string& sourceName) {
+float SoundEngine::GetVolume(StringId sourceName) {
   return GetVolume(sources_.at(sourceName).back());
 }
 
-float SoundEngine::GetPlaybackPosition(const std::string& sourceName) {
+float SoundEngine::GetPlaybackPosition(StringId sourceName) {
   return GetPlaybackPosition(sources_.at(sourceName).back());
 }
 
-float SoundEngine::GetRemainingTime(const std::string& sourceName,
-                                    float totalDuration) {
+float SoundEngine::GetRemainingTime(StringId sourceName, float totalDuration) {
   return GetRemainingTime(sources_.at(sourceName).back(), totalDuration);
 }
 
@@ -11,6 +11,7 @@
 
 #include "ResourceManager.h"
 #include "StreamPlayer.h"
+#include "StringId.h"
 #include "ThreadHandler.h"
 
 // Declare the external pointer variable
@@ -48,12 +49,13 @@ class SoundEngine {
   // Get the singleton instance
   static SoundEngine& GetInstance();
 
-  ALuint LoadSound(const std::string& name, const std::string& filename,
+  ALuint LoadSound(StringId name, const std::string& filename,
                    float defaultVolume = 1.f);
-  void UnloadSound(const std::string& name);
-  void PlaySound(const std::string& name, bool loop = false,
-                 float volume = -1.f);
-  void StopSound(const std::string& name);
+  void UnloadSound(StringId name);
+  void PlaySound(StringId name, bool loop = false, float volume = -1.f);
+  // Stop a sound. It does nothing if the sound is not playing, so the game
+  // can stop sounds without asking whether they are still playing.
+  void StopSound(StringId name);
 
   // Streaming
   bool LoadStream(const std::string& name, const std::string& filename,
@@ -63,16 +65,16 @@ class SoundEngine {
   void ResetStream(const std::string& name);
 
   // Get count of times a sound has been played
-  int GetPlayCount(const std::string& sourceName);
+  int GetPlayCount(StringId sourceName);
 
   // Gets the current playback position of a sound in seconds
-  float GetPlaybackPosition(const std::string& sourceName);
+  float GetPlaybackPosition(StringId sourceName);
 
   // Gets the remaining time of a sound in seconds
-  float GetRemainingTime(const std::string& sourceName, float totalDuration);
+  float GetRemainingTime(StringId sourceName, float totalDuration);
 
   // Checks if a sound is playing
-  bool IsPlaying(const std::string& sourceName);
+  bool IsPlaying(StringId sourceName);
 
   // Gets stream state
   StreamState GetStreamState(const std::string& sourceName);
@@ -87,7 +89,7 @@ class SoundEngine {
   bool IsStreamEnded(const std::string& sourceName);
 
   // Gradually change the volume of a sound
-  void GraduallyChangeVolume(const std::string& sourceName, float targetVolume,
+  void GraduallyChangeVolume(StringId sourceName, float targetVolume,
                              float duration);
 
   // Gradually change the volume of streams
@@ -95,7 +97,7 @@ class SoundEngine {
                                    float targetVolume, float duration);
 
   // Checks if a sound is gradually changing volume
-  bool IsGraduallyChangingVolume(const std::string& sourceName);
+  bool IsGraduallyChangingVolume(StringId sourceName);
 
   // Checks if a stream is gradually changing volume
   bool IsGraduallyChangingStreamVolume(const std::string& sourceName);
@@ -106,11 +108,14 @@ class SoundEngine {
   // Update the volume of streams that are gradually changing
   void UpdateStreamsVolume(float dt);
 
-  // Sets the volume of a sound
-  void SetVolume(const std::string& sourceName, float volume);
+  // Sets the volume of a sound. It does nothing if the sound is not playing.
+  void SetVolume(StringId sourceName, float volume);
+
+  // Gets the volume a sound is played at by default
+  float GetDefaultVolume(StringId sourceName) const;
 
   // Gets the volume of a sound
-  float GetVolume(const std::string& sourceName);
+  float GetVolume(StringId sourceName);
 
   void SetBackgroundMusicNames(const std::vector<std::string>& music,
                                bool isFighting = false);
@@ -148,7 +153,7 @@ class SoundEngine {
   ALCcontext* context_{nullptr};
   std::string current_device_name_{""};
   bool is_cleared_{false};
-  std::unordered_map<std::string, ALuint> buffers_;  // Map of sound buffers
+  std::unordered_map<StringId, ALuint> buffers_;  // Map of sound buffers
   std::unordered_map<std::string, std::unique_ptr<StreamPlayer>>
       streams_;  // Map of streams
   std::unordered_map<std::string, StreamState>
@@ -156,13 +161,13 @@ class SoundEngine {
   std::mutex stream_states_mutex_;  // Mutex for protecting stream_states_
   std::unordered_map<std::string, std::thread::id>
       stream_thread_ids_;  // Map of stream thread ids
-  std::unordered_map<std::string, float> default_volumes_;  // Map of default
-                                                            // sound volumes
-  std::unordered_map<std::string, std::vector<ALuint>>
-      sources_;                                       // Map of sound sources
-  std::unordered_map<std::string, float> volumes_;    // Map of sound volumes
-  std::unordered_map<std::string, int> play_counts_;  // Map of play counts
-  std::unordered_map<std::string,
+  std::unordered_map<StringId, float> default_volumes_;  // Map of default
+                                                         // sound volumes
+  std::unordered_map<StringId, std::vector<ALuint>>
+      sources_;                                    // Map of sound sources
+  std::unordered_map<StringId, float> volumes_;    // Map of sound volumes
+  std::unordered_map<StringId, int> play_counts_;  // Map of play counts
+  std::unordered_map<StringId,
                      std::unordered_map<ALuint, glm::vec3>>  // Map of gradually
                                                              // changing volumes
       gradually_changing_volumes_;
@@ -0,0 +1,59 @@
+/*
+ * StringId.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "StringId.h"
+
+#ifndef NDEBUG
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+// Names of the ids built at runtime, by hash. The strings live in the nodes of
+// the map, so pointers to them stay valid while the map grows.
+std::unordered_map<uint64_t, std::string>& getNameTable() {
+  static std::unordered_map<uint64_t, std::string> nameTable;
+  return nameTable;
+}
+
+std::mutex& getNameTableMutex() {
+  static std::mutex nameTableMutex;
+  return nameTableMutex;
+}
+
+}  // namespace
+#endif
+
+StringId::StringId(std::string_view name) : hash(Hash(name)) {
+#ifndef NDEBUG
+  std::lock_guard<std::mutex> lock(getNameTableMutex());
+  auto [it, inserted] = getNameTable().try_emplace(hash, name);
+  assert((inserted || it->second == name) &&
+         "Two names have the same string id.");
+  this->name = it->second.c_str();
+#endif
+}
+
+std::string_view StringId::GetName() const {
+#ifndef NDEBUG
+  if (name != nullptr) {
+    return name;
+  }
+#endif
+  return {};
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// StringId names a resource or an entity by the 64-bit FNV-1a hash of its
+// name. Ids of string literals are built at compile time, so a registry keyed
+// by StringId is looked up with a literal without building or hashing a string
+// at runtime. Names only known at runtime are hashed once when the id is built
+// from them.
+//
+// Debug builds keep the name of every id for GetName. Names of ids built at
+// runtime are kept in a table, which also checks that no two of them share a
+// hash.
+class StringId {
+ public:
+  static constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+  static constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+  // Hash a name with 64-bit FNV-1a.
+  static constexpr uint64_t Hash(std::string_view name) {
+    uint64_t hash = kFnvOffsetBasis;
+    for (char c : name) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= kFnvPrime;
+    }
+    return hash;
+  }
+
+  // Build the id of a string literal at compile time.
+  template <size_t N>
+  consteval StringId(const char (&name)[N])
+      : hash(Hash(std::string_view(name, N - 1))) {
+#ifndef NDEBUG
+    this->name = name;
+#endif
+  }
+
+  // Build the id of a name known only at runtime.
+  explicit StringId(std::string_view name);
+
+  uint64_t GetHash() const { return hash; }
+
+  // Get the name of the id. It is empty in release builds.
+  std::string_view GetName() const;
+
+  friend constexpr bool operator==(StringId lhs, StringId rhs) {
+    return lhs.hash == rhs.hash;
+  }
+
+ private:
+  uint64_t hash;
+#ifndef NDEBUG
+  const char* name{nullptr};
+#endif
+};
+
+// Specialize std::hash for StringId. The id is already a hash.
+template <>
+struct std::hash<StringId> {
+  std::size_t operator()(StringId id) const noexcept {
+    return static_cast<std::size_t>(id.GetHash());
+  }
+};
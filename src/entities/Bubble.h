@@ -3,6 +3,7 @@
 
 #include <glm/glm.hpp>
 
+#include "BubbleBoard.h"
 #include "GameObject.h"
 #include "ResourceManager.h"
 
@@ -14,17 +15,6 @@
 //	Purple: (128, 0, 128)
 //	Orange: (255, 165, 0)
 
-// State of the bubble
-
-enum class BubbleState {
-  kNormal,
-  Moving,
-  Static,
-  Falling,
-  Exploding,
-  Undefined,
-};
-
 class Bubble : public GameObject {
  public:
   // Default constructor
@@ -42,12 +32,12 @@ class Bubble : public GameObject {
   // Move assignment operator
   Bubble& operator=(Bubble&& other) noexcept;
 
-  // Move the bubble by the velocity vector. If it penetrates the left, right,
-  // or bottom boundaries, it will bounce off. If it penetrates the top boundary
-  // or it penetrates the static bubbles, its position will be adjusted to the
-  // point of penetration and its velocity will be set to 0.
+  // Move the bubble by the velocity vector. If it hits the left, right, or
+  // bottom boundaries, it will bounce off. If it hits the top boundary or the
+  // static bubbles, it stops at the exact point of contact and its velocity
+  // will be set to 0. See BubbleBoard::MoveShot.
   virtual bool Move(float deltaTime, glm::vec4 boundaries,
-                    std::unordered_map<int, std::unique_ptr<Bubble> >& statics);
+                    const BubbleGrid& statics);
 
   // Move the bubble by the velocity vector. No boundary check.
   void Move(float deltaTime);
@@ -65,9 +65,9 @@ GameBoardState GameBoard::GetState() { return state; }
 void GameBoard::UpdateColor(glm::vec3 rayColor) {
   // If the ray color is Blue, Purple, and red, then the color of the game board
   // should be white to make intense contrast.
-  if (areFloatsEqual(rayColor, colorMap[Color::Blue]) ||
-      areFloatsEqual(rayColor, colorMap[Color::Purple]) ||
-      areFloatsEqual(rayColor, colorMap[Color::Red])) {
+  if (areFloatsEqual(rayColor, toRgb(Color::Blue)) ||
+      areFloatsEqual(rayColor, toRgb(Color::Purple)) ||
+      areFloatsEqual(rayColor, toRgb(Color::Red))) {
     SetColor(glm::vec4(GameBoardColorMap[GameBoardColor::ORIGINAL], 0.9f));
   } else {
     SetColor(glm::vec4(GameBoardColorMap[GameBoardColor::GRAY], 0.9f));
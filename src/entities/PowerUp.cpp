@@ -63,11 +63,11 @@ void PowerUp::SetRadius(float radius) {
 }
 
 bool PowerUp::Move(float deltaTime, glm::vec4 boundaries,
-                   std::unordered_map<int, std::unique_ptr<Bubble> >& statics) {
+                   const BubbleGrid& statics) {
   this->bubblesToBeDestroyed.clear();
+  glm::vec2 startCenter = GetCenter();
   position += velocity * deltaTime;
   isStonePlateHittingBoundary = false;
-  auto& soundEngine = SoundEngine::GetInstance();
   if (position.x < boundaries.x) {
     float deltaX = position.x - boundaries.x;
     float deltaY = velocity.y / velocity.x * deltaX;
@@ -77,7 +77,6 @@ bool PowerUp::Move(float deltaTime, glm::vec4 boundaries,
     // Set the rotation direction of the dagger to the opposite of the current.
     daggerRotationSpeed *= -1.0f;
     isStonePlateHittingBoundary = true;
-    soundEngine.PlaySound("wall_collide");
   } else if (position.x + size.x > boundaries.z) {
     float deltaX = position.x + size.x - boundaries.z;
     float deltaY = velocity.y / velocity.x * deltaX;
@@ -87,7 +86,6 @@ bool PowerUp::Move(float deltaTime, glm::vec4 boundaries,
     // Set the rotation direction of the dagger to the opposite of the current.
     daggerRotationSpeed *= -1.0f;
     isStonePlateHittingBoundary = true;
-    soundEngine.PlaySound("wall_collide");
   }
   if (position.y < boundaries.y) {
     float deltaY = position.y - boundaries.y;
@@ -96,7 +94,6 @@ bool PowerUp::Move(float deltaTime, glm::vec4 boundaries,
     position.x -= deltaX;
     velocity.y *= -1.0f;
     isStonePlateHittingBoundary = true;
-    soundEngine.PlaySound("wall_collide");
   } else if (position.y + size.y > boundaries.w) {
     float deltaY = position.y + size.y - boundaries.w;
     float deltaX = velocity.x / velocity.y * deltaY;
@@ -104,29 +101,32 @@ bool PowerUp::Move(float deltaTime, glm::vec4 boundaries,
     position.x -= deltaX;
     velocity.y *= -1.0f;
     isStonePlateHittingBoundary = true;
-    soundEngine.PlaySound("wall_collide");
   }
 
-  // Check penetration with static bubbles
-  for (auto& staticBubble : statics) {
-    glm::vec2 staticCenter = staticBubble.second->GetCenter();
-    float staticRadius = staticBubble.second->GetRadius();
-    // If the distance between the static bubble and the powerup is less than
-    // the sum of their radius, then the bubble is penetrating the static
-    // bubble.
-    float distance = glm::distance(GetCenter(), staticCenter);
-    if (distance < radius + staticRadius) {
-      this->bubblesToBeDestroyed.emplace_back(staticBubble.first);
-    }
-  }
+  // A boundary stops the step at the point where the power up touches it, so
+  // the power up moves along the straight segment from startCenter to center
+  // in this step. Every static bubble it sweeps over is penetrated, not only
+  // those it overlaps at the end of the step, so a fast power up cannot skip
+  // a bubble. Memorize the fractions of the step at which they are touched to
+  // sort the bubbles later.
+  glm::vec2 center = GetCenter();
+  std::vector<std::pair<float, int>> penetrated;
+  statics.ForEachNearSegment(
+      startCenter, center, 2 * radius,
+      [&](const BubbleGrid::Entry& staticBubble) {
+        std::optional<float> t = sweptCircleTimeOfImpact(
+            startCenter, center - startCenter, staticBubble.center,
+            radius + staticBubble.radius);
+        if (t.has_value()) {
+          penetrated.emplace_back(t.value(), staticBubble.id);
+        }
+      });
   this->SetPosition(position);
-  // Sort the bubbles to be destroyed based on their distance to the powerup
-  // in ascending order
-  std::sort(this->bubblesToBeDestroyed.begin(),
-            this->bubblesToBeDestroyed.end(), [this, &statics](int a, int b) {
-              return glm::distance(statics[a]->GetCenter(), GetCenter()) <
-                     glm::distance(statics[b]->GetCenter(), GetCenter());
-            });
+  // Sort the bubbles to be destroyed in the order the powerup touches them.
+  std::sort(penetrated.begin(), penetrated.end());
+  for (auto& [timeOfImpact, id] : penetrated) {
+    this->bubblesToBeDestroyed.emplace_back(id);
+  }
   if (this->bubblesToBeDestroyed.size() > numOfDaggers) {
     assert(numOfDaggers > 0 &&
            "The number of daggers should be greater than 0.");
@@ -42,9 +42,8 @@ class PowerUp : public Bubble {
 
   // Move the bubble by the velocity vector. If it penetrates the wall
   // boundaries, it will bounce off. If it penetrates the top boundary.
-  bool Move(
-      float deltaTime, glm::vec4 boundaries,
-      std::unordered_map<int, std::unique_ptr<Bubble> >& statics) override;
+  bool Move(float deltaTime, glm::vec4 boundaries,
+            const BubbleGrid& statics) override;
 
   bool IsStonePlateHittingBoundary() const;
 
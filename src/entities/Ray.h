@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "AimPath.h"
 #include "Bubble.h"
 #include "RayRenderer.h"
 
@@ -30,9 +31,17 @@ class Ray {
   void SetPosition(glm::vec2 pos);
   void SetColor(glm::vec4 rgb);
 
-  // Update the ray's path.
-  void UpdatePath(glm::vec4 boundaries,
-                  std::unordered_map<int, std::unique_ptr<Bubble> >& statics);
+  // Update the ray's path. The path is cached and only recomputed if it has
+  // been marked dirty or the boundaries differ from the last computation. See
+  // traceAimPath.
+  void UpdatePath(glm::vec4 boundaries, const BubbleGrid& statics);
+
+  // Mark the cached path as outdated. It should be called whenever the static
+  // bubbles change. Changing the start or the direction marks it implicitly.
+  void MarkPathDirty();
+
+  // Check if the cached path is outdated.
+  bool IsPathDirty() const;
 
   // Draw the ray.
   void Draw(std::shared_ptr<RayRenderer> RayRenderer);
@@ -42,13 +51,8 @@ class Ray {
   glm::vec2 direction{0.f, 0.f};
   std::vector<glm::vec2> path;
   glm::vec4 color{1.f, 1.f, 1.f, 1.f};
-
-  // Get the point of collision between the ray and the wall.
-  glm::vec2 GetWallCollisionPoint(glm::vec2 pos, glm::vec2 dir,
-                                  glm::vec4 boundaries);
-
-  // Get the point of collision between the ray and the bubble.
-  std::vector<glm::vec2> GetBubbleCollisionPoint(
-      glm::vec2 pos, glm::vec2 dir,
-      std::unordered_map<int, std::unique_ptr<Bubble> >& statics);
+  // Whether the path needs to be recomputed.
+  bool isPathDirty{true};
+  // The boundaries used for the last computation of the path.
+  glm::vec4 pathBoundaries{0.f};
 };
\ No newline at end of file
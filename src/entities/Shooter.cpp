@@ -68,6 +68,12 @@ void Shooter::EquipPowerUp(std::unique_ptr<PowerUp> powerUp) {
   SoundEngine::GetInstance().PlaySound("equip", false);
 }
 
+void Shooter::UnequipPowerUp() {
+  assert(HasPowerUp() && "The carried bubble is not a power up.");
+  carriedBubble = std::make_unique<Bubble>(*carriedBubble);
+  carriedBubble->SetTexture(nextBubble->GetTexture());
+}
+
 std::unique_ptr<Bubble> Shooter::ShootBubble(glm::vec4 nextBubbleColor) {
   //  Play the sound effect for shooting a bubble
   SoundEngine::GetInstance().PlaySound("bubble_pop", false);
@@ -133,44 +139,38 @@ glm::vec2 Shooter::GetShootingDirection() const {
 
 glm::vec4 Shooter::GetNewBubbleColor() const {
   // Get a random color from Color predefined in the resource manager
-  int randomColorIdx =
-      generateRandomInt<int>(0, static_cast<int>(colorMap.size()) - 1);
+  int randomColorIdx = generateRandomInt<int>(0, kNumColors - 1);
   Color randomColor = static_cast<Color>(randomColorIdx);
   // Set the color
-  return glm::vec4(colorMap[randomColor], nextBubble->GetColor().a);
+  return glm::vec4(toRgb(randomColor), nextBubble->GetColor().a);
 }
 
 glm::vec4 Shooter::GetNewBubbleColor(
     const std::unordered_map<int, std::unique_ptr<Bubble>>& statics) {
-  // Create a color map for each color's probability
-  std::unordered_map<Color, float> colorProbalibity;
-  // Iterate thourgh the color map and initialize the probability for each color
-  // to 0
-  float total = 0.0f;
-  for (auto color : colorMap) {
-    colorProbalibity[color.first] = 0.5f;
-    total += 0.5f;
-  }
+  // Initialize the probability of each color of the palette to 0.5
+  ColorArray<float> colorProbalibity;
+  colorProbalibity.fill(0.5f);
+  float total = 0.5f * kNumColors;
   // Iterate through the static bubbles and count the number of each color
   for (auto& bubble : statics) {
     Color color = bubble.second->GetColorEnum();
-    if (areFloatsEqual(colorProbalibity[color], 0.5f)) {
-      colorProbalibity[color] = 1.5f;
+    if (areFloatsEqual(colorProbalibity[toIndex(color)], 0.5f)) {
+      colorProbalibity[toIndex(color)] = 1.5f;
       total += 1.f;
     }
   }
   // Create a random float between 0 and total
   int random = generateRandom(0.f, total);
-  // Iterate through the color map and find the color that the random float
+  // Iterate through the palette and find the color that the random float
   // falls into
   float sum = 0.0f;
-  for (auto color : colorProbalibity) {
-    sum += color.second;
+  for (int i = 0; i < kNumColors; ++i) {
+    sum += colorProbalibity[i];
     if (random <= sum) {
-      return glm::vec4(colorMap[color.first], nextBubble->GetColor().a);
+      return glm::vec4(toRgb(static_cast<Color>(i)), nextBubble->GetColor().a);
     }
   }
-  return glm::vec4(colorMap[Color::White], nextBubble->GetColor().a);
+  return glm::vec4(toRgb(Color::White), nextBubble->GetColor().a);
 }
 
 const Bubble& Shooter::GetCarriedBubble() const { return *carriedBubble; }
@@ -179,7 +179,7 @@ const Bubble& Shooter::GetNextBubble() const { return *nextBubble; }
 
 void Shooter::UpdateCarriedBubbleRadius(float radius) {
   // Update the radius for the carried bubble
-  carriedBubble->SetRadius(kBubbleRadius);
+  carriedBubble->SetRadius(radius);
 }
 
 void Shooter::SwapCarriedBubbleAndNextBubble() {
@@ -35,6 +35,9 @@ class Shooter : public GameObject {
   // Equips the power up to the shooter.
   void EquipPowerUp(std::unique_ptr<PowerUp> powerUp);
 
+  // Replaces the carried power up with a bubble of its color.
+  void UnequipPowerUp();
+
   // Shoots the bubble that the shooter is carrying.
   std::unique_ptr<Bubble> ShootBubble(glm::vec4 nextBubbleColor);
 
@@ -27,17 +27,20 @@ void ExplosionSystem::CreateExplosion(glm::vec2 center, glm::vec4 color,
                                       float explosionPointRadiusX,
                                       float explosionPointRadiusY,
                                       glm::vec2 scaleRange) {
-  for (unsigned int i = 0; i < numParticles; ++i) {
+  // Draw the random values of all the particles at once: two for the
+  // position, two for the velocity, one for the lifespan and one for the scale.
+  constexpr int kValuesPerParticle = 6;
+  const float* values = drawRandomValues(numParticles * kValuesPerParticle);
+  for (unsigned int i = 0; i < numParticles;
+       ++i, values += kValuesPerParticle) {
     int unusedParticle = this->firstUnusedParticle();
     this->particles[unusedParticle].position = center;
     if (explosionPointRadiusX > 0.f) {
       if (explosionPointRadiusY < 0.f) {
         // Get a random position from the center of the explosion within a
         // circle with radius explosionPointRadiusX
-        float angle = static_cast<float>(rand()) /
-                      static_cast<float>(RAND_MAX) * 2 * glm::pi<float>();
-        float radius = static_cast<float>(rand()) /
-                       static_cast<float>(RAND_MAX) * explosionPointRadiusX;
+        float angle = values[0] * 2 * glm::pi<float>();
+        float radius = values[1] * explosionPointRadiusX;
         glm::vec2 offset =
             glm::vec2(radius * std::cos(angle), radius * std::sin(angle));
         this->particles[unusedParticle].position += offset;
@@ -46,8 +49,7 @@ void ExplosionSystem::CreateExplosion(glm::vec2 center, glm::vec4 color,
           // Get a random position from the center of the explosion within a
           // line with length explosionPointRadiusX The offset can be either
           // positive or negative
-          float x = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) *
-                        2 * explosionPointRadiusX -
+          float x = values[0] * 2 * explosionPointRadiusX -
                     explosionPointRadiusX;
           glm::vec2 offset = glm::vec2(x, 0.f);
           this->particles[unusedParticle].position += offset;
@@ -56,22 +58,21 @@ void ExplosionSystem::CreateExplosion(glm::vec2 center, glm::vec4 color,
           // rectangle with width 2*explosionPointRadiusX and height
           // 2*explosionPointRadiusY The offset can be either positive or
           // negative
-          float x = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) *
-                        2 * explosionPointRadiusX -
+          float x = values[0] * 2 * explosionPointRadiusX -
                     explosionPointRadiusX;
-          float y = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) *
-                        2 * explosionPointRadiusY -
+          float y = values[1] * 2 * explosionPointRadiusY -
                     explosionPointRadiusY;
           glm::vec2 offset = glm::vec2(x, y);
           this->particles[unusedParticle].position += offset;
         }
       }
     }
-    this->particles[unusedParticle].velocity = getRandomVelocity();
+    this->particles[unusedParticle].velocity = getRandomVelocity(values + 2);
     this->particles[unusedParticle].color = slightlyVaryColor(color);
     this->particles[unusedParticle].isDeepColor = isDeepColor;
-    this->particles[unusedParticle].lifespan = getRandomLifespan();
-    this->particles[unusedParticle].scale = getRandomScale(scaleRange);
+    this->particles[unusedParticle].lifespan = getRandomLifespan(values[4]);
+    this->particles[unusedParticle].scale =
+        getRandomScale(scaleRange, values[5]);
   }
 }
 
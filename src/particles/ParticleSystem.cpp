@@ -18,6 +18,8 @@
 
 #include "ParticleSystem.h"
 
+#include "Random.h"
+
 ParticleSystem::ParticleSystem(Shader shader, Texture2D texture,
                                unsigned int amount)
     : shader(shader), texture(texture), amount(amount) {
@@ -142,24 +144,32 @@ glm::vec4 ParticleSystem::slightlyVaryColor(glm::vec4 color) {
   return glm::vec4(newR, newG, newB, newA);
 }
 
-glm::vec2 ParticleSystem::getRandomVelocity() {
+const float* ParticleSystem::drawRandomValues(size_t count) {
+  if (randomValues.size() < count) {
+    randomValues.resize(count);
+  }
+  Random::Get(RandomStream::kParticles).FillUniform(randomValues.data(), count);
+  return randomValues.data();
+}
+
+glm::vec2 ParticleSystem::getRandomVelocity(const float* values) {
   // Get a random velocity from 0 to 8*kVelocityUnit, the difference between
   // random velocities is 0.5*kVelocityUnit
-  float velocity = 0.5 * (rand() % 16) * kVelocityUnit;
-  float angle = (rand() % 360) * (glm::pi<float>() / 180.0f);
+  float velocity = 0.5 * std::floor(values[0] * 16) * kVelocityUnit;
+  float angle = std::floor(values[1] * 360) * (glm::pi<float>() / 180.0f);
   float vx = velocity * cos(angle);
   float vy = velocity * sin(angle);
   return glm::vec2(vx, vy);
 }
 
-float ParticleSystem::getRandomLifespan() {
+float ParticleSystem::getRandomLifespan(float value) {
   // Get a random lifespan from 1.0 to 3.0
-  return 1.0f + (rand() % 200) / 100.0f;
+  return 1.0f + std::floor(value * 200) / 100.0f;
 }
 
-float ParticleSystem::getRandomScale(glm::vec2 scaleRange) {
+float ParticleSystem::getRandomScale(glm::vec2 scaleRange, float value) {
   // Get a random scale from scaleRange.x to scaleRange.y
-  return generateRandom(scaleRange.x, scaleRange.y);
+  return scaleRange.x + (scaleRange.y - scaleRange.x) * value;
 }
 
 void ParticleSystem::SetShader(Shader shader) { this->shader = shader; }
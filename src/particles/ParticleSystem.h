@@ -43,6 +43,8 @@ class ParticleSystem {
  protected:
   // state
   std::vector<Particle> particles;
+  // Random values drawn in bulk for spawning particles.
+  std::vector<float> randomValues;
   unsigned int amount{3000};
   // render state
   Shader shader;
@@ -55,10 +57,13 @@ class ParticleSystem {
   // returns the first Particle index that's currently unused e.g. Life <= 0.0f
   // or 0 if no particle is currently inactive
   unsigned int firstUnusedParticle();
-  // Get a random velocity
-  glm::vec2 getRandomVelocity();
-  // Get a random lifespan
-  float getRandomLifespan();
-  // Get a random scale
-  float getRandomScale(glm::vec2 scaleRange = glm::vec2(1.f, 5.f));
+  // Draw count values uniformly from [0, 1) from the particle stream into
+  // randomValues and return them.
+  const float* drawRandomValues(size_t count);
+  // Get a random velocity out of two values drawn uniformly from [0, 1).
+  glm::vec2 getRandomVelocity(const float* values);
+  // Get a random lifespan out of a value drawn uniformly from [0, 1).
+  float getRandomLifespan(float value);
+  // Get a random scale out of a value drawn uniformly from [0, 1).
+  float getRandomScale(glm::vec2 scaleRange, float value);
 };
\ No newline at end of file
@@ -40,20 +40,23 @@ void ShadowTrailSystem::respawnParticles(GameObject& object, int numParticles,
                                          glm::vec2 velocity,
                                          glm::vec2 scaleRange,
                                          glm::vec2 offset) {
-  for (unsigned int i = 0; i < numParticles; ++i) {
+  // Draw the random values of all the particles at once: two for the
+  // position, one for the color and one for the scale.
+  constexpr int kValuesPerParticle = 4;
+  const float* values = drawRandomValues(numParticles * kValuesPerParticle);
+  for (unsigned int i = 0; i < numParticles;
+       ++i, values += kValuesPerParticle) {
     int unusedParticle = this->firstUnusedParticle();
     float randomMaxScale = 2.5f;
     // Create a random X that is from -randomMaxScale * kBaseUnit to
     // randomMaxScale * kBaseUnit
-    float randomX = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) *
-                        randomMaxScale * 2 * kBaseUnit -
+    float randomX = values[0] * randomMaxScale * 2 * kBaseUnit -
                     randomMaxScale * kBaseUnit;
     // Create a random Y that is from -randomMaxScale * kBaseUnit to
     // randomMaxScale * kBaseUnit
-    float randomY = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) *
-                        randomMaxScale * 2 * kBaseUnit -
+    float randomY = values[1] * randomMaxScale * 2 * kBaseUnit -
                     randomMaxScale * kBaseUnit;
-    float rColor = 0.5f + ((rand() % 100) / 100.0f);
+    float rColor = 0.5f + std::floor(values[2] * 100) / 100.0f;
     this->particles[unusedParticle].position =
         object.GetPosition() + glm::vec2(randomX, randomY) + offset;
     /* this->particles[unusedParticle].position = object.GetPosition();*/
@@ -63,7 +66,8 @@ void ShadowTrailSystem::respawnParticles(GameObject& object, int numParticles,
     /* this->particles[unusedParticle].color = slightlyVaryColor(color);*/
     this->particles[unusedParticle].lifespan = 1.0f;
     this->particles[unusedParticle].velocity = velocity;
-    this->particles[unusedParticle].scale = getRandomScale(scaleRange);
+    this->particles[unusedParticle].scale =
+        getRandomScale(scaleRange, values[3]);
     this->particles[unusedParticle].fadeOutSpeed =
         0.6f * glm::length(velocity) / kBaseUnit + 0.4f;
   }
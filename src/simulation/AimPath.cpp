@@ -0,0 +1,185 @@
+/*
+ * AimPath.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AimPath.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+std::vector<glm::vec2> traceAimPath(glm::vec2 start, glm::vec2 dir,
+                                    glm::vec4 boundaries,
+                                    const BubbleGrid& statics,
+                                    float bubbleRadius) {
+  std::vector<glm::vec2> path;
+  path.emplace_back(start);
+  glm::vec2 currentPos = start;
+  glm::vec2 currentDir = dir;
+
+  // Iterate through the path of the ray until it hits a static bubble or the
+  // the upper wall.
+  std::vector<glm::vec2> collisionWithBubble =
+      getBubbleCollisionPoints(currentPos, currentDir, statics);
+  glm::vec2 collisionWithWall;
+  int count = 0;
+  while (collisionWithBubble.empty()) {
+    collisionWithWall =
+        getWallCollisionPoint(currentPos, currentDir, boundaries);
+    path.emplace_back(collisionWithWall);
+    if (++count == 6) {
+      return path;
+    }
+    // If the ray hits the upper wall, then the path ends.
+    if (areFloatsEqual(collisionWithWall.y, boundaries.y)) {
+      return path;
+    }
+    // Get the new direction of the ray after it bounces off the wall.
+    glm::vec2 offsetPoint = collisionWithWall;
+    if (areFloatsEqual(collisionWithWall.x, boundaries.x) ||
+        areFloatsEqual(collisionWithWall.x, boundaries.z)) {
+      // When the bubble (treated as a ray for simulation) collides with a wall,
+      // it doesn't follow the exact reflection rule of a ray due to its area
+      // size. To more accurately depict this interaction, an offset (yOffset)
+      // is applied based on the bubble's radius and the direction of movement.
+      float yOffset =
+          -2.f * bubbleRadius / std::abs(currentDir.x) * currentDir.y;
+      offsetPoint =
+          glm::vec2(collisionWithWall.x, collisionWithWall.y + yOffset);
+      path.emplace_back(offsetPoint);
+      currentDir.x = -currentDir.x;
+    }
+    if (areFloatsEqual(collisionWithWall.y, boundaries.w)) {
+      // To more accurately depict this interaction, an offset (xOffset)
+      //  is applied based on the bubble's radius and the direction of movement.
+      float xOffset =
+          -2.f * bubbleRadius / std::abs(currentDir.y) * currentDir.x;
+      offsetPoint =
+          glm::vec2(collisionWithWall.x + xOffset, collisionWithWall.y);
+      path.emplace_back(offsetPoint);
+      currentDir.y = -currentDir.y;
+    }
+    currentPos = offsetPoint;
+    collisionWithBubble =
+        getBubbleCollisionPoints(currentPos, currentDir, statics);
+  }
+  // If the ray hits a static bubble, then the path ends.
+  if (collisionWithBubble.empty()) {
+    return path;
+  }
+  path.emplace_back(collisionWithBubble[0]);
+  return path;
+}
+
+glm::vec2 getWallCollisionPoint(glm::vec2 pos, glm::vec2 dir,
+                                glm::vec4 boundaries) {
+  // Calculate the paramters of the line equation. Ax + By + C = 0
+  float A = dir.y;
+  // If A == 0, then the line is horizontal. The line will only possible to
+  // collide with the left or right boundary.
+  if (areFloatsEqual(A, 0.f)) {
+    return dir.x > 0 ? glm::vec2(boundaries.z, pos.y)
+                     : glm::vec2(boundaries.x, pos.y);
+  }
+  float B = -dir.x;
+  // If B == 0, then the line is vertical. The line will only possible to
+  // collide with the upper and lower boundary.
+  if (areFloatsEqual(B, 0.f)) {
+    return dir.y > 0 ? glm::vec2(pos.x, boundaries.w)
+                     : glm::vec2(pos.x, boundaries.y);
+  }
+  float C = -A * pos.x - B * pos.y;
+  // Calculate the intersection point between the line and the left boundary.
+  float y = -(C + A * boundaries.x) / B;
+  if (dir.x < 0 && y >= boundaries.y && y <= boundaries.w) {
+    return glm::vec2(boundaries.x, y);
+  }
+
+  // Calculate the intersection point between the line and the right boundary.
+  y = -(C + A * boundaries.z) / B;
+  if (dir.x > 0 && y >= boundaries.y && y <= boundaries.w) {
+    return glm::vec2(boundaries.z, y);
+  }
+
+  // Calculate the intersection point between the line and the upper boundary.
+  float x = -(C + B * boundaries.y) / A;
+  if (dir.y < 0 && x >= boundaries.x && x <= boundaries.z) {
+    return glm::vec2(x, boundaries.y);
+  }
+
+  // Calculate the intersection point between the line and the lower boundary.
+  x = -(C + B * boundaries.w) / A;
+  assert(dir.y > 0 && x >= boundaries.x && x <= boundaries.z &&
+         "The ray must cross one of the boundaries.");
+
+  return glm::vec2(x, boundaries.w);
+}
+
+std::vector<glm::vec2> getBubbleCollisionPoints(glm::vec2 pos, glm::vec2 dir,
+                                                const BubbleGrid& statics) {
+  glm::vec2 normalizedDir = glm::normalize(dir);
+
+  // March through the cells along the ray to find the closest collision
+  // point. a is the distance between the line and the center of the bubble.
+  // b is the distance between the middle of the intersection points and the
+  // start position of the ray. c is the distance between the center of the
+  // bubble and the start position of the ray. distPG is the distance between
+  // the start position of the ray and the first intersection point, which
+  // also bounds how far the march has to go.
+  float distPG = std::numeric_limits<float>::max();
+  float distGM = 0.f;
+  float b = 0.f;
+  statics.MarchRay(
+      pos, normalizedDir, distPG, [&](const BubbleGrid::Entry& bubble) {
+        // vector from the start position of the ray to the center of the
+        // bubble.
+        glm::vec2 PO = bubble.center - pos;
+        float curB = glm::dot(PO, normalizedDir);
+        if (curB < 0.f) {
+          return;
+        }
+        // Calculate the squared distance between the line and the bubble.
+        float squaredC = glm::dot(PO, PO);
+        float squaredA = std::max(squaredC - curB * curB, 0.f);
+        float squaredRadius = bubble.radius * bubble.radius;
+        if (squaredA > squaredRadius) {
+          return;
+        }
+        // Get distance between the intersection point (G, H) and the middle
+        // of the intersection points (M).
+        float curDistGM = std::sqrt(squaredRadius - squaredA);
+        if (curB - curDistGM < distPG) {
+          distPG = curB - curDistGM;
+          distGM = curDistGM;
+          b = curB;
+        }
+      });
+  if (distPG == std::numeric_limits<float>::max()) {
+    return std::vector<glm::vec2>();
+  }
+
+  // Get the distance between the start position of the ray (P) and the
+  // intersection points (G, H).
+  float distPH = b + distGM;
+
+  // Get the intersection points (G, H).
+  glm::vec2 G = pos + distPG * normalizedDir;
+  glm::vec2 H = pos + distPH * normalizedDir;
+
+  return std::vector<glm::vec2>{G, H};
+}
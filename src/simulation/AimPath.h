@@ -0,0 +1,26 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "BubbleGrid.h"
+#include "SimulationUtils.h"
+
+// Trace the aim ray of a bubble of the given radius shot from start along dir.
+// The ray bounces off the walls of the boundaries (left, upper, right, lower)
+// and ends at the first static bubble it hits or at the upper wall. The
+// returned points are the path of the ray, starting with start.
+std::vector<glm::vec2> traceAimPath(glm::vec2 start, glm::vec2 dir,
+                                    glm::vec4 boundaries,
+                                    const BubbleGrid& statics,
+                                    float bubbleRadius);
+
+// Get the point of collision between the ray and the wall.
+glm::vec2 getWallCollisionPoint(glm::vec2 pos, glm::vec2 dir,
+                                glm::vec4 boundaries);
+
+// Get the points where the ray enters and leaves the closest static bubble it
+// hits, or nothing if it hits none. Only the cells of the grid along the ray
+// are visited, and the walk stops at the first cell beyond the closest
+// collision found so far.
+std::vector<glm::vec2> getBubbleCollisionPoints(glm::vec2 pos, glm::vec2 dir,
+                                                const BubbleGrid& statics);
@@ -0,0 +1,74 @@
+/*
+ * BatchSimulation.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "BatchSimulation.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "WorkStealingPool.h"
+
+double BatchSimulationReport::GetShotsPerSecond() const {
+  return seconds > 0.0 ? numShots / seconds : 0.0;
+}
+
+double BatchSimulationReport::GetLevelsPerSecond() const {
+  return seconds > 0.0 ? results.size() / seconds : 0.0;
+}
+
+BatchSimulationReport runBatchSimulation(const BatchSimulationParams& params) {
+  BatchSimulationReport report;
+  report.results.resize(params.numSimulations);
+  // Give every simulation a stream of its own.
+  std::vector<Xoshiro256> rngs;
+  rngs.reserve(params.numSimulations);
+  Xoshiro256 rng(params.seed);
+  for (int i = 0; i < params.numSimulations; ++i) {
+    rngs.push_back(rng);
+    rng.Jump();
+  }
+
+  WorkStealingPool pool(params.numThreads);
+  report.numThreads = pool.GetNumThreads();
+  auto start = std::chrono::steady_clock::now();
+  pool.ParallelFor(params.numSimulations, [&](size_t index, int) {
+    SimulationResult& result = report.results[index];
+    HeadlessGame game(params.level, params.difficulty, rngs[index],
+                      params.shotPolicy);
+    const BubbleStore& bubbles = game.GetBoard().GetStore();
+    result.peakStaticBubbles = bubbles.Count(BubbleState::Static);
+    while (result.outcome == LevelOutcome::kPlaying &&
+           result.stats.numTicks < params.maxTicksPerLevel) {
+      result.outcome = game.Tick(result.stats);
+      result.peakStaticBubbles = std::max(result.peakStaticBubbles,
+                                          bubbles.Count(BubbleState::Static));
+    }
+    result.boardHash = game.GetBoard().Hash();
+  });
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  report.seconds = elapsed.count();
+
+  for (const SimulationResult& result : report.results) {
+    report.numTicks += result.stats.numTicks;
+    report.numShots += result.stats.numShots;
+    report.numCleared += result.stats.numLevelsCleared;
+    report.numFailed += result.stats.numLevelsFailed;
+  }
+  return report;
+}
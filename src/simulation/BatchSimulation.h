@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "HeadlessGame.h"
+#include "LevelRules.h"
+
+// Parameters of a batch of headless plays of a level.
+struct BatchSimulationParams {
+  int numSimulations{1};
+  int level{1};
+  Difficulty difficulty{Difficulty::EASY};
+  ShotPolicy shotPolicy{ShotPolicy::kRandom};
+  uint64_t seed{0};
+  // Number of threads to play on. 0 uses a thread per hardware thread.
+  int numThreads{0};
+  // Ticks after which a level that is neither cleared nor failed is given up.
+  int64_t maxTicksPerLevel{HeadlessGame::kTickRate * 60 * 10};
+};
+
+// Result of a headless play of a level. The outcome is kPlaying if the level
+// was given up.
+struct SimulationResult {
+  LevelOutcome outcome{LevelOutcome::kPlaying};
+  HeadlessStats stats;
+  uint64_t boardHash{0};
+  // Largest number of static bubbles on the board at the end of a tick.
+  size_t peakStaticBubbles{0};
+};
+
+// Results of a batch of headless plays, in the order of the simulations.
+struct BatchSimulationReport {
+  std::vector<SimulationResult> results;
+  int numThreads{1};
+  double seconds{0.0};
+  int64_t numTicks{0};
+  int64_t numShots{0};
+  int numCleared{0};
+  int numFailed{0};
+
+  double GetShotsPerSecond() const;
+  double GetLevelsPerSecond() const;
+};
+
+// Play the level of the parameters to its end numSimulations times, spread
+// over the threads of a work-stealing pool. Every simulation owns its game
+// and a random number generator jumped apart from those of the other
+// simulations, so the results only depend on the seed and not on the number
+// of threads.
+BatchSimulationReport runBatchSimulation(const BatchSimulationParams& params);
@@ -0,0 +1,466 @@
+/*
+ * BubbleBoard.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "BubbleBoard.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+
+namespace {
+
+// Fold the bytes of a dense array into a 64-bit FNV-1a hash.
+template <typename T>
+uint64_t hashArray(uint64_t hash, const std::vector<T>& values) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+  for (size_t i = 0; i < values.size() * sizeof(T); ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+}  // namespace
+
+void BubbleBoard::Resize(glm::vec4 boundaries, float bubbleRadius) {
+  this->boundaries = boundaries;
+  this->bubbleRadius = bubbleRadius;
+  for (int i = 0; i < kNumNeighborDirections; ++i) {
+    float angle = glm::radians(360.f * i / kNumNeighborDirections);
+    neighborOffsets[i] =
+        2 * bubbleRadius * glm::vec2(std::cos(angle), std::sin(angle));
+  }
+  // The cells of the grid are as large as a bubble, so the grid has to be
+  // resized whenever the bubble radius changes.
+  grid.Reset(boundaries, 2 * bubbleRadius);
+  RebuildGrid();
+}
+
+void BubbleBoard::Clear() {
+  bubbles.Clear();
+  grid.Clear();
+}
+
+void BubbleBoard::ClearStatics() {
+  bubbles.DestroyAll(BubbleState::Static);
+  grid.Clear();
+}
+
+void BubbleBoard::LoadLayout(const LevelLayout& layout) {
+  for (size_t i = 0; i < layout.centers.size(); ++i) {
+    Attach(layout.centers[i], layout.bubbleRadius, layout.colors[i]);
+  }
+}
+
+int BubbleBoard::Attach(glm::vec2 center, float radius, Color color) {
+  int id = bubbles.Create(center, radius, glm::vec2(0.f), color,
+                          BubbleState::Static);
+  grid.Insert(id, center, radius);
+  return id;
+}
+
+bool BubbleBoard::IsNeighbor(glm::vec2 center, glm::vec2 otherCenter,
+                             float absError) const {
+  return areFloatsEqual(glm::distance(center, otherCenter), 2 * bubbleRadius,
+                        absError);
+}
+
+std::vector<int> BubbleBoard::GetNeighborIds(glm::vec2 center,
+                                             float absError) const {
+  std::vector<int> neighborIds;
+  grid.ForEachNear(center, 2 * bubbleRadius + absError,
+                   [&](const BubbleGrid::Entry& entry) {
+                     if (IsNeighbor(entry.center, center, absError)) {
+                       neighborIds.push_back(entry.id);
+                     }
+                   });
+  return neighborIds;
+}
+
+bool BubbleBoard::IsAtUpperBoundary(glm::vec2 position,
+                                    float upperBoundary) const {
+  return areFloatsEqual(position.y, upperBoundary, 1.f);
+}
+
+bool BubbleBoard::HasReachedShooter(glm::vec2 carriedCenter,
+                                    float carriedRadius,
+                                    float upperBoundary) const {
+  if (areFloatsLess(carriedCenter.y - carriedRadius, upperBoundary)) {
+    return true;
+  }
+  bool isOverlapping = false;
+  grid.ForEachNear(carriedCenter, carriedRadius + bubbleRadius,
+                   [&](const BubbleGrid::Entry& entry) {
+                     float distance = carriedRadius + entry.radius;
+                     glm::vec2 diff = entry.center - carriedCenter;
+                     if (glm::dot(diff, diff) < distance * distance) {
+                       isOverlapping = true;
+                     }
+                   });
+  return isOverlapping;
+}
+
+std::vector<int> BubbleBoard::FindConnectedBubblesOfSameColor(int id) const {
+  // bubble should be in the statics.
+  assert(bubbles.Contains(id) && "Failed to find the bubble by ID.");
+  std::vector<int> connectedBubbleIds;
+  // Mark the visited bubbles by the slot indices of their ids.
+  std::vector<bool> visited(bubbles.GetSlotCapacity(), false);
+  // Get the color of the bubble
+  Color color = bubbles.GetColor(id);
+  // Use BFS to find all connected bubbles of the same color
+  std::queue<int> q;
+  q.emplace(id);
+  while (!q.empty()) {
+    int currentId = q.front();
+    q.pop();
+    // If the current id has already been visited, then we skip it.
+    if (visited[BubbleStore::GetSlotIndex(currentId)]) {
+      continue;
+    }
+    visited[BubbleStore::GetSlotIndex(currentId)] = true;
+    connectedBubbleIds.push_back(currentId);
+    // Get the neighbors of the current bubble
+    std::vector<int> neighborIds = GetNeighborIds(bubbles.GetCenter(currentId));
+    for (auto& neighborId : neighborIds) {
+      // If the neighbor has the same color as the bubble and it is not in the
+      // connected bubble ids, then we add it to the queue.
+      if (bubbles.GetColor(neighborId) == color) {
+        q.emplace(neighborId);
+      }
+    }
+  }
+  return connectedBubbleIds;
+}
+
+std::vector<int> BubbleBoard::FindDetachedBubbles(
+    const std::vector<int>& removedIds, float upperBoundary) {
+  // Only the bubbles that were neighbors of the removed bubbles can lose their
+  // path to the top of the game board, so only the components containing them
+  // are searched. A search stops as soon as it reaches the upper boundary or a
+  // bubble that is already known to be connected to the top.
+  enum Mark : uint8_t { kUnknown, kConnected, kDetached, kSearching };
+  if (searchMarks.size() < bubbles.GetSlotCapacity()) {
+    searchMarks.resize(bubbles.GetSlotCapacity());
+  }
+  // Bumping the stamp turns every mark back to unknown. Once the stamp wraps
+  // around, old marks could look valid, so they are cleared for real.
+  if (++searchStamp == 0) {
+    std::fill(searchMarks.begin(), searchMarks.end(), SearchMark{});
+    searchStamp = 1;
+  }
+  auto getMark = [&](int id) -> uint8_t {
+    const SearchMark& searchMark = searchMarks[BubbleStore::GetSlotIndex(id)];
+    return searchMark.stamp == searchStamp ? searchMark.mark
+                                           : uint8_t{kUnknown};
+  };
+  auto setMark = [&](int id, uint8_t mark) {
+    searchMarks[BubbleStore::GetSlotIndex(id)] = {searchStamp, mark};
+  };
+  std::vector<int> detachedIds;
+  std::vector<int>& component = searchComponent;
+
+  for (int removedId : removedIds) {
+    for (int seedId : GetNeighborIds(bubbles.GetCenter(removedId))) {
+      if (getMark(seedId) != kUnknown) {
+        continue;
+      }
+      // BFS over the component of the seed. The component vector itself is
+      // used as the queue.
+      component.clear();
+      component.emplace_back(seedId);
+      setMark(seedId, kSearching);
+      bool isConnected = false;
+      for (size_t i = 0; i < component.size() && !isConnected; ++i) {
+        int currentId = component[i];
+        if (IsAtUpperBoundary(bubbles.GetPosition(currentId), upperBoundary)) {
+          isConnected = true;
+          break;
+        }
+        for (int neighborId : GetNeighborIds(bubbles.GetCenter(currentId))) {
+          uint8_t mark = getMark(neighborId);
+          if (mark == kConnected) {
+            isConnected = true;
+            break;
+          }
+          if (mark == kUnknown) {
+            setMark(neighborId, kSearching);
+            component.emplace_back(neighborId);
+          }
+        }
+      }
+      for (int id : component) {
+        setMark(id, isConnected ? kConnected : kDetached);
+      }
+      if (!isConnected) {
+        detachedIds.insert(detachedIds.end(), component.begin(),
+                           component.end());
+      }
+    }
+  }
+  return detachedIds;
+}
+
+BubbleBoard::PopResult BubbleBoard::Pop(const std::vector<int>& ids,
+                                        float upperBoundary) {
+  PopResult result;
+  for (int id : ids) {
+    assert(bubbles.Contains(id) &&
+           bubbles.GetState(id) == BubbleState::Static &&
+           "Failed to find the bubble by ID.");
+    bubbles.SetState(id, BubbleState::Exploding);
+    grid.Remove(id);
+    result.explodingIds.emplace_back(id);
+  }
+  // A bubble is falling if it is no longer connected to the top wall through
+  // the static bubbles.
+  result.fallingIds = FindDetachedBubbles(result.explodingIds, upperBoundary);
+  for (int fallingId : result.fallingIds) {
+    // the falling bubble should be in the statics.
+    assert(bubbles.Contains(fallingId) &&
+           bubbles.GetState(fallingId) == BubbleState::Static &&
+           "Failed to find the bubble by ID.");
+    bubbles.SetState(fallingId, BubbleState::Falling);
+    grid.Remove(fallingId);
+  }
+  return result;
+}
+
+int BubbleBoard::UpdateFalling(float deltaTime, glm::vec2 gravity,
+                               float lowerBoundary) {
+  bubbles.Integrate(BubbleState::Falling, deltaTime, gravity);
+  // If the falling bubble pass the bottom of the game board, then we remove
+  // it from the falling bubbles.
+  std::vector<int> toRemove;
+  bubbles.ForEach(BubbleState::Falling, [&](int id) {
+    if (bubbles.GetPosition(id).y > lowerBoundary) {
+      toRemove.emplace_back(id);
+    }
+  });
+  for (const int id : toRemove) {
+    bubbles.Destroy(id);
+  }
+  return static_cast<int>(toRemove.size());
+}
+
+void BubbleBoard::TranslateStatics(glm::vec2 offset) {
+  bubbles.Translate(BubbleState::Static, offset);
+  grid.Translate(offset);
+}
+
+glm::vec2 BubbleBoard::FindLandingSlot(glm::vec2 center,
+                                       glm::vec4 boundaries) const {
+  glm::vec2 bestSlot = center;
+  float bestDistance = std::numeric_limits<float>::max();
+  auto tryCandidate = [&](glm::vec2 slot) {
+    float distance = glm::distance(slot, center);
+    if (distance < bestDistance && IsFreeSlot(slot, boundaries)) {
+      bestDistance = distance;
+      bestSlot = slot;
+    }
+  };
+  float left = boundaries.x + bubbleRadius;
+  float top = boundaries.y + bubbleRadius;
+  // The search covers the whole board once it reaches this radius.
+  const float maxSearchRadius =
+      glm::length(glm::vec2(boundaries.z - boundaries.x,
+                            boundaries.w - boundaries.y)) +
+      2 * bubbleRadius;
+  // The shot stops touching a static bubble, whose nearest free slot is rarely
+  // more than a radius and a half away, so the first search only looks a few
+  // radii around the shot. On a crowded board it may find nothing, and then
+  // the search widens ring by ring until a free slot is found.
+  float innerRadius = -1.f;
+  for (float searchRadius = 3.5f * bubbleRadius;;
+       innerRadius = searchRadius, searchRadius *= 2.f) {
+    // The neighbor slots of the static bubbles around the shot that the
+    // previous rings have not covered.
+    grid.ForEachNear(center, searchRadius,
+                     [&](const BubbleGrid::Entry& entry) {
+                       float distance = glm::distance(entry.center, center);
+                       if (distance <= innerRadius || distance > searchRadius) {
+                         return;
+                       }
+                       for (glm::vec2 offset : neighborOffsets) {
+                         tryCandidate(entry.center + offset);
+                       }
+                     });
+    // The slots of the top row next to the shot, if the shot stopped within
+    // the search radius of the top row.
+    if (center.y - top < searchRadius - 1.5f * bubbleRadius) {
+      float nearest = std::round((center.x - left) / bubbleRadius);
+      int numSlots = static_cast<int>(searchRadius / bubbleRadius) - 1;
+      for (int i = -numSlots; i <= numSlots; ++i) {
+        tryCandidate(glm::vec2(left + (nearest + i) * bubbleRadius, top));
+      }
+    }
+    if (bestDistance < std::numeric_limits<float>::max() ||
+        searchRadius >= maxSearchRadius) {
+      return bestSlot;
+    }
+  }
+}
+
+bool BubbleBoard::IsFreeSlot(glm::vec2 center, glm::vec4 boundaries) const {
+  // Allow the same error as the neighbor tests, so that a slot touching its
+  // neighbors is free.
+  constexpr float kAbsError = 0.5f;
+  if (center.x - bubbleRadius < boundaries.x - kAbsError ||
+      center.x + bubbleRadius > boundaries.z + kAbsError ||
+      center.y - bubbleRadius < boundaries.y - kAbsError ||
+      center.y + bubbleRadius > boundaries.w + kAbsError) {
+    return false;
+  }
+  return !grid.HasAnyCloserThan(center, 2 * bubbleRadius - kAbsError);
+}
+
+void BubbleBoard::RebuildGrid() {
+  grid.Clear();
+  bubbles.ForEach(BubbleState::Static, [&](int id) {
+    grid.Insert(id, bubbles.GetCenter(id), bubbles.GetRadius(id));
+  });
+}
+
+bool BubbleBoard::MoveShot(glm::vec2& center, glm::vec2& velocity,
+                           float radius, float deltaTime, glm::vec4 boundaries,
+                           const BubbleGrid& statics) {
+  // The step is split at every contact. For each piece, the exact time of the
+  // first contact with a wall or a static bubble is solved analytically, so a
+  // fast bubble or a long step never tunnels through anything.
+  enum class Contact { kNone, kSideWall, kTopWall, kBottomWall, kBubble };
+  bool isPenetrating = false;
+  float remainingTime = deltaTime;
+  for (int i = 0; i < kMaxContactsPerStep && remainingTime > 0.f; ++i) {
+    glm::vec2 displacement = velocity * remainingTime;
+    // Fraction of the displacement at which the first contact happens.
+    float fraction = 1.f;
+    Contact contact = Contact::kNone;
+
+    // Walls. The bubble touches a wall when its edge reaches the boundary.
+    if (displacement.x < 0.f) {
+      float t = (boundaries.x + radius - center.x) / displacement.x;
+      if (t < fraction) {
+        fraction = std::max(t, 0.f);
+        contact = Contact::kSideWall;
+      }
+    } else if (displacement.x > 0.f) {
+      float t = (boundaries.z - radius - center.x) / displacement.x;
+      if (t < fraction) {
+        fraction = std::max(t, 0.f);
+        contact = Contact::kSideWall;
+      }
+    }
+    if (displacement.y < 0.f) {
+      float t = (boundaries.y + radius - center.y) / displacement.y;
+      if (t < fraction) {
+        fraction = std::max(t, 0.f);
+        contact = Contact::kTopWall;
+      }
+    } else if (displacement.y > 0.f) {
+      float t = (boundaries.w - radius - center.y) / displacement.y;
+      if (t < fraction) {
+        fraction = std::max(t, 0.f);
+        contact = Contact::kBottomWall;
+      }
+    }
+
+    // Static bubbles close to the path of this piece of the step.
+    statics.ForEachNearSegment(
+        center, center + displacement * fraction, 2 * radius,
+        [&](const BubbleGrid::Entry& staticBubble) {
+          std::optional<float> t = sweptCircleTimeOfImpact(
+              center, displacement, staticBubble.center,
+              radius + staticBubble.radius);
+          if (t.has_value() && *t <= fraction) {
+            fraction = *t;
+            contact = Contact::kBubble;
+          }
+        });
+
+    center += displacement * fraction;
+    remainingTime *= 1.f - fraction;
+    if (contact == Contact::kSideWall) {
+      velocity.x *= -1.0f;
+    } else if (contact == Contact::kBottomWall) {
+      velocity.y *= -1.0f;
+    } else if (contact == Contact::kTopWall || contact == Contact::kBubble) {
+      isPenetrating = true;
+      break;
+    } else {
+      break;
+    }
+  }
+  if (isPenetrating) {
+    // Set the velocity to 0.
+    velocity = glm::vec2(0.0f, 0.0f);
+  }
+  return isPenetrating;
+}
+
+uint64_t BubbleBoard::Hash() const {
+  uint64_t hash = 14695981039346656037ull;
+  hash = hashArray(hash, bubbles.GetIds());
+  hash = hashArray(hash, bubbles.GetCenters());
+  hash = hashArray(hash, std::vector<glm::vec2>{bubbles.GetStaticOrigin()});
+  hash = hashArray(hash, bubbles.GetColors());
+  hash = hashArray(hash, bubbles.GetStates());
+  return hash;
+}
+
+void BubbleBoard::Save(SnapshotWriter& writer) const {
+  writer.Write(boundaries);
+  writer.Write(bubbleRadius);
+  writer.Write(grid.GetOrigin());
+  bubbles.Save(writer);
+}
+
+bool BubbleBoard::Load(SnapshotReader& reader) {
+  glm::vec4 boundaries{0.f};
+  float bubbleRadius = 0.f;
+  glm::vec2 gridOrigin{0.f};
+  if (!reader.Read(boundaries) || !reader.Read(bubbleRadius) ||
+      !reader.Read(gridOrigin) || !(bubbleRadius > 0.f)) {
+    Clear();
+    return false;
+  }
+  // Resize puts the corner of the grid at the corner of the boundaries, so
+  // the empty grid is moved to where it was when the snapshot was taken
+  // before the static bubbles are inserted.
+  bubbles.Clear();
+  Resize(boundaries, bubbleRadius);
+  grid.Translate(gridOrigin - glm::vec2(boundaries.x, boundaries.y));
+  bool isValid = bubbles.Load(reader);
+  RebuildGrid();
+  return isValid;
+}
+
+BubbleStore& BubbleBoard::GetStore() { return bubbles; }
+
+const BubbleStore& BubbleBoard::GetStore() const { return bubbles; }
+
+BubbleGrid& BubbleBoard::GetGrid() { return grid; }
+
+const BubbleGrid& BubbleBoard::GetGrid() const { return grid; }
+
+glm::vec4 BubbleBoard::GetBoundaries() const { return boundaries; }
+
+float BubbleBoard::GetBubbleRadius() const { return bubbleRadius; }
@@ -0,0 +1,157 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "BubbleGrid.h"
+#include "BubbleStore.h"
+#include "LevelGenerator.h"
+#include "SimulationUtils.h"
+#include "Snapshot.h"
+
+// BubbleBoard holds the rules of the game board: where the bubbles are, which
+// of them are neighbors, which groups pop and which bubbles fall once they lose
+// their path to the top of the board. It owns the bubble store and the grid of
+// the static bubbles, and knows nothing about rendering, sounds or timers, so
+// the game and a headless driver can both run it.
+class BubbleBoard {
+ public:
+  // The maximum number of contacts resolved within a single step of MoveShot.
+  static constexpr int kMaxContactsPerStep = 8;
+
+  // The bubbles that leave the board because of a pop.
+  struct PopResult {
+    std::vector<int> explodingIds;
+    std::vector<int> fallingIds;
+  };
+
+  BubbleBoard() = default;
+  ~BubbleBoard() = default;
+
+  // Resize the board to the given boundaries (left, upper, right, lower) and
+  // bubble radius. The bubbles are kept.
+  void Resize(glm::vec4 boundaries, float bubbleRadius);
+
+  // Remove all the bubbles while keeping the dimensions of the board.
+  void Clear();
+
+  // Remove all the static bubbles. The falling and exploding bubbles are kept.
+  void ClearStatics();
+
+  // Add the static bubbles of a generated level layout.
+  void LoadLayout(const LevelLayout& layout);
+
+  // Add a static bubble and return its id.
+  int Attach(glm::vec2 center, float radius, Color color);
+
+  // Check if two bubbles of the board radius at the given centers touch.
+  bool IsNeighbor(glm::vec2 center, glm::vec2 otherCenter,
+                  float absError = 0.5f) const;
+
+  // Get the ids of the static bubbles that are neighbors of the center.
+  std::vector<int> GetNeighborIds(glm::vec2 center,
+                                  float absError = 0.5f) const;
+
+  // Check if a bubble whose upper left corner is at the given position touches
+  // the upper boundary.
+  bool IsAtUpperBoundary(glm::vec2 position, float upperBoundary) const;
+
+  // Check if the static bubbles have reached the bubble carried by the
+  // shooter, which fails the level: the carried bubble sticks out of the upper
+  // boundary, which moves down as the board narrows, or it overlaps a static
+  // bubble.
+  bool HasReachedShooter(glm::vec2 carriedCenter, float carriedRadius,
+                         float upperBoundary) const;
+
+  // Find the static bubbles of the same color that are connected to the given
+  // static bubble, including itself.
+  std::vector<int> FindConnectedBubblesOfSameColor(int id) const;
+
+  // Find the static bubbles that are no longer connected to the upper boundary
+  // after the given bubbles have been removed from the grid. The removed
+  // bubbles must still be in the store.
+  std::vector<int> FindDetachedBubbles(const std::vector<int>& removedIds,
+                                       float upperBoundary);
+
+  // Turn the given static bubbles into exploding bubbles and the static
+  // bubbles that get detached from the upper boundary into falling bubbles.
+  // Both are removed from the grid but kept in the store.
+  PopResult Pop(const std::vector<int>& ids, float upperBoundary);
+
+  // Move the falling bubbles and destroy those whose upper left corner has
+  // passed the lower boundary. Returns the number of destroyed bubbles.
+  int UpdateFalling(float deltaTime, glm::vec2 gravity, float lowerBoundary);
+
+  // Move all the static bubbles by the given offset. Only the origins of the
+  // static bubbles in the store and in the grid move, so this takes constant
+  // time however many bubbles there are.
+  void TranslateStatics(glm::vec2 offset);
+
+  // Get the free slot a shot bubble that stopped at the given center lands
+  // in. The slots are the twelve neighbor positions, every 30 degrees, of the
+  // static bubbles near the center, and the slots of the top row, spaced a
+  // radius apart from the left boundary. The nearest one around the center
+  // that lies within the boundaries (left, upper, right, lower) and does not
+  // overlap a static bubble is returned, searching farther and farther until
+  // one is found. Only if the whole board has no free slot is the center
+  // returned as it is.
+  glm::vec2 FindLandingSlot(glm::vec2 center, glm::vec4 boundaries) const;
+
+  // Rebuild the grid from the static bubbles in the store.
+  void RebuildGrid();
+
+  // Move a shot bubble by its velocity. If it hits the left, right, or bottom
+  // boundaries, it bounces off. If it hits the top boundary or a static bubble,
+  // it stops at the exact point of contact, its velocity is set to 0 and true
+  // is returned. Only the static bubbles in the cells of the grid overlapped by
+  // the step are tested.
+  static bool MoveShot(glm::vec2& center, glm::vec2& velocity, float radius,
+                       float deltaTime, glm::vec4 boundaries,
+                       const BubbleGrid& statics);
+
+  // Hash the ids, centers, colors and states of all the bubbles and the origin
+  // of the static bubbles with 64-bit FNV-1a. Boards that went through the
+  // same steps have the same hash, so a replay can check that it ended on the
+  // board it was recorded on.
+  uint64_t Hash() const;
+
+  // Write the dimensions of the board, its bubbles and where its grid has
+  // been moved to a snapshot, or replace them with those read from one. The
+  // grid is rebuilt from the static bubbles. Return false if the snapshot is
+  // invalid, in which case the board is left without bubbles.
+  void Save(SnapshotWriter& writer) const;
+  bool Load(SnapshotReader& reader);
+
+  // Getters
+  BubbleStore& GetStore();
+  const BubbleStore& GetStore() const;
+  BubbleGrid& GetGrid();
+  const BubbleGrid& GetGrid() const;
+  glm::vec4 GetBoundaries() const;
+  float GetBubbleRadius() const;
+
+ private:
+  BubbleStore bubbles;
+  // Occupancy grid of the static bubbles.
+  BubbleGrid grid;
+  glm::vec4 boundaries{0.f};
+  float bubbleRadius{0.f};
+  // Offsets from the center of a bubble to the centers of its neighbors, for
+  // the current bubble radius.
+  std::array<glm::vec2, kNumNeighborDirections> neighborOffsets{};
+  // Marks of the searches of FindDetachedBubbles, indexed by slot. A mark is
+  // only valid while its stamp equals searchStamp, so the marks are reused
+  // without being cleared before every search.
+  struct SearchMark {
+    uint32_t stamp{0};
+    uint8_t mark{0};
+  };
+  std::vector<SearchMark> searchMarks;
+  uint32_t searchStamp{0};
+  std::vector<int> searchComponent;
+
+  // Check if a slot lies within the boundaries and does not overlap a static
+  // bubble.
+  bool IsFreeSlot(glm::vec2 center, glm::vec4 boundaries) const;
+};
@@ -0,0 +1,123 @@
+/*
+ * BubbleGrid.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "BubbleGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void BubbleGrid::Reset(glm::vec4 boundaries, float cellSize) {
+  assert(cellSize > 0.f && "The cell size should be positive.");
+  this->origin = glm::vec2(boundaries.x, boundaries.y);
+  this->cellSize = cellSize;
+  numCols = std::max(
+      1, static_cast<int>(std::ceil((boundaries.z - boundaries.x) / cellSize)));
+  numRows = std::max(
+      1, static_cast<int>(std::ceil((boundaries.w - boundaries.y) / cellSize)));
+  cells.assign(numCols * numRows, std::vector<Entry>());
+  locations.clear();
+  numEntries = 0;
+}
+
+void BubbleGrid::Clear() {
+  for (auto& cell : cells) {
+    cell.clear();
+  }
+  std::fill(locations.begin(), locations.end(), Location{});
+  numEntries = 0;
+}
+
+void BubbleGrid::Insert(int id, glm::vec2 center, float radius) {
+  assert(!cells.empty() && "The grid has not been reset yet.");
+  assert(id >= 0 && "The id should be non-negative.");
+  size_t key = static_cast<size_t>(id & kKeyMask);
+  if (key >= locations.size()) {
+    locations.resize(key + 1);
+  }
+  assert(locations[key].id == -1 &&
+         "An id with the same lower bits is already in the grid.");
+  int cellIndex = GetRow(center.y) * numCols + GetCol(center.x);
+  cells[cellIndex].push_back({id, center - origin, radius});
+  locations[key] = {id, cellIndex};
+  ++numEntries;
+}
+
+void BubbleGrid::Remove(int id) {
+  if (!Contains(id)) {
+    return;
+  }
+  Location& location = locations[id & kKeyMask];
+  auto& cell = cells[location.cellIndex];
+  for (size_t i = 0; i < cell.size(); ++i) {
+    if (cell[i].id == id) {
+      cell[i] = cell.back();
+      cell.pop_back();
+      break;
+    }
+  }
+  location = Location{};
+  --numEntries;
+}
+
+bool BubbleGrid::Contains(int id) const {
+  return id >= 0 &&
+         static_cast<size_t>(id & kKeyMask) < locations.size() &&
+         locations[id & kKeyMask].id == id;
+}
+
+size_t BubbleGrid::Size() const { return numEntries; }
+
+void BubbleGrid::Translate(glm::vec2 offset) { origin += offset; }
+
+float BubbleGrid::GetCellSize() const { return cellSize; }
+
+glm::vec2 BubbleGrid::GetOrigin() const { return origin; }
+
+std::vector<int> BubbleGrid::GetIdsWithin(glm::vec2 center,
+                                          float distance) const {
+  std::vector<int> ids;
+  ForEachNear(center, distance, [&](const Entry& entry) {
+    glm::vec2 diff = entry.center - center;
+    if (glm::dot(diff, diff) <= distance * distance) {
+      ids.push_back(entry.id);
+    }
+  });
+  return ids;
+}
+
+bool BubbleGrid::HasAnyCloserThan(glm::vec2 center, float distance) const {
+  bool found = false;
+  ForEachNear(center, distance, [&](const Entry& entry) {
+    glm::vec2 diff = entry.center - center;
+    if (glm::dot(diff, diff) < distance * distance) {
+      found = true;
+    }
+  });
+  return found;
+}
+
+int BubbleGrid::GetCol(float x) const {
+  int col = static_cast<int>(std::floor((x - origin.x) / cellSize));
+  return std::clamp(col, 0, numCols - 1);
+}
+
+int BubbleGrid::GetRow(float y) const {
+  int row = static_cast<int>(std::floor((y - origin.y) / cellSize));
+  return std::clamp(row, 0, numRows - 1);
+}
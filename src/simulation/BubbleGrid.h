@@ -0,0 +1,216 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+// BubbleGrid is an occupancy grid that indexes the static bubbles of the game
+// board by the cell their centers fall into. The cells are squares whose side
+// is the diameter of a bubble, so all the bubbles that can touch a circle of
+// radius r around a point are found in the few cells covered by that circle
+// instead of scanning every static bubble.
+//
+// Bubbles in this game are attached at multiples of 30 degrees from their
+// neighbors and the top row is spaced by a radius, so their centers do not lie
+// on a strict hexagonal lattice. The grid therefore only narrows down the
+// candidates and the callers still do the exact distance checks.
+//
+// The entries are kept relative to the upper left corner of the grid, so
+// moving every entry at once only moves the corner. The callers pass and get
+// back centers in world space.
+class BubbleGrid {
+ public:
+  // An entry of the grid.
+  struct Entry {
+    int id;
+    glm::vec2 center;
+    float radius;
+  };
+
+  BubbleGrid() = default;
+  ~BubbleGrid() = default;
+
+  // Resize the grid to cover the given boundaries (left, upper, right, lower)
+  // with cells of the given size. All the entries are removed.
+  void Reset(glm::vec4 boundaries, float cellSize);
+
+  // Remove all the entries while keeping the dimensions of the grid.
+  void Clear();
+
+  // Insert a bubble by its id, center and radius. The id must not be in the
+  // grid, and its lower kKeyBits bits must differ from those of every id in
+  // the grid. That holds for the ids of a BubbleStore, which differ in their
+  // slot index there, and for sequential ids of fewer than 2^kKeyBits slots.
+  void Insert(int id, glm::vec2 center, float radius);
+
+  // Remove a bubble by its id. Nothing happens if the id is not in the grid.
+  void Remove(int id);
+
+  // Check if the given id is in the grid.
+  bool Contains(int id) const;
+
+  // Get the number of entries in the grid.
+  size_t Size() const;
+
+  // Move the grid together with all its entries by the given offset.
+  void Translate(glm::vec2 offset);
+
+  // Get the size of a cell.
+  float GetCellSize() const;
+
+  // Get the upper left corner of the grid.
+  glm::vec2 GetOrigin() const;
+
+  // Call func(entry) for every entry whose cell is overlapped by the given
+  // axis-aligned box. The caller is responsible for the exact check.
+  template <typename Func>
+  void ForEachInBox(glm::vec2 minCorner, glm::vec2 maxCorner,
+                    Func&& func) const {
+    if (cells.empty()) {
+      return;
+    }
+    int minCol = GetCol(minCorner.x);
+    int maxCol = GetCol(maxCorner.x);
+    int minRow = GetRow(minCorner.y);
+    int maxRow = GetRow(maxCorner.y);
+    for (int row = minRow; row <= maxRow; ++row) {
+      for (int col = minCol; col <= maxCol; ++col) {
+        for (const Entry& entry : cells[row * numCols + col]) {
+          func(Entry{entry.id, entry.center + origin, entry.radius});
+        }
+      }
+    }
+  }
+
+  // Call func(entry) for every entry whose cell is overlapped by the square
+  // bounding the circle of the given center and radius.
+  template <typename Func>
+  void ForEachNear(glm::vec2 center, float radius, Func&& func) const {
+    ForEachInBox(center - glm::vec2(radius, radius),
+                 center + glm::vec2(radius, radius), func);
+  }
+
+  // Call func(entry) for every entry whose cell is overlapped by the bounding
+  // box of a circle of the given radius swept from start to end.
+  template <typename Func>
+  void ForEachNearSegment(glm::vec2 start, glm::vec2 end, float radius,
+                          Func&& func) const {
+    ForEachInBox(glm::min(start, end) - glm::vec2(radius, radius),
+                 glm::max(start, end) + glm::vec2(radius, radius), func);
+  }
+
+  // Walk the cells crossed by a ray from origin along the normalized direction
+  // dir in the order the ray enters them (Amanatides-Woo traversal). Since a
+  // bubble reaches into the cells around its own, func(entry) is called for
+  // the entries of the 3x3 block around every crossed cell, so an entry may be
+  // visited more than once. The walk stops once the ray enters a cell farther
+  // than maxDistance, which the caller may shrink from func as it finds hits.
+  template <typename Func>
+  void MarchRay(glm::vec2 origin, glm::vec2 dir, const float& maxDistance,
+                Func&& func) const {
+    if (cells.empty()) {
+      return;
+    }
+    // Clip the ray against the rectangle of the grid.
+    glm::vec2 gridMin = this->origin;
+    glm::vec2 gridMax = this->origin + glm::vec2(numCols, numRows) * cellSize;
+    float tEnter = 0.f;
+    float tExit = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 2; ++axis) {
+      if (dir[axis] == 0.f) {
+        if (origin[axis] < gridMin[axis] || origin[axis] > gridMax[axis]) {
+          return;
+        }
+        continue;
+      }
+      float t0 = (gridMin[axis] - origin[axis]) / dir[axis];
+      float t1 = (gridMax[axis] - origin[axis]) / dir[axis];
+      tEnter = std::max(tEnter, std::min(t0, t1));
+      tExit = std::min(tExit, std::max(t0, t1));
+    }
+    if (tEnter > tExit) {
+      return;
+    }
+    glm::vec2 start = origin + dir * tEnter;
+    int col = GetCol(start.x);
+    int row = GetRow(start.y);
+    int stepCol = dir.x > 0.f ? 1 : -1;
+    int stepRow = dir.y > 0.f ? 1 : -1;
+    // Distance along the ray to the next vertical and horizontal cell edges,
+    // and the distance between two consecutive edges of the same kind.
+    float tNextCol = std::numeric_limits<float>::max();
+    float tNextRow = std::numeric_limits<float>::max();
+    float tDeltaCol = std::numeric_limits<float>::max();
+    float tDeltaRow = std::numeric_limits<float>::max();
+    if (dir.x != 0.f) {
+      float edgeX = this->origin.x + (col + (stepCol > 0 ? 1 : 0)) * cellSize;
+      tNextCol = (edgeX - origin.x) / dir.x;
+      tDeltaCol = cellSize / std::abs(dir.x);
+    }
+    if (dir.y != 0.f) {
+      float edgeY = this->origin.y + (row + (stepRow > 0 ? 1 : 0)) * cellSize;
+      tNextRow = (edgeY - origin.y) / dir.y;
+      tDeltaRow = cellSize / std::abs(dir.y);
+    }
+    float tCell = tEnter;
+    while (tCell <= maxDistance) {
+      for (int r = std::max(row - 1, 0); r <= std::min(row + 1, numRows - 1);
+           ++r) {
+        for (int c = std::max(col - 1, 0);
+             c <= std::min(col + 1, numCols - 1); ++c) {
+          for (const Entry& entry : cells[r * numCols + c]) {
+            func(Entry{entry.id, entry.center + this->origin, entry.radius});
+          }
+        }
+      }
+      // Step into the next cell along the ray.
+      if (tNextCol < tNextRow) {
+        col += stepCol;
+        tCell = tNextCol;
+        tNextCol += tDeltaCol;
+      } else {
+        row += stepRow;
+        tCell = tNextRow;
+        tNextRow += tDeltaRow;
+      }
+      if (col < 0 || col >= numCols || row < 0 || row >= numRows) {
+        break;
+      }
+    }
+  }
+
+  // Get the ids of the entries whose centers are within the given distance to
+  // the given center.
+  std::vector<int> GetIdsWithin(glm::vec2 center, float distance) const;
+
+  // Check if any entry's center is closer than the given distance to the given
+  // center.
+  bool HasAnyCloserThan(glm::vec2 center, float distance) const;
+
+ private:
+  // Upper left corner of the grid, which the centers of the entries are
+  // relative to.
+  glm::vec2 origin{0.f, 0.f};
+  float cellSize{0.f};
+  int numCols{0};
+  int numRows{0};
+  std::vector<std::vector<Entry>> cells;
+  // Ids are looked up by their lower bits only, so the generation in the upper
+  // bits of a BubbleStore id does not grow the lookup table.
+  static constexpr int kKeyBits = 16;
+  static constexpr int kKeyMask = (1 << kKeyBits) - 1;
+  // The id in the grid and the index of its cell, indexed by the lower bits of
+  // the id. -1 means no id with those bits is in the grid.
+  struct Location {
+    int id{-1};
+    int cellIndex{-1};
+  };
+  std::vector<Location> locations;
+  size_t numEntries{0};
+
+  // Get the column or row of a coordinate. Coordinates outside the grid are
+  // clamped to the border cells.
+  int GetCol(float x) const;
+  int GetRow(float y) const;
+};
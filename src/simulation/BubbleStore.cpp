@@ -0,0 +1,301 @@
+/*
+ * BubbleStore.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "BubbleStore.h"
+
+#include <algorithm>
+
+int BubbleStore::Create(glm::vec2 center, float radius, glm::vec2 velocity,
+                        Color color, BubbleState state) {
+  int slotIndex;
+  if (freeSlotIndices.empty()) {
+    assert(slots.size() <= kSlotMask && "Too many bubbles.");
+    slotIndex = static_cast<int>(slots.size());
+    slots.emplace_back();
+  } else {
+    slotIndex = freeSlotIndices.back();
+    freeSlotIndices.pop_back();
+  }
+  Slot& slot = slots[slotIndex];
+  slot.denseIndex = static_cast<int>(ids.size());
+  int id = (slot.generation << kSlotBits) | slotIndex;
+
+  ids.emplace_back(id);
+  centers.emplace_back(center - GetOrigin(state));
+  previousCenters.emplace_back(center - GetOrigin(state));
+  radii.emplace_back(radius);
+  velocities.emplace_back(velocity);
+  colors.emplace_back(color);
+  states.emplace_back(state);
+  ++stateCounts[static_cast<size_t>(state)];
+  return id;
+}
+
+void BubbleStore::Destroy(int id) {
+  size_t index = GetDenseIndex(id);
+  --stateCounts[static_cast<size_t>(states[index])];
+
+  // Move the last bubble into the place of the destroyed one.
+  size_t last = ids.size() - 1;
+  if (index != last) {
+    ids[index] = ids[last];
+    centers[index] = centers[last];
+    previousCenters[index] = previousCenters[last];
+    radii[index] = radii[last];
+    velocities[index] = velocities[last];
+    colors[index] = colors[last];
+    states[index] = states[last];
+    slots[GetSlotIndex(ids[index])].denseIndex = static_cast<int>(index);
+  }
+  ids.pop_back();
+  centers.pop_back();
+  previousCenters.pop_back();
+  radii.pop_back();
+  velocities.pop_back();
+  colors.pop_back();
+  states.pop_back();
+
+  // Free the slot and invalidate the ids referring to it.
+  Slot& slot = slots[GetSlotIndex(id)];
+  slot.denseIndex = -1;
+  slot.generation = (slot.generation + 1) & kGenerationMask;
+  freeSlotIndices.emplace_back(GetSlotIndex(id));
+}
+
+void BubbleStore::DestroyAll(BubbleState state) {
+  // Walk backwards so that the swapped-in bubbles have been visited already.
+  for (size_t i = ids.size(); i > 0; --i) {
+    if (states[i - 1] == state) {
+      Destroy(ids[i - 1]);
+    }
+  }
+  if (Count(BubbleState::Static) == 0) {
+    staticOrigin = glm::vec2(0.f, 0.f);
+    previousStaticOrigin = staticOrigin;
+  }
+}
+
+void BubbleStore::Clear() {
+  for (size_t i = ids.size(); i > 0; --i) {
+    Destroy(ids[i - 1]);
+  }
+  staticOrigin = glm::vec2(0.f, 0.f);
+  previousStaticOrigin = staticOrigin;
+}
+
+bool BubbleStore::Contains(int id) const {
+  if (id < 0) {
+    return false;
+  }
+  size_t slotIndex = GetSlotIndex(id);
+  return slotIndex < slots.size() && slots[slotIndex].denseIndex != -1 &&
+         slots[slotIndex].generation == (id >> kSlotBits);
+}
+
+size_t BubbleStore::Size() const { return ids.size(); }
+
+size_t BubbleStore::Count(BubbleState state) const {
+  return stateCounts[static_cast<size_t>(state)];
+}
+
+int BubbleStore::GetSlotIndex(int id) { return id & kSlotMask; }
+
+size_t BubbleStore::GetSlotCapacity() const { return slots.size(); }
+
+glm::vec2 BubbleStore::GetCenter(int id) const {
+  size_t index = GetDenseIndex(id);
+  return centers[index] + GetOrigin(states[index]);
+}
+
+glm::vec2 BubbleStore::GetPosition(int id) const {
+  size_t index = GetDenseIndex(id);
+  return centers[index] + GetOrigin(states[index]) -
+         glm::vec2(radii[index], radii[index]);
+}
+
+float BubbleStore::GetRadius(int id) const { return radii[GetDenseIndex(id)]; }
+
+glm::vec2 BubbleStore::GetVelocity(int id) const {
+  return velocities[GetDenseIndex(id)];
+}
+
+Color BubbleStore::GetColor(int id) const { return colors[GetDenseIndex(id)]; }
+
+BubbleState BubbleStore::GetState(int id) const {
+  return states[GetDenseIndex(id)];
+}
+
+void BubbleStore::SetCenter(int id, glm::vec2 center) {
+  size_t index = GetDenseIndex(id);
+  centers[index] = center - GetOrigin(states[index]);
+  previousCenters[index] = centers[index];
+}
+
+void BubbleStore::SetVelocity(int id, glm::vec2 velocity) {
+  velocities[GetDenseIndex(id)] = velocity;
+}
+
+void BubbleStore::SetState(int id, BubbleState state) {
+  size_t index = GetDenseIndex(id);
+  --stateCounts[static_cast<size_t>(states[index])];
+  ++stateCounts[static_cast<size_t>(state)];
+  // Keep the bubble where it is in world space.
+  glm::vec2 shift = GetOrigin(states[index]) - GetOrigin(state);
+  centers[index] += shift;
+  previousCenters[index] += shift;
+  states[index] = state;
+}
+
+void BubbleStore::SavePreviousCenters() {
+  previousCenters = centers;
+  previousStaticOrigin = staticOrigin;
+}
+
+void BubbleStore::Translate(BubbleState state, glm::vec2 offset) {
+  if (state == BubbleState::Static) {
+    staticOrigin += offset;
+    return;
+  }
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (states[i] == state) {
+      centers[i] += offset;
+      previousCenters[i] += offset;
+    }
+  }
+}
+
+void BubbleStore::Integrate(BubbleState state, float deltaTime,
+                            glm::vec2 acceleration) {
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (states[i] == state) {
+      centers[i] += velocities[i] * deltaTime;
+      velocities[i] += acceleration * deltaTime;
+    }
+  }
+}
+
+glm::vec2 BubbleStore::GetStaticOrigin() const { return staticOrigin; }
+
+glm::vec2 BubbleStore::GetPreviousStaticOrigin() const {
+  return previousStaticOrigin;
+}
+
+void BubbleStore::Save(SnapshotWriter& writer) const {
+  writer.WriteArray(ids);
+  writer.WriteArray(centers);
+  writer.WriteArray(previousCenters);
+  writer.WriteArray(radii);
+  writer.WriteArray(velocities);
+  writer.WriteArray(colors);
+  writer.WriteArray(states);
+  writer.WriteArray(slots);
+  writer.WriteArray(freeSlotIndices);
+  writer.Write(staticOrigin);
+  writer.Write(previousStaticOrigin);
+}
+
+bool BubbleStore::Load(SnapshotReader& reader) {
+  reader.ReadArray(ids);
+  reader.ReadArray(centers);
+  reader.ReadArray(previousCenters);
+  reader.ReadArray(radii);
+  reader.ReadArray(velocities);
+  reader.ReadArray(colors);
+  reader.ReadArray(states);
+  reader.ReadArray(slots);
+  reader.ReadArray(freeSlotIndices);
+  reader.Read(staticOrigin);
+  reader.Read(previousStaticOrigin);
+  size_t size = ids.size();
+  bool isValid = reader.IsValid() && centers.size() == size &&
+                 previousCenters.size() == size && radii.size() == size &&
+                 velocities.size() == size && colors.size() == size &&
+                 states.size() == size;
+  // Every bubble must have a valid color and state and sit in a slot of its
+  // generation that points back at it.
+  for (size_t i = 0; isValid && i < size; ++i) {
+    size_t slotIndex = GetSlotIndex(ids[i]);
+    isValid = ids[i] >= 0 && slotIndex < slots.size() &&
+              slots[slotIndex].denseIndex == static_cast<int>(i) &&
+              slots[slotIndex].generation == (ids[i] >> kSlotBits) &&
+              isEnumInRange(colors[i], Color::JadeGreen) &&
+              isEnumInRange(states[i], BubbleState::Undefined);
+  }
+  // Every other slot must be free and listed once among the free slots.
+  for (size_t i = 0; isValid && i < slots.size(); ++i) {
+    isValid = slots[i].denseIndex >= -1 &&
+              slots[i].denseIndex < static_cast<int>(size) &&
+              slots[i].generation >= 0 &&
+              slots[i].generation <= kGenerationMask;
+  }
+  isValid = isValid && freeSlotIndices.size() + size == slots.size();
+  std::vector<bool> isListedFree(isValid ? slots.size() : 0, false);
+  for (size_t i = 0; isValid && i < freeSlotIndices.size(); ++i) {
+    size_t slotIndex = static_cast<size_t>(freeSlotIndices[i]);
+    isValid = freeSlotIndices[i] >= 0 && slotIndex < slots.size() &&
+              slots[slotIndex].denseIndex == -1 && !isListedFree[slotIndex];
+    if (isValid) {
+      isListedFree[slotIndex] = true;
+    }
+  }
+  if (!isValid) {
+    ids.clear();
+    centers.clear();
+    previousCenters.clear();
+    radii.clear();
+    velocities.clear();
+    colors.clear();
+    states.clear();
+    slots.clear();
+    freeSlotIndices.clear();
+    staticOrigin = glm::vec2(0.f, 0.f);
+    previousStaticOrigin = staticOrigin;
+  }
+  std::fill(stateCounts.begin(), stateCounts.end(), 0);
+  for (BubbleState state : states) {
+    ++stateCounts[static_cast<size_t>(state)];
+  }
+  return isValid;
+}
+
+const std::vector<int>& BubbleStore::GetIds() const { return ids; }
+
+const std::vector<glm::vec2>& BubbleStore::GetCenters() const {
+  return centers;
+}
+
+const std::vector<glm::vec2>& BubbleStore::GetPreviousCenters() const {
+  return previousCenters;
+}
+
+const std::vector<float>& BubbleStore::GetRadii() const { return radii; }
+
+const std::vector<Color>& BubbleStore::GetColors() const { return colors; }
+
+const std::vector<BubbleState>& BubbleStore::GetStates() const {
+  return states;
+}
+
+size_t BubbleStore::GetDenseIndex(int id) const {
+  assert(Contains(id) && "Failed to find the bubble by ID.");
+  return static_cast<size_t>(slots[GetSlotIndex(id)].denseIndex);
+}
+
+glm::vec2 BubbleStore::GetOrigin(BubbleState state) const {
+  return state == BubbleState::Static ? staticOrigin : glm::vec2(0.f, 0.f);
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "SimulationUtils.h"
+#include "Snapshot.h"
+
+// State of the bubble
+enum class BubbleState {
+  kNormal,
+  Moving,
+  Static,
+  Falling,
+  Exploding,
+  Undefined,
+};
+
+// BubbleStore keeps the bubbles resting on, falling from or exploding on the
+// game board as a structure of dense arrays, so that updating and drawing them
+// walks contiguous memory. Changing the state of a bubble only flips its state
+// tag, and destroying a bubble moves the last bubble into its place.
+//
+// A bubble is referred to by an id that packs the index of its slot and the
+// generation of the slot. Destroying a bubble bumps the generation of its slot,
+// so ids of destroyed bubbles are never mistaken for the bubble that reuses
+// the slot. Ids are non-negative and the slot index of an id is a small dense
+// integer, which can be used to index per-bubble scratch arrays of
+// GetSlotCapacity() elements.
+//
+// The static bubbles keep their centers relative to a single static origin,
+// so moving all of them, as narrowing the board does, only moves the origin.
+// The getters and setters of a single bubble take and return centers in world
+// space, and a bubble leaving or entering the static state is moved between
+// the two spaces.
+class BubbleStore {
+ public:
+  BubbleStore() = default;
+  ~BubbleStore() = default;
+
+  // Create a bubble and return its id.
+  int Create(glm::vec2 center, float radius, glm::vec2 velocity, Color color,
+             BubbleState state);
+
+  // Destroy the bubble of the given id.
+  void Destroy(int id);
+
+  // Destroy all the bubbles of the given state.
+  void DestroyAll(BubbleState state);
+
+  // Destroy all the bubbles.
+  void Clear();
+
+  // Check if the id refers to an existing bubble.
+  bool Contains(int id) const;
+
+  // Get the number of all the bubbles or of the bubbles of the given state.
+  size_t Size() const;
+  size_t Count(BubbleState state) const;
+
+  // Get the slot index of an id and the number of slots.
+  static int GetSlotIndex(int id);
+  size_t GetSlotCapacity() const;
+
+  // Getters and setters of a single bubble.
+  glm::vec2 GetCenter(int id) const;
+  glm::vec2 GetPosition(int id) const;
+  float GetRadius(int id) const;
+  glm::vec2 GetVelocity(int id) const;
+  Color GetColor(int id) const;
+  BubbleState GetState(int id) const;
+  void SetCenter(int id, glm::vec2 center);
+  void SetVelocity(int id, glm::vec2 velocity);
+  void SetState(int id, BubbleState state);
+
+  // Remember the current centers of all the bubbles and the static origin as
+  // their previous values, so that a frame drawn between two steps can
+  // interpolate the bubbles between them. Created bubbles start with equal
+  // centers, and SetCenter and Translate move both centers, so only the motion
+  // made by Integrate and the moves of the static origin are interpolated.
+  void SavePreviousCenters();
+
+  // Move all the bubbles of the given state by the given offset. For the
+  // static bubbles, only the static origin moves.
+  void Translate(BubbleState state, glm::vec2 offset);
+
+  // Get the origin the centers of the static bubbles are relative to, and the
+  // origin saved by SavePreviousCenters. Both go back to (0, 0) once no static
+  // bubble is left.
+  glm::vec2 GetStaticOrigin() const;
+  glm::vec2 GetPreviousStaticOrigin() const;
+
+  // Move all the bubbles of the given state by their velocities and then
+  // accelerate them by the given acceleration.
+  void Integrate(BubbleState state, float deltaTime, glm::vec2 acceleration);
+
+  // Call func(id) for each bubble of the given state. The store must not be
+  // modified by func.
+  template <typename Func>
+  void ForEach(BubbleState state, Func&& func) const {
+    for (size_t i = 0; i < ids.size(); ++i) {
+      if (states[i] == state) {
+        func(ids[i]);
+      }
+    }
+  }
+
+  // Write all the bubbles, their slots and the static origin to a snapshot,
+  // or replace them with those read from one. Return false if the snapshot
+  // is invalid, in which case the store is cleared.
+  void Save(SnapshotWriter& writer) const;
+  bool Load(SnapshotReader& reader);
+
+  // Dense arrays of all the bubbles, in the same order. The centers of the
+  // static bubbles are relative to the static origin.
+  const std::vector<int>& GetIds() const;
+  const std::vector<glm::vec2>& GetCenters() const;
+  const std::vector<glm::vec2>& GetPreviousCenters() const;
+  const std::vector<float>& GetRadii() const;
+  const std::vector<Color>& GetColors() const;
+  const std::vector<BubbleState>& GetStates() const;
+
+ private:
+  // Number of low bits of an id that hold the slot index.
+  static constexpr int kSlotBits = 16;
+  static constexpr int kSlotMask = (1 << kSlotBits) - 1;
+  // Generations wrap around so that the ids stay non-negative.
+  static constexpr int kGenerationMask = 0x7fff;
+
+  struct Slot {
+    // Index of the bubble in the dense arrays. -1 means the slot is free.
+    int denseIndex{-1};
+    int generation{0};
+  };
+
+  // Dense arrays of the bubbles.
+  std::vector<int> ids;
+  std::vector<glm::vec2> centers;
+  std::vector<glm::vec2> previousCenters;
+  std::vector<float> radii;
+  std::vector<glm::vec2> velocities;
+  std::vector<Color> colors;
+  std::vector<BubbleState> states;
+
+  // Slots indexed by the slot index of an id, and the indices of the free
+  // ones.
+  std::vector<Slot> slots;
+  std::vector<int> freeSlotIndices;
+
+  glm::vec2 staticOrigin{0.f, 0.f};
+  glm::vec2 previousStaticOrigin{0.f, 0.f};
+
+  // Number of bubbles of each state.
+  std::vector<size_t> stateCounts =
+      std::vector<size_t>(static_cast<size_t>(BubbleState::Undefined) + 1, 0);
+
+  // Get the dense index of an existing bubble.
+  size_t GetDenseIndex(int id) const;
+
+  // Get the origin the centers of the bubbles of the given state are relative
+  // to.
+  glm::vec2 GetOrigin(BubbleState state) const;
+};
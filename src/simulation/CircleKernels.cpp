@@ -0,0 +1,259 @@
+/*
+ * CircleKernels.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CircleKernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CIRCLE_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CIRCLE_KERNELS_SSE2
+#endif
+
+namespace {
+
+constexpr float kNoHit = std::numeric_limits<float>::max();
+
+// Thin wrappers over the vector instructions, so that the kernels are written
+// once for both vector widths.
+#if defined(CIRCLE_KERNELS_AVX2)
+constexpr size_t kLanes = 8;
+using Floats = __m256;
+Floats set1(float v) { return _mm256_set1_ps(v); }
+Floats setLanes() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+Floats load(const float* values) { return _mm256_loadu_ps(values); }
+void store(float* values, Floats v) { _mm256_storeu_ps(values, v); }
+Floats add(Floats a, Floats b) { return _mm256_add_ps(a, b); }
+Floats sub(Floats a, Floats b) { return _mm256_sub_ps(a, b); }
+Floats mul(Floats a, Floats b) { return _mm256_mul_ps(a, b); }
+Floats maximum(Floats a, Floats b) { return _mm256_max_ps(a, b); }
+Floats squareRoot(Floats a) { return _mm256_sqrt_ps(a); }
+Floats less(Floats a, Floats b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+Floats lessEqual(Floats a, Floats b) {
+  return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+}
+Floats both(Floats a, Floats b) { return _mm256_and_ps(a, b); }
+Floats select(Floats mask, Floats a, Floats b) {
+  return _mm256_blendv_ps(b, a, mask);
+}
+int toBits(Floats mask) { return _mm256_movemask_ps(mask); }
+
+// Load the coordinates of kLanes interleaved centers into x and y.
+void loadCenters(const glm::vec2* centers, Floats& x, Floats& y) {
+  const float* values = reinterpret_cast<const float*>(centers);
+  __m256 a = _mm256_loadu_ps(values);
+  __m256 b = _mm256_loadu_ps(values + 8);
+  // The shuffles give x0 x1 x4 x5 x2 x3 x6 x7 and the permutes put the pairs
+  // in order.
+  __m256 xs = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  __m256 ys = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+  x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(xs),
+                                             _MM_SHUFFLE(3, 1, 2, 0)));
+  y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(ys),
+                                             _MM_SHUFFLE(3, 1, 2, 0)));
+}
+#elif defined(CIRCLE_KERNELS_SSE2)
+constexpr size_t kLanes = 4;
+using Floats = __m128;
+Floats set1(float v) { return _mm_set1_ps(v); }
+Floats setLanes() { return _mm_setr_ps(0, 1, 2, 3); }
+Floats load(const float* values) { return _mm_loadu_ps(values); }
+void store(float* values, Floats v) { _mm_storeu_ps(values, v); }
+Floats add(Floats a, Floats b) { return _mm_add_ps(a, b); }
+Floats sub(Floats a, Floats b) { return _mm_sub_ps(a, b); }
+Floats mul(Floats a, Floats b) { return _mm_mul_ps(a, b); }
+Floats maximum(Floats a, Floats b) { return _mm_max_ps(a, b); }
+Floats squareRoot(Floats a) { return _mm_sqrt_ps(a); }
+Floats less(Floats a, Floats b) { return _mm_cmplt_ps(a, b); }
+Floats lessEqual(Floats a, Floats b) { return _mm_cmple_ps(a, b); }
+Floats both(Floats a, Floats b) { return _mm_and_ps(a, b); }
+Floats select(Floats mask, Floats a, Floats b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+int toBits(Floats mask) { return _mm_movemask_ps(mask); }
+
+// Load the coordinates of kLanes interleaved centers into x and y.
+void loadCenters(const glm::vec2* centers, Floats& x, Floats& y) {
+  const float* values = reinterpret_cast<const float*>(centers);
+  __m128 a = _mm_loadu_ps(values);
+  __m128 b = _mm_loadu_ps(values + 4);
+  x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+#endif
+
+#if defined(CIRCLE_KERNELS_AVX2) || defined(CIRCLE_KERNELS_SSE2)
+#define CIRCLE_KERNELS_SIMD
+
+// Append the indices of the set bits of a lane mask, counted from base.
+size_t appendIndices(int bits, size_t base, int* indices, size_t numIndices) {
+  while (bits != 0) {
+    indices[numIndices++] =
+        static_cast<int>(base + std::countr_zero(static_cast<unsigned>(bits)));
+    bits &= bits - 1;
+  }
+  return numIndices;
+}
+#endif
+
+// Get the distance along the ray to where it enters the circle, or kNoHit.
+// This is the scalar form of the test of findNearestRayHit.
+float rayEntryDistance(glm::vec2 center, float radius, glm::vec2 origin,
+                       glm::vec2 dir) {
+  glm::vec2 toCenter = center - origin;
+  float b = toCenter.x * dir.x + toCenter.y * dir.y;
+  float squaredC = toCenter.x * toCenter.x + toCenter.y * toCenter.y;
+  float squaredA = std::max(squaredC - b * b, 0.f);
+  float squaredRadius = radius * radius;
+  if (b < 0.f || squaredA > squaredRadius) {
+    return kNoHit;
+  }
+  return b - std::sqrt(std::max(squaredRadius - squaredA, 0.f));
+}
+
+}  // namespace
+
+const char* getCircleKernelInstructionSet() {
+#if defined(CIRCLE_KERNELS_AVX2)
+  return "AVX2";
+#elif defined(CIRCLE_KERNELS_SSE2)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
+
+size_t findCentersInRange(const glm::vec2* centers, size_t count,
+                          glm::vec2 point, float minDistance,
+                          float maxDistance, int* indices) {
+  float squaredMin = minDistance > 0.f ? minDistance * minDistance : 0.f;
+  float squaredMax = maxDistance > 0.f ? maxDistance * maxDistance : 0.f;
+  size_t numIndices = 0;
+  size_t i = 0;
+#ifdef CIRCLE_KERNELS_SIMD
+  Floats px = set1(point.x), py = set1(point.y);
+  Floats minV = set1(squaredMin), maxV = set1(squaredMax);
+  for (; i + kLanes <= count; i += kLanes) {
+    Floats x, y;
+    loadCenters(centers + i, x, y);
+    Floats dx = sub(x, px), dy = sub(y, py);
+    Floats squaredDistance = add(mul(dx, dx), mul(dy, dy));
+    Floats inRange = both(lessEqual(minV, squaredDistance),
+                          less(squaredDistance, maxV));
+    numIndices = appendIndices(toBits(inRange), i, indices, numIndices);
+  }
+#endif
+  for (; i < count; ++i) {
+    glm::vec2 diff = centers[i] - point;
+    float squaredDistance = diff.x * diff.x + diff.y * diff.y;
+    if (squaredMin <= squaredDistance && squaredDistance < squaredMax) {
+      indices[numIndices++] = static_cast<int>(i);
+    }
+  }
+  return numIndices;
+}
+
+size_t findOverlappingCircles(const glm::vec2* centers, const float* radii,
+                              size_t count, glm::vec2 center, float radius,
+                              int* indices) {
+  size_t numIndices = 0;
+  size_t i = 0;
+#ifdef CIRCLE_KERNELS_SIMD
+  Floats cx = set1(center.x), cy = set1(center.y), r = set1(radius);
+  for (; i + kLanes <= count; i += kLanes) {
+    Floats x, y;
+    loadCenters(centers + i, x, y);
+    Floats dx = sub(x, cx), dy = sub(y, cy);
+    Floats squaredDistance = add(mul(dx, dx), mul(dy, dy));
+    Floats sumOfRadii = add(load(radii + i), r);
+    Floats overlaps = less(squaredDistance, mul(sumOfRadii, sumOfRadii));
+    numIndices = appendIndices(toBits(overlaps), i, indices, numIndices);
+  }
+#endif
+  for (; i < count; ++i) {
+    glm::vec2 diff = centers[i] - center;
+    float squaredDistance = diff.x * diff.x + diff.y * diff.y;
+    float sumOfRadii = radii[i] + radius;
+    if (squaredDistance < sumOfRadii * sumOfRadii) {
+      indices[numIndices++] = static_cast<int>(i);
+    }
+  }
+  return numIndices;
+}
+
+CircleHit findNearestRayHit(const glm::vec2* centers, const float* radii,
+                            size_t count, glm::vec2 origin, glm::vec2 dir,
+                            float extraRadius) {
+  CircleHit hit;
+  size_t i = 0;
+#ifdef CIRCLE_KERNELS_SIMD
+  Floats ox = set1(origin.x), oy = set1(origin.y);
+  Floats dx = set1(dir.x), dy = set1(dir.y);
+  Floats extra = set1(extraRadius), zero = set1(0.f), noHit = set1(kNoHit);
+  // Nearest hit of every lane. Indices are kept as floats, which are exact
+  // for any number of bubbles a board can hold.
+  Floats bestDistance = noHit, bestIndex = set1(-1.f);
+  Floats index = setLanes(), step = set1(static_cast<float>(kLanes));
+  for (; i + kLanes <= count; i += kLanes, index = add(index, step)) {
+    Floats x, y;
+    loadCenters(centers + i, x, y);
+    Floats tx = sub(x, ox), ty = sub(y, oy);
+    Floats b = add(mul(tx, dx), mul(ty, dy));
+    Floats squaredC = add(mul(tx, tx), mul(ty, ty));
+    Floats squaredA = maximum(sub(squaredC, mul(b, b)), zero);
+    Floats r = add(load(radii + i), extra);
+    Floats squaredRadius = mul(r, r);
+    Floats isHit =
+        both(lessEqual(zero, b), lessEqual(squaredA, squaredRadius));
+    Floats distance =
+        sub(b, squareRoot(maximum(sub(squaredRadius, squaredA), zero)));
+    distance = select(isHit, distance, noHit);
+    Floats isNearer = less(distance, bestDistance);
+    bestDistance = select(isNearer, distance, bestDistance);
+    bestIndex = select(isNearer, index, bestIndex);
+  }
+  // Reduce the lanes. On a tie the lower index wins, as in the scalar loop.
+  float distances[kLanes], laneIndices[kLanes];
+  store(distances, bestDistance);
+  store(laneIndices, bestIndex);
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    int laneIndex = static_cast<int>(laneIndices[lane]);
+    if (distances[lane] < hit.distance ||
+        (distances[lane] == hit.distance && distances[lane] != kNoHit &&
+         laneIndex < hit.index)) {
+      hit.distance = distances[lane];
+      hit.index = laneIndex;
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    float distance =
+        rayEntryDistance(centers[i], radii[i] + extraRadius, origin, dir);
+    if (distance < hit.distance) {
+      hit.distance = distance;
+      hit.index = static_cast<int>(i);
+    }
+  }
+  return hit;
+}
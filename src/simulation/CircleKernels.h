@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <limits>
+
+// Kernels that test one point, circle or ray against many circles at once.
+// The centers are packed the way BubbleStore keeps them, as an array of
+// glm::vec2, and the radii as a parallel array of floats. The kernels run four
+// circles per instruction with SSE2 and eight with AVX2, whichever the build
+// targets, and fall back to scalar code elsewhere and for the last few
+// circles. All paths give the same results.
+
+// Get the instruction set the kernels were built for: "AVX2", "SSE2" or
+// "scalar".
+const char* getCircleKernelInstructionSet();
+
+// Write the indices of the centers whose distance to the point is in
+// [minDistance, maxDistance) to indices, which must hold count elements, and
+// return how many were written.
+size_t findCentersInRange(const glm::vec2* centers, size_t count,
+                          glm::vec2 point, float minDistance,
+                          float maxDistance, int* indices);
+
+// Write the indices of the circles that overlap the circle of the given center
+// and radius, that is whose centers are closer to it than the sum of the
+// radii, to indices, which must hold count elements, and return how many were
+// written.
+size_t findOverlappingCircles(const glm::vec2* centers, const float* radii,
+                              size_t count, glm::vec2 center, float radius,
+                              int* indices);
+
+// The nearest circle hit by a ray and the distance along the ray to where the
+// ray enters it. index is -1 if no circle is hit.
+struct CircleHit {
+  int index{-1};
+  float distance{std::numeric_limits<float>::max()};
+};
+
+// Find the nearest circle that the ray from origin along the normalized
+// direction dir hits. Circles whose centers are behind the origin are skipped.
+// extraRadius grows every circle, so that the ray of a moving circle of that
+// radius finds the first circle it touches.
+CircleHit findNearestRayHit(const glm::vec2* centers, const float* radii,
+                            size_t count, glm::vec2 origin, glm::vec2 dir,
+                            float extraRadius = 0.f);
@@ -0,0 +1,185 @@
+/*
+ * DifficultyTuner.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// An offline tool to check the level rules without playing the game. For
+// every level of a difficulty it generates many seeded layouts with the rules
+// of LevelRules, lets the shot-selection bot play each of them to its end on
+// all the cores, and prints a row per level: how often the level is cleared,
+// failed or given up, the distribution of the shots and of the simulated time
+// it takes to clear, and how large the board grows. Levels that are rarely
+// cleared, slow to clear or whose boards grow far beyond their initial
+// bubbles are flagged, so a change to the rules can be checked in minutes.
+// The plays narrow the board and fail by the rules of the game, but the board
+// narrows at once instead of over the animation of the scroll.
+//
+// Usage: bubble_tuner [numSeeds] [difficulty] [seed] [numThreads]
+//
+// The difficulty is 1 (easy) to 4 (expert), or 0 for all of them. The results
+// only depend on the seed, not on the number of threads. The tool exits with 1
+// if any level is flagged, so it can gate a change to the rules.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "BatchSimulation.h"
+#include "HeadlessGame.h"
+#include "LevelRules.h"
+
+namespace {
+
+// A level is flagged as hard if it is cleared less often than this.
+constexpr double kMinClearRate = 0.5;
+// A level is flagged as slow if clearing it takes the 90th percentile of the
+// plays longer than this many simulated seconds.
+constexpr double kMaxSecondsToClear = 180.0;
+// A level is flagged as oversized if the board of a play grows beyond this
+// many times its initial bubbles.
+constexpr double kMaxBoardGrowth = 1.5;
+
+const char* getDifficultyName(Difficulty difficulty) {
+  switch (difficulty) {
+    case Difficulty::EASY:
+      return "easy";
+    case Difficulty::MEDIUM:
+      return "medium";
+    case Difficulty::HARD:
+      return "hard";
+    case Difficulty::EXPERT:
+      return "expert";
+    default:
+      return "undefined";
+  }
+}
+
+// Get the value at the given fraction of sorted values, or 0 if there are
+// none.
+template <typename T>
+T getPercentile(const std::vector<T>& sortedValues, double fraction) {
+  if (sortedValues.empty()) {
+    return T{0};
+  }
+  size_t index = static_cast<size_t>(fraction * (sortedValues.size() - 1));
+  return sortedValues[index];
+}
+
+// Play every level of a difficulty and print a row per level. Return the
+// number of flagged levels.
+int tuneDifficulty(Difficulty difficulty, int numSeeds, uint64_t seed,
+                   int numThreads) {
+  std::cout << "difficulty: " << getDifficultyName(difficulty) << "\n"
+            << std::setw(5) << "level" << std::setw(8) << "bubbles"
+            << std::setw(9) << "cleared" << std::setw(8) << "failed"
+            << std::setw(8) << "gaveup" << std::setw(16) << "shots p50/p90"
+            << std::setw(8) << "max" << std::setw(10) << "secs p90"
+            << std::setw(16) << "peak p50/max"
+            << "  flags" << std::endl;
+  int numFlagged = 0;
+  int64_t numTicks = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int level = 1; level <= getNumGameLevels(difficulty); ++level) {
+    BatchSimulationParams params;
+    params.numSimulations = numSeeds;
+    params.level = level;
+    params.difficulty = difficulty;
+    params.shotPolicy = ShotPolicy::kBot;
+    // Every level and difficulty draws layouts of its own.
+    params.seed = seed + static_cast<uint64_t>(difficulty) * 1000 + level;
+    params.numThreads = numThreads;
+    BatchSimulationReport report = runBatchSimulation(params);
+    numTicks += report.numTicks;
+
+    std::vector<int64_t> shotsToClear;
+    std::vector<double> secondsToClear;
+    std::vector<size_t> peakBubbles;
+    int numGivenUp = 0;
+    for (const SimulationResult& result : report.results) {
+      peakBubbles.push_back(result.peakStaticBubbles);
+      if (result.outcome == LevelOutcome::kCleared) {
+        shotsToClear.push_back(result.stats.numShots);
+        secondsToClear.push_back(result.stats.numTicks *
+                                 HeadlessGame::kTickTime);
+      } else if (result.outcome == LevelOutcome::kPlaying) {
+        ++numGivenUp;
+      }
+    }
+    std::sort(shotsToClear.begin(), shotsToClear.end());
+    std::sort(secondsToClear.begin(), secondsToClear.end());
+    std::sort(peakBubbles.begin(), peakBubbles.end());
+
+    int numInitialBubbles = getBubbleNumForLevel(level, difficulty);
+    double clearRate = static_cast<double>(report.numCleared) / numSeeds;
+    double p90Seconds = getPercentile(secondsToClear, 0.9);
+    size_t maxPeak = peakBubbles.back();
+    bool isHard = clearRate < kMinClearRate;
+    bool isSlow = p90Seconds > kMaxSecondsToClear;
+    bool isOversized = maxPeak > kMaxBoardGrowth * numInitialBubbles;
+    numFlagged += isHard || isSlow || isOversized ? 1 : 0;
+
+    std::cout << std::setw(5) << level << std::setw(8) << numInitialBubbles
+              << std::setw(8) << 100.0 * clearRate << "%" << std::setw(7)
+              << 100.0 * report.numFailed / numSeeds << "%" << std::setw(7)
+              << 100.0 * numGivenUp / numSeeds << "%" << std::setw(10)
+              << getPercentile(shotsToClear, 0.5) << "/" << std::setw(5)
+              << getPercentile(shotsToClear, 0.9) << std::setw(8)
+              << (shotsToClear.empty() ? 0 : shotsToClear.back())
+              << std::setw(10) << p90Seconds << std::setw(10)
+              << getPercentile(peakBubbles, 0.5) << "/" << std::setw(5)
+              << maxPeak << "  " << (isHard ? "hard " : "")
+              << (isSlow ? "slow " : "") << (isOversized ? "oversized" : "")
+              << std::endl;
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "flagged levels: " << numFlagged << "\n"
+            << "seconds: " << elapsed.count() << "\n"
+            << "ticks per second: "
+            << static_cast<int64_t>(numTicks / elapsed.count()) << "\n"
+            << std::endl;
+  return numFlagged;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int numSeeds = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 1000;
+  int difficultyArg = argc > 2 ? std::atoi(argv[2]) : 0;
+  uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+  int numThreads = argc > 4 ? std::atoi(argv[4]) : 0;
+
+  std::vector<Difficulty> difficulties;
+  if (difficultyArg <= 0) {
+    difficulties = {Difficulty::EASY, Difficulty::MEDIUM, Difficulty::HARD,
+                    Difficulty::EXPERT};
+  } else {
+    difficulties = {static_cast<Difficulty>(
+        std::min(difficultyArg, static_cast<int>(Difficulty::EXPERT)))};
+  }
+
+  std::cout << std::fixed << std::setprecision(1) << "seeds per level: "
+            << numSeeds << "\n"
+            << std::endl;
+  int numFlagged = 0;
+  for (Difficulty difficulty : difficulties) {
+    numFlagged += tuneDifficulty(difficulty, numSeeds, seed, numThreads);
+  }
+  return numFlagged > 0 ? 1 : 0;
+}
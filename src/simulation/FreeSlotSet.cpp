@@ -0,0 +1,121 @@
+/*
+ * FreeSlotSet.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "FreeSlotSet.h"
+
+#include <cassert>
+
+void FreeSlotSet::Reset(glm::vec4 boundaries, float cellSize) {
+  grid.Reset(boundaries, cellSize);
+  centers.clear();
+  allIds.clear();
+  adjacentIds.clear();
+  indexInAll.clear();
+  indexInAdjacent.clear();
+}
+
+void FreeSlotSet::Insert(glm::vec2 center, bool isAdjacent) {
+  // Find the existing slot at the same center if any.
+  int id = -1;
+  grid.ForEachNear(center, kSameSlotTolerance,
+                   [&](const BubbleGrid::Entry& entry) {
+                     if (glm::distance(entry.center, center) <
+                         kSameSlotTolerance) {
+                       id = entry.id;
+                     }
+                   });
+  if (id == -1) {
+    id = static_cast<int>(centers.size());
+    centers.emplace_back(center);
+    indexInAll.emplace_back(static_cast<int>(allIds.size()));
+    indexInAdjacent.emplace_back(-1);
+    allIds.emplace_back(id);
+    grid.Insert(id, center, 0.f);
+  }
+  if (isAdjacent && indexInAdjacent[id] == -1) {
+    indexInAdjacent[id] = static_cast<int>(adjacentIds.size());
+    adjacentIds.emplace_back(id);
+  }
+}
+
+void FreeSlotSet::RemoveCloserThan(glm::vec2 center, float distance) {
+  std::vector<int> ids;
+  grid.ForEachNear(center, distance, [&](const BubbleGrid::Entry& entry) {
+    if (glm::distance(entry.center, center) < distance) {
+      ids.emplace_back(entry.id);
+    }
+  });
+  for (int id : ids) {
+    grid.Remove(id);
+    SwapRemove(allIds, indexInAll, id);
+    SwapRemove(adjacentIds, indexInAdjacent, id);
+  }
+}
+
+void FreeSlotSet::MarkAdjacent(glm::vec2 center, float minDistance,
+                               float maxDistance) {
+  grid.ForEachNear(center, maxDistance, [&](const BubbleGrid::Entry& entry) {
+    float distance = glm::distance(entry.center, center);
+    if (distance >= minDistance && distance <= maxDistance &&
+        indexInAdjacent[entry.id] == -1) {
+      indexInAdjacent[entry.id] = static_cast<int>(adjacentIds.size());
+      adjacentIds.emplace_back(entry.id);
+    }
+  });
+}
+
+bool FreeSlotSet::Contains(glm::vec2 center) const {
+  bool found = false;
+  grid.ForEachNear(center, kSameSlotTolerance,
+                   [&](const BubbleGrid::Entry& entry) {
+                     if (glm::distance(entry.center, center) <
+                         kSameSlotTolerance) {
+                       found = true;
+                     }
+                   });
+  return found;
+}
+
+size_t FreeSlotSet::Size() const { return allIds.size(); }
+
+size_t FreeSlotSet::AdjacentSize() const { return adjacentIds.size(); }
+
+bool FreeSlotSet::Empty() const { return allIds.empty(); }
+
+glm::vec2 FreeSlotSet::GetSlot(size_t i) const {
+  assert(i < allIds.size() && "The slot index is out of range.");
+  return centers[allIds[i]];
+}
+
+glm::vec2 FreeSlotSet::GetAdjacentSlot(size_t i) const {
+  assert(i < adjacentIds.size() && "The slot index is out of range.");
+  return centers[adjacentIds[i]];
+}
+
+void FreeSlotSet::SwapRemove(std::vector<int>& ids, std::vector<int>& indices,
+                             int id) {
+  int index = indices[id];
+  if (index == -1) {
+    return;
+  }
+  int lastId = ids.back();
+  ids[index] = lastId;
+  indices[lastId] = index;
+  ids.pop_back();
+  indices[id] = -1;
+}
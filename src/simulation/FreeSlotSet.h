@@ -0,0 +1,65 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "BubbleGrid.h"
+
+// FreeSlotSet is the frontier of free slots used to generate the static
+// bubbles of a level. Slots are indexed by the cell they fall into, so adding,
+// removing and deduplicating slots around a newly placed bubble only visits
+// the cells around it. Besides all the free slots, it keeps the subset of
+// slots that are adjacent to a placed bubble in a dense array, so that both
+// sets can be sampled uniformly in constant time.
+class FreeSlotSet {
+ public:
+  FreeSlotSet() = default;
+  ~FreeSlotSet() = default;
+
+  // Remove all the slots and resize the index to cover the given boundaries
+  // (left, upper, right, lower) with cells of the given size.
+  void Reset(glm::vec4 boundaries, float cellSize);
+
+  // Add a slot if there is no slot at the same center yet. If isAdjacent is
+  // true, the slot is also marked as adjacent to a placed bubble.
+  void Insert(glm::vec2 center, bool isAdjacent);
+
+  // Remove all the slots whose centers are closer than the given distance to
+  // the given center.
+  void RemoveCloserThan(glm::vec2 center, float distance);
+
+  // Mark all the slots whose distance to the given center is within
+  // [minDistance, maxDistance] as adjacent to a placed bubble.
+  void MarkAdjacent(glm::vec2 center, float minDistance, float maxDistance);
+
+  // Check if there is a slot at the given center.
+  bool Contains(glm::vec2 center) const;
+
+  // Get the number of free slots and the number of the adjacent ones.
+  size_t Size() const;
+  size_t AdjacentSize() const;
+  bool Empty() const;
+
+  // Get the i-th free slot or the i-th adjacent free slot. The order is
+  // arbitrary, which is enough for uniform sampling by a random index.
+  glm::vec2 GetSlot(size_t i) const;
+  glm::vec2 GetAdjacentSlot(size_t i) const;
+
+ private:
+  // Two slots closer than this are considered the same slot.
+  static constexpr float kSameSlotTolerance = 0.5f;
+
+  // Cell index of the slots. The ids of the entries are slot ids.
+  BubbleGrid grid;
+  // Center of each slot, indexed by slot id.
+  std::vector<glm::vec2> centers;
+  // Dense arrays of the ids of all the slots and of the adjacent slots.
+  std::vector<int> allIds;
+  std::vector<int> adjacentIds;
+  // Position of each slot id in allIds and adjacentIds. -1 means absent.
+  std::vector<int> indexInAll;
+  std::vector<int> indexInAdjacent;
+
+  // Remove a slot id from one of the dense arrays.
+  static void SwapRemove(std::vector<int>& ids, std::vector<int>& indices,
+                         int id);
+};
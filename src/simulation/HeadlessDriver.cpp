@@ -0,0 +1,910 @@
+/*
+ * HeadlessDriver.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// A driver that plays the board simulation without a window, sounds or timers.
+// It generates levels, shoots bubbles in random directions at a fixed time
+// step and reports how many ticks it runs per second. In batch mode it plays
+// a level to its end many times on all the cores and reports how many shots
+// and levels it plays per second. In soak mode a bot plays through all the
+// levels of a difficulty, retrying the levels it fails, and reports the time,
+// the allocations and the peak number of bubbles of the ticks of every level.
+// In kernels mode it times the circle kernels against the scalar loops they
+// replace on random circles, and checks that they give the same results. In
+// snapshot mode it plays into a level, times saving and loading a snapshot of
+// the game, checks that the loaded game plays on exactly as the saved one, and
+// loads the snapshot with each of its bytes flipped in turn, which must never
+// crash and is refused wherever the flip breaks the snapshot. In landing mode
+// it packs the board with bubbles but for a single hole and checks that a shot
+// stopping anywhere in the crowd lands in a free slot. In grid mode it times
+// the queries of the bubble grid against scans of every bubble on boards of
+// 500 to 5000 bubbles, and checks that they give the same results. In detach
+// mode it pops bubbles on boards of 500 to 5000 bubbles hanging from the top,
+// and times the search for the bubbles they detach against a flood fill of the
+// whole board from the top row, which must find the same bubbles. In parity
+// mode it shoots bubbles into a generated level and checks that every shot
+// stops where a discrete reference, moving in small substeps and stopping at
+// the first overlap, stops as well. Shots that graze a bubble may touch it in
+// one and miss it in the other, so they are counted apart.
+//
+// Usage: bubble_headless [numTicks] [level] [seed]
+//        bubble_headless --batch [numSimulations] [level] [seed] [numThreads]
+//        bubble_headless --soak [difficulty] [seed] [maxAttempts]
+//        bubble_headless --kernels [numCircles] [numQueries]
+//        bubble_headless --snapshot [level] [seed] [numTicks]
+//        bubble_headless --landing [numTrials] [seed]
+//        bubble_headless --grid [numQueries] [seed]
+//        bubble_headless --detach [numPops] [seed]
+//        bubble_headless --parity [numShots] [level] [seed]
+//
+// The difficulty of the soak mode is 1 (easy) to 4 (expert). The snapshot and
+// parity modes play at expert difficulty and default to its last level, which
+// has the most bubbles.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "BatchSimulation.h"
+#include "CircleKernels.h"
+#include "HeadlessGame.h"
+
+namespace {
+
+// Number of allocations made through operator new.
+std::atomic<int64_t> numAllocations{0};
+
+// Ticks after which a soak attempt at a level is given up.
+constexpr int64_t kMaxSoakTicksPerAttempt = HeadlessGame::kTickRate * 60 * 10;
+
+int runBatch(int argc, char* argv[]) {
+  BatchSimulationParams params;
+  params.numSimulations = argc > 2 ? std::atoi(argv[2]) : 1000;
+  params.level = argc > 3 ? std::atoi(argv[3]) : 1;
+  params.seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1u;
+  params.numThreads = argc > 5 ? std::atoi(argv[5]) : 0;
+
+  BatchSimulationReport report = runBatchSimulation(params);
+  std::cout << "simulations: " << report.results.size() << "\n"
+            << "threads: " << report.numThreads << "\n"
+            << "ticks: " << report.numTicks << "\n"
+            << "shots: " << report.numShots << "\n"
+            << "levels cleared: " << report.numCleared << "\n"
+            << "levels failed: " << report.numFailed << "\n"
+            << "seconds: " << report.seconds << "\n"
+            << "shots per second: "
+            << static_cast<int64_t>(report.GetShotsPerSecond()) << "\n"
+            << "levels per second: " << report.GetLevelsPerSecond()
+            << std::endl;
+  return 0;
+}
+
+int runSoak(int argc, char* argv[]) {
+  int difficultyArg = argc > 2 ? std::atoi(argv[2]) : 4;
+  Difficulty difficulty = static_cast<Difficulty>(std::clamp(
+      difficultyArg, static_cast<int>(Difficulty::EASY),
+      static_cast<int>(Difficulty::EXPERT)));
+  uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+  int maxAttempts = argc > 4 ? std::max(std::atoi(argv[4]), 1) : 3;
+
+  HeadlessGame game(1, difficulty, Xoshiro256(seed), ShotPolicy::kBot);
+  std::vector<double> tickTimes;
+  std::cout << std::fixed << std::setprecision(2);
+  for (int level = 1; level <= getNumGameLevels(difficulty); ++level) {
+    HeadlessStats stats;
+    tickTimes.clear();
+    int64_t tickAllocations = 0;
+    size_t peakBubbles = 0;
+    int attempts = 0;
+    LevelOutcome outcome = LevelOutcome::kPlaying;
+    while (outcome != LevelOutcome::kCleared && attempts < maxAttempts) {
+      game.StartLevel(level);
+      ++attempts;
+      outcome = LevelOutcome::kPlaying;
+      for (int64_t i = 0; i < kMaxSoakTicksPerAttempt &&
+                          outcome == LevelOutcome::kPlaying;
+           ++i) {
+        int64_t allocationsBefore = numAllocations.load();
+        auto start = std::chrono::steady_clock::now();
+        outcome = game.Tick(stats);
+        auto end = std::chrono::steady_clock::now();
+        tickAllocations += numAllocations.load() - allocationsBefore;
+        tickTimes.push_back(
+            std::chrono::duration<double, std::micro>(end - start).count());
+        peakBubbles = std::max(peakBubbles, game.GetBoard().GetStore().Size());
+      }
+    }
+
+    std::sort(tickTimes.begin(), tickTimes.end());
+    auto percentile = [&tickTimes](double p) {
+      return tickTimes[static_cast<size_t>(p * (tickTimes.size() - 1))];
+    };
+    std::cout << "level " << level << ": "
+              << (outcome == LevelOutcome::kCleared ? "cleared" : "failed")
+              << " in " << attempts << " attempts, " << stats.numTicks
+              << " ticks, " << stats.numShots << " shots, tick us p50 "
+              << percentile(0.5) << " p99 " << percentile(0.99) << " max "
+              << tickTimes.back() << ", "
+              << static_cast<double>(tickAllocations) / stats.numTicks
+              << " allocations per tick, peak " << peakBubbles << " bubbles"
+              << std::endl;
+  }
+  return 0;
+}
+
+// The scalar loops the circle kernels replace, as the game wrote them.
+size_t findCentersInRangeScalar(const glm::vec2* centers, size_t count,
+                                glm::vec2 point, float minDistance,
+                                float maxDistance, int* indices) {
+  size_t numIndices = 0;
+  for (size_t i = 0; i < count; ++i) {
+    float distance = glm::distance(centers[i], point);
+    if (minDistance <= distance && distance < maxDistance) {
+      indices[numIndices++] = static_cast<int>(i);
+    }
+  }
+  return numIndices;
+}
+
+size_t findOverlappingCirclesScalar(const glm::vec2* centers,
+                                    const float* radii, size_t count,
+                                    glm::vec2 center, float radius,
+                                    int* indices) {
+  size_t numIndices = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (glm::distance(centers[i], center) < radii[i] + radius) {
+      indices[numIndices++] = static_cast<int>(i);
+    }
+  }
+  return numIndices;
+}
+
+CircleHit findNearestRayHitScalar(const glm::vec2* centers,
+                                  const float* radii, size_t count,
+                                  glm::vec2 origin, glm::vec2 dir,
+                                  float extraRadius) {
+  CircleHit hit;
+  for (size_t i = 0; i < count; ++i) {
+    glm::vec2 toCenter = centers[i] - origin;
+    float b = glm::dot(toCenter, dir);
+    float squaredA = std::max(glm::dot(toCenter, toCenter) - b * b, 0.f);
+    float radius = radii[i] + extraRadius;
+    if (b < 0.f || squaredA > radius * radius) {
+      continue;
+    }
+    float distance = b - std::sqrt(std::max(radius * radius - squaredA, 0.f));
+    if (distance < hit.distance) {
+      hit.distance = distance;
+      hit.index = static_cast<int>(i);
+    }
+  }
+  return hit;
+}
+
+// Time a function of a query index over all the queries and return the
+// nanoseconds per query. The results are summed into checksum, so that the
+// calls are not optimized away.
+template <typename Func>
+double timeQueries(int numQueries, int64_t& checksum, Func&& func) {
+  auto start = std::chrono::steady_clock::now();
+  for (int q = 0; q < numQueries; ++q) {
+    checksum += func(q);
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / numQueries;
+}
+
+int runKernels(int argc, char* argv[]) {
+  std::vector<size_t> sizes = {16, 64, 256, 1024};
+  if (argc > 2) {
+    sizes = {static_cast<size_t>(std::max(std::atoi(argv[2]), 1))};
+  }
+  int numQueries = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 100000;
+  float radius = HeadlessGame::kBaseUnit;
+
+  std::cout << "instruction set: " << getCircleKernelInstructionSet() << "\n"
+            << std::fixed << std::setprecision(1);
+  Xoshiro256 rng(1);
+  for (size_t count : sizes) {
+    // Circles of the bubble radius spread over a board of roughly count
+    // bubbles, and the queries on the same board.
+    float side = 2 * radius * std::sqrt(static_cast<float>(count));
+    std::vector<glm::vec2> centers(count);
+    std::vector<float> radii(count, radius);
+    for (glm::vec2& center : centers) {
+      center = glm::vec2(rng.Uniform(0.f, side), rng.Uniform(0.f, side));
+    }
+    std::vector<glm::vec2> points(numQueries);
+    std::vector<glm::vec2> dirs(numQueries);
+    for (int q = 0; q < numQueries; ++q) {
+      points[q] = glm::vec2(rng.Uniform(0.f, side), rng.Uniform(0.f, side));
+      float angle = rng.Uniform(0.f, 6.2831853f);
+      dirs[q] = glm::vec2(std::cos(angle), std::sin(angle));
+    }
+
+    // Check that the kernels agree with the scalar loops.
+    std::vector<int> expected(count), actual(count);
+    int numMismatches = 0;
+    for (int q = 0; q < numQueries; ++q) {
+      size_t numExpected = findCentersInRangeScalar(
+          centers.data(), count, points[q], 1.5f * radius, 2.5f * radius,
+          expected.data());
+      size_t numActual =
+          findCentersInRange(centers.data(), count, points[q], 1.5f * radius,
+                             2.5f * radius, actual.data());
+      numMismatches +=
+          !std::equal(expected.begin(), expected.begin() + numExpected,
+                      actual.begin(), actual.begin() + numActual);
+      numExpected = findOverlappingCirclesScalar(
+          centers.data(), radii.data(), count, points[q], radius,
+          expected.data());
+      numActual = findOverlappingCircles(centers.data(), radii.data(), count,
+                                         points[q], radius, actual.data());
+      numMismatches +=
+          !std::equal(expected.begin(), expected.begin() + numExpected,
+                      actual.begin(), actual.begin() + numActual);
+      numMismatches +=
+          findNearestRayHitScalar(centers.data(), radii.data(), count,
+                                  points[q], dirs[q], radius)
+              .index != findNearestRayHit(centers.data(), radii.data(), count,
+                                          points[q], dirs[q], radius)
+                            .index;
+    }
+
+    int64_t checksum = 0;
+    double rangeScalar = timeQueries(numQueries, checksum, [&](int q) {
+      return findCentersInRangeScalar(centers.data(), count, points[q],
+                                      1.5f * radius, 2.5f * radius,
+                                      expected.data());
+    });
+    double rangeKernel = timeQueries(numQueries, checksum, [&](int q) {
+      return findCentersInRange(centers.data(), count, points[q],
+                                1.5f * radius, 2.5f * radius, actual.data());
+    });
+    double overlapScalar = timeQueries(numQueries, checksum, [&](int q) {
+      return findOverlappingCirclesScalar(centers.data(), radii.data(), count,
+                                          points[q], radius, expected.data());
+    });
+    double overlapKernel = timeQueries(numQueries, checksum, [&](int q) {
+      return findOverlappingCircles(centers.data(), radii.data(), count,
+                                    points[q], radius, actual.data());
+    });
+    double rayScalar = timeQueries(numQueries, checksum, [&](int q) {
+      return findNearestRayHitScalar(centers.data(), radii.data(), count,
+                                     points[q], dirs[q], radius)
+          .index;
+    });
+    double rayKernel = timeQueries(numQueries, checksum, [&](int q) {
+      return findNearestRayHit(centers.data(), radii.data(), count, points[q],
+                               dirs[q], radius)
+          .index;
+    });
+
+    std::cout << count << " circles, ns per query (scalar / kernel): range "
+              << rangeScalar << " / " << rangeKernel << ", overlap "
+              << overlapScalar << " / " << overlapKernel << ", ray "
+              << rayScalar << " / " << rayKernel << ", " << numMismatches
+              << " mismatches (checksum " << checksum << ")" << std::endl;
+  }
+  return 0;
+}
+
+// Play a game for the given number of ticks, moving on to the next level when
+// a level is cleared and restarting it when it is failed.
+void playTicks(HeadlessGame& game, HeadlessStats& stats, int64_t numTicks) {
+  for (int64_t i = 0; i < numTicks; ++i) {
+    LevelOutcome outcome = game.Tick(stats);
+    if (outcome == LevelOutcome::kCleared) {
+      game.StartLevel(game.GetLevel() + 1);
+    } else if (outcome == LevelOutcome::kFailed) {
+      game.StartLevel(game.GetLevel());
+    }
+  }
+}
+
+int runSnapshot(int argc, char* argv[]) {
+  int level =
+      argc > 2 ? std::atoi(argv[2]) : getNumGameLevels(Difficulty::EXPERT);
+  uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+  int64_t numTicks = argc > 4 ? std::atoll(argv[4]) : 600;
+  constexpr int kNumRepeats = 1000;
+
+  HeadlessStats stats;
+  HeadlessGame game(level, Difficulty::EXPERT, Xoshiro256(seed));
+  playTicks(game, stats, numTicks);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<uint8_t> buffer;
+  for (int i = 0; i < kNumRepeats; ++i) {
+    SnapshotWriter writer;
+    game.Save(writer);
+    buffer = writer.GetBuffer();
+  }
+  std::chrono::duration<double, std::micro> saveTime =
+      std::chrono::steady_clock::now() - start;
+
+  HeadlessGame loaded(1, Difficulty::EASY, Xoshiro256(0));
+  bool isLoaded = true;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kNumRepeats; ++i) {
+    SnapshotReader reader(buffer);
+    isLoaded = loaded.Load(reader) && reader.IsAtEnd() && isLoaded;
+  }
+  std::chrono::duration<double, std::micro> loadTime =
+      std::chrono::steady_clock::now() - start;
+
+  // Both games must play on through the same states.
+  HeadlessStats loadedStats = stats;
+  playTicks(game, stats, numTicks);
+  playTicks(loaded, loadedStats, numTicks);
+  bool isSame = game.GetBoard().Hash() == loaded.GetBoard().Hash() &&
+                stats.score == loadedStats.score &&
+                stats.numShots == loadedStats.numShots;
+
+  // Flipped bytes of floats go unnoticed, but those of sizes, ids, slots,
+  // colors, states and bools are refused.
+  size_t numRefused = 0;
+  std::vector<uint8_t> corrupted = buffer;
+  for (size_t i = 0; i < corrupted.size(); ++i) {
+    corrupted[i] = static_cast<uint8_t>(~corrupted[i]);
+    SnapshotReader reader(corrupted);
+    if (!loaded.Load(reader) || !reader.IsAtEnd()) {
+      ++numRefused;
+    }
+    corrupted[i] = buffer[i];
+  }
+
+  std::cout << std::fixed << std::setprecision(2)
+            << "bubbles: " << game.GetBoard().GetStore().Size() << "\n"
+            << "snapshot bytes: " << buffer.size() << "\n"
+            << "save (us): " << saveTime.count() / kNumRepeats << "\n"
+            << "load (us): " << loadTime.count() / kNumRepeats << "\n"
+            << "loaded: " << (isLoaded ? "yes" : "no") << "\n"
+            << "resumed identically: " << (isSame ? "yes" : "no") << "\n"
+            << "flipped bytes refused: " << numRefused << "/"
+            << buffer.size() << std::endl;
+  return isLoaded && isSame ? 0 : 1;
+}
+
+int runLanding(int argc, char* argv[]) {
+  int numTrials = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 1000;
+  uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+
+  constexpr float kScreenWidth = HeadlessGame::kScreenWidth;
+  constexpr float kScreenHeight = HeadlessGame::kScreenHeight;
+  constexpr glm::vec4 boundaries(kScreenWidth / 3, kScreenHeight * 0.09f,
+                                 kScreenWidth * 2 / 3, kScreenHeight * 0.91f);
+  float radius = getBubbleRadiusForLevel(1, HeadlessGame::kBaseUnit);
+  // The slots of a hexagonal packing of the board.
+  std::vector<glm::vec2> slots;
+  float rowSpacing = std::sqrt(3.f) * radius;
+  for (int row = 0;; ++row) {
+    float y = boundaries.y + radius + row * rowSpacing;
+    if (y + radius > boundaries.w) {
+      break;
+    }
+    for (float x = boundaries.x + radius + (row % 2) * radius;
+         x + radius <= boundaries.z; x += 2 * radius) {
+      slots.emplace_back(x, y);
+    }
+  }
+
+  Xoshiro256 rng(seed);
+  std::uniform_int_distribution<size_t> slotDistr(0, slots.size() - 1);
+  std::uniform_real_distribution<float> offsetDistr(-radius, radius);
+  BubbleBoard board;
+  board.Resize(boundaries, radius);
+  int numOverlapping = 0;
+  int numInHole = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int trial = 0; trial < numTrials; ++trial) {
+    size_t hole = slotDistr(rng);
+    board.Clear();
+    for (size_t i = 0; i < slots.size(); ++i) {
+      if (i != hole) {
+        board.Attach(slots[i], radius, Color::Red);
+      }
+    }
+    glm::vec2 center = slots[slotDistr(rng)] +
+                       glm::vec2(offsetDistr(rng), offsetDistr(rng));
+    glm::vec2 slot = board.FindLandingSlot(center, boundaries);
+    // Allow the same error as the landing search does.
+    constexpr float kAbsError = 0.5f;
+    bool isInside = slot.x - radius >= boundaries.x - kAbsError &&
+                    slot.x + radius <= boundaries.z + kAbsError &&
+                    slot.y - radius >= boundaries.y - kAbsError &&
+                    slot.y + radius <= boundaries.w + kAbsError;
+    if (!isInside ||
+        board.GetGrid().HasAnyCloserThan(slot, 2 * radius - kAbsError)) {
+      ++numOverlapping;
+    }
+    numInHole += glm::distance(slot, slots[hole]) < kAbsError ? 1 : 0;
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << "bubbles: " << slots.size() - 1 << "\n"
+            << "trials: " << numTrials << "\n"
+            << "landed in the hole: " << numInHole << "\n"
+            << "landed overlapping: " << numOverlapping << "\n"
+            << "us per trial: " << elapsed.count() / numTrials << std::endl;
+  return numOverlapping == 0 ? 0 : 1;
+}
+
+// Get the distance along a ray from origin along the normalized direction dir
+// to the first circle it enters, or keep maxDistance if it enters none within
+// it, in the same way as the aim path.
+float getRayHitDistance(glm::vec2 origin, glm::vec2 dir, glm::vec2 center,
+                        float radius, float maxDistance) {
+  glm::vec2 toCenter = center - origin;
+  float b = glm::dot(toCenter, dir);
+  if (b < 0.f) {
+    return maxDistance;
+  }
+  float squaredA = std::max(glm::dot(toCenter, toCenter) - b * b, 0.f);
+  if (squaredA > radius * radius) {
+    return maxDistance;
+  }
+  return std::min(maxDistance, b - std::sqrt(radius * radius - squaredA));
+}
+
+int runGrid(int argc, char* argv[]) {
+  int numQueries = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 100000;
+  uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+  float radius = HeadlessGame::kBaseUnit;
+
+  std::cout << std::fixed << std::setprecision(1);
+  Xoshiro256 rng(seed);
+  int numMismatches = 0;
+  for (size_t count : {500, 1000, 2000, 5000}) {
+    // A square board whose hexagonal packing has a fifth more slots than
+    // bubbles, and the bubbles in random slots of it.
+    float side = 2 * radius * std::sqrt(1.2f * count);
+    glm::vec4 boundaries(0.f, 0.f, side, side);
+    std::vector<glm::vec2> slots;
+    for (int row = 0; radius + row * std::sqrt(3.f) * radius <= side - radius;
+         ++row) {
+      for (float x = radius + (row % 2) * radius; x <= side - radius;
+           x += 2 * radius) {
+        slots.emplace_back(x, radius + row * std::sqrt(3.f) * radius);
+      }
+    }
+    std::shuffle(slots.begin(), slots.end(), rng);
+    std::vector<glm::vec2> centers(slots.begin(),
+                                   slots.begin() + std::min(count,
+                                                            slots.size()));
+    BubbleGrid grid;
+    grid.Reset(boundaries, 2 * radius);
+    for (size_t i = 0; i < centers.size(); ++i) {
+      grid.Insert(static_cast<int>(i), centers[i], radius);
+    }
+    std::vector<glm::vec2> points(numQueries);
+    std::vector<glm::vec2> dirs(numQueries);
+    for (int q = 0; q < numQueries; ++q) {
+      points[q] = glm::vec2(rng.Uniform(0.f, side), rng.Uniform(0.f, side));
+      float angle = rng.Uniform(0.f, 6.2831853f);
+      dirs[q] = glm::vec2(std::cos(angle), std::sin(angle));
+    }
+
+    // A bubble of the given center overlaps those closer than 2 radii, and a
+    // ray hits the nearest bubble along it.
+    auto countOverlapsScan = [&](int q) {
+      int64_t numOverlaps = 0;
+      for (glm::vec2 center : centers) {
+        numOverlaps += glm::distance(center, points[q]) < 2 * radius;
+      }
+      return numOverlaps;
+    };
+    auto countOverlapsGrid = [&](int q) {
+      int64_t numOverlaps = 0;
+      grid.ForEachNear(points[q], 2 * radius,
+                       [&](const BubbleGrid::Entry& entry) {
+                         numOverlaps +=
+                             glm::distance(entry.center, points[q]) <
+                             2 * radius;
+                       });
+      return numOverlaps;
+    };
+    auto hasOverlapScan = [&](int q) {
+      return static_cast<int64_t>(std::any_of(
+          centers.begin(), centers.end(), [&](glm::vec2 center) {
+            return glm::distance(center, points[q]) < 2 * radius;
+          }));
+    };
+    auto hasOverlapGrid = [&](int q) {
+      return static_cast<int64_t>(grid.HasAnyCloserThan(points[q], 2 * radius));
+    };
+    auto castRayScan = [&](int q) {
+      float distance = 2 * side;
+      for (glm::vec2 center : centers) {
+        distance =
+            getRayHitDistance(points[q], dirs[q], center, radius, distance);
+      }
+      return static_cast<int64_t>(distance);
+    };
+    auto castRayGrid = [&](int q) {
+      float distance = 2 * side;
+      grid.MarchRay(points[q], dirs[q], distance,
+                    [&](const BubbleGrid::Entry& entry) {
+                      distance = getRayHitDistance(points[q], dirs[q],
+                                                   entry.center, entry.radius,
+                                                   distance);
+                    });
+      return static_cast<int64_t>(distance);
+    };
+
+    int numCountMismatches = 0;
+    for (int q = 0; q < numQueries; ++q) {
+      numCountMismatches += countOverlapsScan(q) != countOverlapsGrid(q);
+      numCountMismatches += hasOverlapScan(q) != hasOverlapGrid(q);
+      numCountMismatches += castRayScan(q) != castRayGrid(q);
+    }
+    numMismatches += numCountMismatches;
+
+    int64_t checksum = 0;
+    double nearScan = timeQueries(numQueries, checksum, countOverlapsScan);
+    double nearGrid = timeQueries(numQueries, checksum, countOverlapsGrid);
+    double closerScan = timeQueries(numQueries, checksum, hasOverlapScan);
+    double closerGrid = timeQueries(numQueries, checksum, hasOverlapGrid);
+    double rayScan = timeQueries(numQueries, checksum, castRayScan);
+    double rayGrid = timeQueries(numQueries, checksum, castRayGrid);
+
+    std::cout << centers.size()
+              << " bubbles, ns per query (scan / grid): near " << nearScan
+              << " / " << nearGrid << ", closer " << closerScan << " / "
+              << closerGrid << ", ray " << rayScan << " / " << rayGrid << ", "
+              << numCountMismatches << " mismatches (checksum " << checksum
+              << ")" << std::endl;
+  }
+  return numMismatches == 0 ? 0 : 1;
+}
+
+// Find the static bubbles in the grid of the board that are not connected to
+// the upper boundary with a flood fill of the whole board from its top row.
+std::vector<int> findDetachedByFloodFill(const BubbleBoard& board,
+                                         float upperBoundary) {
+  const BubbleStore& bubbles = board.GetStore();
+  std::vector<bool> isVisited(bubbles.GetSlotCapacity(), false);
+  std::vector<int> queue;
+  bubbles.ForEach(BubbleState::Static, [&](int id) {
+    if (board.GetGrid().Contains(id) &&
+        board.IsAtUpperBoundary(bubbles.GetPosition(id), upperBoundary)) {
+      isVisited[BubbleStore::GetSlotIndex(id)] = true;
+      queue.push_back(id);
+    }
+  });
+  for (size_t i = 0; i < queue.size(); ++i) {
+    for (int neighborId : board.GetNeighborIds(bubbles.GetCenter(queue[i]))) {
+      if (!isVisited[BubbleStore::GetSlotIndex(neighborId)]) {
+        isVisited[BubbleStore::GetSlotIndex(neighborId)] = true;
+        queue.push_back(neighborId);
+      }
+    }
+  }
+  std::vector<int> detachedIds;
+  bubbles.ForEach(BubbleState::Static, [&](int id) {
+    if (board.GetGrid().Contains(id) &&
+        !isVisited[BubbleStore::GetSlotIndex(id)]) {
+      detachedIds.push_back(id);
+    }
+  });
+  return detachedIds;
+}
+
+int runDetach(int argc, char* argv[]) {
+  int numPops = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 1000;
+  uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+  float radius = HeadlessGame::kBaseUnit;
+  // Share of the slots of the board that get a bubble, so that the bubbles
+  // hang from the top in branches that pops can cut.
+  constexpr float kFillRate = 0.6f;
+
+  std::cout << std::fixed << std::setprecision(1);
+  Xoshiro256 rng(seed);
+  std::uniform_real_distribution<float> fillDistr(0.f, 1.f);
+  int numMismatches = 0;
+  for (size_t count : {500, 1000, 2000, 5000}) {
+    // Fill a square board with bubbles in random slots of its hexagonal
+    // packing, and destroy those that do not hang from the top.
+    float side = 2 * radius * std::sqrt(count / kFillRate);
+    glm::vec4 boundaries(0.f, 0.f, side, side);
+    BubbleBoard board;
+    board.Resize(boundaries, radius);
+    for (int row = 0; radius + row * std::sqrt(3.f) * radius <= side - radius;
+         ++row) {
+      for (float x = radius + (row % 2) * radius; x <= side - radius;
+           x += 2 * radius) {
+        if (fillDistr(rng) < kFillRate) {
+          board.Attach(glm::vec2(x, radius + row * std::sqrt(3.f) * radius),
+                       radius, Color::Red);
+        }
+      }
+    }
+    for (int id : findDetachedByFloodFill(board, boundaries.y)) {
+      board.GetGrid().Remove(id);
+      board.GetStore().Destroy(id);
+    }
+    std::vector<int> ids;
+    board.GetStore().ForEach(BubbleState::Static,
+                             [&](int id) { ids.push_back(id); });
+
+    // Pop a random bubble with its neighbors, as a match of three or more
+    // does, find the bubbles it detaches both ways, and put the popped
+    // bubbles back.
+    std::uniform_int_distribution<size_t> idDistr(0, ids.size() - 1);
+    std::chrono::duration<double, std::micro> searchTime{0};
+    std::chrono::duration<double, std::micro> floodFillTime{0};
+    int64_t numDetached = 0;
+    int numPopMismatches = 0;
+    for (int pop = 0; pop < numPops; ++pop) {
+      int id = ids[idDistr(rng)];
+      std::vector<int> poppedIds =
+          board.GetNeighborIds(board.GetStore().GetCenter(id));
+      poppedIds.push_back(id);
+      for (int poppedId : poppedIds) {
+        board.GetGrid().Remove(poppedId);
+      }
+      auto start = std::chrono::steady_clock::now();
+      std::vector<int> detachedIds =
+          board.FindDetachedBubbles(poppedIds, boundaries.y);
+      searchTime += std::chrono::steady_clock::now() - start;
+      start = std::chrono::steady_clock::now();
+      std::vector<int> expectedIds =
+          findDetachedByFloodFill(board, boundaries.y);
+      floodFillTime += std::chrono::steady_clock::now() - start;
+      std::sort(detachedIds.begin(), detachedIds.end());
+      std::sort(expectedIds.begin(), expectedIds.end());
+      numPopMismatches += detachedIds != expectedIds;
+      numDetached += static_cast<int64_t>(expectedIds.size());
+      for (int poppedId : poppedIds) {
+        board.GetGrid().Insert(poppedId, board.GetStore().GetCenter(poppedId),
+                               radius);
+      }
+    }
+    numMismatches += numPopMismatches;
+
+    std::cout << ids.size() << " bubbles, us per pop (search / flood fill): "
+              << searchTime.count() / numPops << " / "
+              << floodFillTime.count() / numPops << ", "
+              << static_cast<double>(numDetached) / numPops
+              << " detached per pop, " << numPopMismatches << " mismatches"
+              << std::endl;
+  }
+  return numMismatches == 0 ? 0 : 1;
+}
+
+int runParity(int argc, char* argv[]) {
+  int numShots = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 1000;
+  int level =
+      argc > 3 ? std::atoi(argv[3]) : getNumGameLevels(Difficulty::EXPERT);
+  uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1u;
+  // The reference moves a tick in this many substeps.
+  constexpr int kNumSubsteps = 64;
+  constexpr float kSubstepTime = HeadlessGame::kTickTime / kNumSubsteps;
+  // Shots that have not stopped after this many ticks are counted as stuck.
+  constexpr int kMaxTicksPerShot = HeadlessGame::kTickRate * 60;
+
+  HeadlessGame game(level, Difficulty::EXPERT, Xoshiro256(seed));
+  const BubbleBoard& board = game.GetBoard();
+  const BubbleGrid& statics = board.GetGrid();
+  glm::vec4 boundaries = board.GetBoundaries();
+  float radius = board.GetBubbleRadius();
+  std::vector<BubbleGrid::Entry> entries;
+  statics.ForEachInBox(glm::vec2(boundaries.x, boundaries.y),
+                       glm::vec2(boundaries.z, boundaries.w),
+                       [&](const BubbleGrid::Entry& entry) {
+                         entries.push_back(entry);
+                       });
+  glm::vec2 shooterCenter((boundaries.x + boundaries.z) / 2,
+                          boundaries.w - radius);
+  float speed = 16.f * HeadlessGame::kVelocityUnit;
+  // The reference stops within a substep of the contact, and the rounding of
+  // the floats the game moves in adds up to a few tenths of a pixel over a
+  // shot that bounces across the board.
+  constexpr float kRoundingError = 0.5f;
+  float tolerance = speed * kSubstepTime + kRoundingError;
+  // A shot whose path passes this close to touching a bubble, or only enters
+  // it this deep, grazes it. The rounding decides whether it touches.
+  constexpr double kGrazeDistance = kRoundingError;
+
+  Xoshiro256 rng(seed);
+  std::uniform_real_distribution<float> angleDistr(-80.f, 80.f);
+  int numMismatches = 0;
+  int numGrazes = 0;
+  int numStuck = 0;
+  int64_t numTicks = 0;
+  float maxError = 0.f;
+  std::chrono::duration<double, std::micro> sweptTime{0};
+  std::chrono::duration<double, std::micro> discreteTime{0};
+  for (int i = 0; i < numShots; ++i) {
+    glm::vec2 velocity =
+        rotateVector(glm::vec2(0.f, -1.f), glm::radians(angleDistr(rng))) *
+        speed;
+
+    // The shot as the game moves it.
+    glm::vec2 sweptCenter = shooterCenter;
+    glm::vec2 sweptVelocity = velocity;
+    bool hasSweptStopped = false;
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < kMaxTicksPerShot && !hasSweptStopped; ++tick) {
+      hasSweptStopped =
+          BubbleBoard::MoveShot(sweptCenter, sweptVelocity, radius,
+                                HeadlessGame::kTickTime, boundaries, statics);
+      ++numTicks;
+    }
+    sweptTime += std::chrono::steady_clock::now() - start;
+
+    // The reference is mirrored back off the side and bottom walls and stops
+    // at the top wall or at the first substep that overlaps a static bubble.
+    // It moves in doubles, so its rounding does not add up over the substeps.
+    // It tracks how far it is from touching each bubble to find the closest
+    // approaches to the bubbles it passes.
+    double x = shooterCenter.x, y = shooterCenter.y;
+    double vx = velocity.x, vy = velocity.y;
+    double left = boundaries.x + radius, right = boundaries.z - radius;
+    double top = boundaries.y + radius, bottom = boundaries.w - radius;
+    bool hasDiscreteStopped = false;
+    bool isGrazing = false;
+    std::vector<double> gaps(entries.size(),
+                             std::numeric_limits<double>::max());
+    std::vector<bool> isApproaching(entries.size(), false);
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < kMaxTicksPerShot * kNumSubsteps; ++step) {
+      x += vx * kSubstepTime;
+      y += vy * kSubstepTime;
+      if (x < left) {
+        x = 2 * left - x;
+        vx = -vx;
+      } else if (x > right) {
+        x = 2 * right - x;
+        vx = -vx;
+      }
+      if (y > bottom) {
+        y = 2 * bottom - y;
+        vy = -vy;
+      }
+      hasDiscreteStopped = y <= top;
+      for (size_t e = 0; e < entries.size(); ++e) {
+        double dx = x - entries[e].center.x;
+        double dy = y - entries[e].center.y;
+        double gap = std::sqrt(dx * dx + dy * dy) - radius - entries[e].radius;
+        if (gap < 0.0) {
+          // The line of the substep only enters the bubble by a sliver if the
+          // shot grazes it.
+          double speedNorm = std::hypot(vx, vy);
+          double distanceToLine = std::abs(dx * vy - dy * vx) / speedNorm;
+          isGrazing = isGrazing || radius + entries[e].radius -
+                                           distanceToLine <
+                                       kGrazeDistance;
+          hasDiscreteStopped = true;
+        } else if (isApproaching[e] && gap > gaps[e] &&
+                   gaps[e] < kGrazeDistance) {
+          // The shot has passed its closest approach to the bubble.
+          isGrazing = true;
+        }
+        isApproaching[e] = gap < gaps[e];
+        gaps[e] = gap;
+      }
+      if (hasDiscreteStopped) {
+        break;
+      }
+    }
+    discreteTime += std::chrono::steady_clock::now() - start;
+
+    if (!hasSweptStopped || !hasDiscreteStopped) {
+      ++numStuck;
+      continue;
+    }
+    if (isGrazing) {
+      ++numGrazes;
+      continue;
+    }
+    float error = static_cast<float>(
+        std::hypot(sweptCenter.x - x, sweptCenter.y - y));
+    maxError = std::max(maxError, error);
+    numMismatches += error > tolerance ? 1 : 0;
+  }
+
+  std::cout << std::fixed << std::setprecision(3)
+            << "bubbles: " << entries.size() << "\n"
+            << "shots: " << numShots << "\n"
+            << "stuck: " << numStuck << "\n"
+            << "grazes: " << numGrazes << "\n"
+            << "mismatches: " << numMismatches << "\n"
+            << "max distance to reference: " << maxError << " (tolerance "
+            << tolerance << ")\n"
+            << "us per tick (swept / " << kNumSubsteps
+            << " substeps): " << sweptTime.count() / numTicks << " / "
+            << discreteTime.count() / numTicks << std::endl;
+  return numMismatches == 0 && numStuck == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+// Count the allocations of the soak mode.
+void* operator new(std::size_t size) {
+  numAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char* argv[]) {
+  if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) {
+    return runBatch(argc, argv);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--soak") == 0) {
+    return runSoak(argc, argv);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--kernels") == 0) {
+    return runKernels(argc, argv);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--snapshot") == 0) {
+    return runSnapshot(argc, argv);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--landing") == 0) {
+    return runLanding(argc, argv);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--grid") == 0) {
+    return runGrid(argc, argv);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--detach") == 0) {
+    return runDetach(argc, argv);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--parity") == 0) {
+    return runParity(argc, argv);
+  }
+  int64_t numTicks = argc > 1 ? std::atoll(argv[1]) : 1000000;
+  int level = argc > 2 ? std::atoi(argv[2]) : 1;
+  uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u;
+
+  HeadlessStats stats;
+  HeadlessGame game(level, Difficulty::EASY, Xoshiro256(seed));
+  auto start = std::chrono::steady_clock::now();
+  playTicks(game, stats, numTicks);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << "ticks: " << stats.numTicks << "\n"
+            << "shots: " << stats.numShots << "\n"
+            << "exploded: " << stats.numExploded << "\n"
+            << "dropped: " << stats.numDropped << "\n"
+            << "levels cleared: " << stats.numLevelsCleared << "\n"
+            << "levels failed: " << stats.numLevelsFailed << "\n"
+            << "score: " << stats.score << "\n"
+            << "board hash: " << std::hex << game.GetBoard().Hash()
+            << std::dec << "\n"
+            << "seconds: " << elapsed.count() << "\n"
+            << "ticks per second: "
+            << static_cast<int64_t>(stats.numTicks / elapsed.count())
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,234 @@
+/*
+ * HeadlessGame.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "HeadlessGame.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "AimPath.h"
+#include "LevelGenerator.h"
+#include "Scoring.h"
+#include "ShotSelector.h"
+
+namespace {
+
+constexpr float kScreenWidth = HeadlessGame::kScreenWidth;
+constexpr float kScreenHeight = HeadlessGame::kScreenHeight;
+constexpr glm::vec4 kBoardBoundaries(kScreenWidth / 3, kScreenHeight * 0.09f,
+                                     kScreenWidth * 2 / 3,
+                                     kScreenHeight * 0.91f);
+// The center of the bubble carried by the shooter of the game. The game places
+// the sprite of the shooter, of 7/135 of the board's width and 300/1701 of its
+// height, with its left edge a base unit left of the middle of the screen and
+// its top at 0.800117578 of the board's height, and it carries the bubble at
+// (0.5, 0.53) of the sprite.
+constexpr float kBoardWidth = kScreenWidth / 3;
+constexpr float kBoardHeight = kScreenHeight * 0.82f;
+constexpr glm::vec2 kShooterCenter(
+    kScreenWidth / 2 - HeadlessGame::kBaseUnit + kBoardWidth * 7 / 135 * 0.5f,
+    kScreenHeight * 0.09f + kBoardHeight * 0.800117578f +
+        kBoardHeight * 300 / 1701 * 0.53f);
+
+// Get the number of ticks the board stays still before it narrows.
+int64_t getNumTicksToNarrowing(int level, Difficulty difficulty) {
+  float interval = makeGameLevel(level, difficulty, HeadlessGame::kBaseUnit)
+                       .narrowingTimeInterval;
+  return std::max<int64_t>(
+      static_cast<int64_t>(std::ceil(interval / HeadlessGame::kTickTime)), 1);
+}
+
+}  // namespace
+
+HeadlessGame::HeadlessGame(int level, Difficulty difficulty, Xoshiro256 rng,
+                           ShotPolicy shotPolicy)
+    : difficulty(difficulty), shotPolicy(shotPolicy), rng(rng) {
+  StartLevel(level);
+}
+
+void HeadlessGame::StartLevel(int level) {
+  this->level = level;
+  LevelGenerationParams params;
+  params.level = level;
+  params.bubbleRadius = getBubbleRadiusForLevel(level, kBaseUnit);
+  params.gameLevel = makeGameLevel(level, difficulty, kBaseUnit);
+  params.boundaries = kBoardBoundaries;
+  params.shooterCenter = kShooterCenter;
+  params.seed = static_cast<unsigned int>(rng());
+  numInitialBubbles = params.gameLevel.numInitialBubbles;
+  LevelLayout layout = LevelGenerator(params).Generate();
+  board.Clear();
+  board.Resize(kBoardBoundaries, layout.bubbleRadius);
+  board.LoadLayout(layout);
+  shot.isMoving = false;
+  numTicksInLevel = 0;
+  boundaries = kBoardBoundaries;
+  shooterCenter = kShooterCenter;
+  numTicksToNarrowing = getNumTicksToNarrowing(level, difficulty);
+}
+
+LevelOutcome HeadlessGame::Tick(HeadlessStats& stats) {
+  ++stats.numTicks;
+  ++numTicksInLevel;
+  if (!shot.isMoving) {
+    Shoot();
+    ++stats.numShots;
+  }
+  LevelOutcome outcome = LevelOutcome::kPlaying;
+  float radius = board.GetBubbleRadius();
+  if (BubbleBoard::MoveShot(shot.center, shot.velocity, radius, kTickTime,
+                            boundaries, board.GetGrid())) {
+    shot.isMoving = false;
+    outcome = Land(stats);
+  }
+  if (outcome == LevelOutcome::kPlaying && --numTicksToNarrowing == 0) {
+    Narrow();
+    numTicksToNarrowing = getNumTicksToNarrowing(level, difficulty);
+    if (board.HasReachedShooter(shooterCenter, radius, boundaries.y)) {
+      ++stats.numLevelsFailed;
+      outcome = LevelOutcome::kFailed;
+    }
+  }
+  board.UpdateFalling(kTickTime, glm::vec2(0.f, 9.8f * kVelocityUnit),
+                      boundaries.w);
+  return outcome;
+}
+
+void HeadlessGame::Narrow() {
+  float radius = board.GetBubbleRadius();
+  float step = getNarrowingStep(radius);
+  boundaries.y += step;
+  boundaries.w -= step;
+  board.TranslateStatics(glm::vec2(0.f, step));
+  board.Resize(boundaries, radius);
+  shooterCenter.y -= step;
+  // A moving bubble caught by the boundaries is pushed inside, as in the game.
+  if (shot.isMoving) {
+    shot.center.y = std::clamp(shot.center.y, boundaries.y + radius,
+                               boundaries.w - radius);
+  }
+}
+
+void HeadlessGame::Save(SnapshotWriter& writer) const {
+  writer.Write(level);
+  writer.Write(difficulty);
+  writer.Write(shotPolicy);
+  writer.Write(numInitialBubbles);
+  writer.Write(numTicksInLevel);
+  writer.Write(boundaries);
+  writer.Write(shooterCenter);
+  writer.Write(numTicksToNarrowing);
+  writer.Write(shot);
+  writer.Write(rng.GetState());
+  board.Save(writer);
+}
+
+bool HeadlessGame::Load(SnapshotReader& reader) {
+  std::array<uint64_t, 4> rngState{};
+  if (!reader.Read(level) ||
+      !reader.ReadEnum(difficulty, Difficulty::EXPERT) ||
+      !reader.ReadEnum(shotPolicy, ShotPolicy::kBot) ||
+      !reader.Read(numInitialBubbles) ||
+      !reader.Read(numTicksInLevel) || !reader.Read(boundaries) ||
+      !reader.Read(shooterCenter) || !reader.Read(numTicksToNarrowing) ||
+      !reader.Read(shot) ||
+      !reader.Read(rngState) || level < 1 ||
+      difficulty == Difficulty::UNDEFINED ||
+      !isEnumInRange(shot.color, Color::JadeGreen) ||
+      !isValidBool(shot.isMoving)) {
+    return false;
+  }
+  rng.SetState(rngState);
+  return board.Load(reader);
+}
+
+// Shoot a bubble of the color of a random static bubble, in a random direction
+// within 75 degrees of straight up or in the direction the bot picks. With no
+// static bubble left, the color of the last shot is used again.
+void HeadlessGame::Shoot() {
+  const BubbleStore& bubbles = board.GetStore();
+  size_t numStatics = bubbles.Count(BubbleState::Static);
+  if (numStatics > 0) {
+    // Pick the static bubble by its rank among the static bubbles.
+    std::uniform_int_distribution<size_t> rankDistr(0, numStatics - 1);
+    size_t rank = rankDistr(rng);
+    const std::vector<BubbleState>& states = bubbles.GetStates();
+    for (size_t i = 0; i < states.size(); ++i) {
+      if (states[i] == BubbleState::Static && rank-- == 0) {
+        shot.color = bubbles.GetColors()[i];
+        break;
+      }
+    }
+  }
+  float speed = 16.f * kVelocityUnit;
+  glm::vec2 dir;
+  if (shotPolicy == ShotPolicy::kBot) {
+    dir = selectShotDirection(board, shooterCenter, shot.color, speed,
+                              kTickTime);
+  } else {
+    std::uniform_real_distribution<float> angleDistr(-kMaxShotAngle,
+                                                     kMaxShotAngle);
+    dir = rotateVector(glm::vec2(0.f, -1.f), glm::radians(angleDistr(rng)));
+  }
+  // The game traces the aim ray whenever the shooter turns.
+  traceAimPath(shooterCenter, dir, boundaries, board.GetGrid(),
+               board.GetBubbleRadius());
+  shot.center = shooterCenter;
+  shot.velocity = dir * speed;
+  shot.isMoving = true;
+}
+
+LevelOutcome HeadlessGame::Land(HeadlessStats& stats) {
+  BubbleStore& bubbles = board.GetStore();
+  shot.center = board.FindLandingSlot(shot.center, boundaries);
+  int id = board.Attach(shot.center, board.GetBubbleRadius(), shot.color);
+  std::vector<int> connectedIds = board.FindConnectedBubblesOfSameColor(id);
+  if (connectedIds.size() > 2) {
+    auto [explodingIds, fallingIds] =
+        board.Pop(connectedIds, boundaries.y);
+    float timeUsed = numTicksInLevel * kTickTime;
+    for (int increment : calculateScoreIncrements(
+             explodingIds.size(), board.GetBubbleRadius(), false, level,
+             numInitialBubbles, timeUsed)) {
+      stats.score += increment;
+    }
+    for (int increment : calculateScoreIncrements(
+             fallingIds.size(), board.GetBubbleRadius(), true, level,
+             numInitialBubbles, timeUsed)) {
+      stats.score += increment;
+    }
+    stats.numExploded += explodingIds.size();
+    stats.numDropped += fallingIds.size();
+    for (int explodingId : explodingIds) {
+      bubbles.Destroy(explodingId);
+    }
+  }
+  if (bubbles.Count(BubbleState::Static) == 0) {
+    ++stats.numLevelsCleared;
+    return LevelOutcome::kCleared;
+  }
+  if (board.HasReachedShooter(shooterCenter, board.GetBubbleRadius(),
+                              boundaries.y)) {
+    ++stats.numLevelsFailed;
+    return LevelOutcome::kFailed;
+  }
+  return LevelOutcome::kPlaying;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "BubbleBoard.h"
+#include "LevelRules.h"
+#include "Random.h"
+#include "Snapshot.h"
+
+// Statistics of a headless play.
+struct HeadlessStats {
+  int64_t numTicks{0};
+  int64_t numShots{0};
+  int64_t numExploded{0};
+  int64_t numDropped{0};
+  int64_t score{0};
+  int numLevelsCleared{0};
+  int numLevelsFailed{0};
+};
+
+// Outcome of a tick of a headless game.
+enum class LevelOutcome { kPlaying, kCleared, kFailed };
+
+// How a headless game aims its shots: in a random direction, or in the
+// direction picked by selectShotDirection.
+enum class ShotPolicy { kRandom, kBot };
+
+// HeadlessGame plays a level of the board simulation without a window, sounds
+// or timers. The board and the shooter are placed on the virtual screen the
+// same way as the game does, and every tick it shoots a bubble of the color
+// of a random static bubble when the last shot has landed, aimed as its shot
+// policy says. The board narrows at the interval of the level and the level
+// fails by the same rules as in the game, except that the board narrows at
+// once instead of over the animation of the scroll. The game owns its board
+// and its random number generator, so games can be played on different
+// threads at once.
+class HeadlessGame {
+ public:
+  // The game is designed for a virtual screen of 3840x2160.
+  static constexpr float kScreenWidth = 3840.f;
+  static constexpr float kScreenHeight = 2160.f;
+  static constexpr float kBaseUnit = kScreenHeight / 42.f;
+  static constexpr float kVelocityUnit = 2 * kBaseUnit;
+  // The game steps at the tick rate of its configuration, 120 by default.
+  static constexpr int kTickRate = 120;
+  static constexpr float kTickTime = 1.f / kTickRate;
+
+  // Start the given level. The generator decides the layouts of the levels
+  // and the shots.
+  HeadlessGame(int level, Difficulty difficulty, Xoshiro256 rng,
+               ShotPolicy shotPolicy = ShotPolicy::kRandom);
+  ~HeadlessGame() = default;
+
+  // Generate a new layout of the given level and start playing it. The
+  // memory of the board is kept for the new level.
+  void StartLevel(int level);
+
+  // Run a tick and tell whether the level has been cleared or failed in it.
+  // The level is not restarted after it ends.
+  LevelOutcome Tick(HeadlessStats& stats);
+
+  // Write the whole state of the game to a snapshot: the level, the board,
+  // the shot in flight and the random number generator. A game loaded from
+  // it plays on exactly as the saved game does. Load returns false if the
+  // snapshot is invalid.
+  void Save(SnapshotWriter& writer) const;
+  bool Load(SnapshotReader& reader);
+
+  // Getters
+  const BubbleBoard& GetBoard() const { return board; }
+  int GetLevel() const { return level; }
+
+ private:
+  // The bubble that has been shot and is still moving.
+  struct Shot {
+    glm::vec2 center{0.f};
+    glm::vec2 velocity{0.f};
+    Color color{Color::Red};
+    bool isMoving{false};
+  };
+
+  BubbleBoard board;
+  Shot shot;
+  int level{1};
+  Difficulty difficulty{Difficulty::EASY};
+  ShotPolicy shotPolicy{ShotPolicy::kRandom};
+  int numInitialBubbles{0};
+  int64_t numTicksInLevel{0};
+  // The boundaries of the board and the center of the shooter move in as the
+  // board narrows.
+  glm::vec4 boundaries{0.f};
+  glm::vec2 shooterCenter{0.f};
+  int64_t numTicksToNarrowing{0};
+  Xoshiro256 rng;
+
+  void Shoot();
+  // Move the boundaries of the board, the static bubbles and the shooter in
+  // by a narrowing step.
+  void Narrow();
+  // Attach the shot bubble in the slot where it stopped and pop the group it
+  // completes.
+  LevelOutcome Land(HeadlessStats& stats);
+};
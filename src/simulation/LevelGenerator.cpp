@@ -0,0 +1,237 @@
+/*
+ * LevelGenerator.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LevelGenerator.h"
+
+#include <cassert>
+
+LevelGenerator::LevelGenerator(const LevelGenerationParams& params)
+    : params(params), rng(params.seed) {}
+
+LevelLayout LevelGenerator::Generate() {
+  const float radius = params.bubbleRadius;
+  const glm::vec4 boundaries = params.boundaries;
+  const GameLevel& gameLevel = params.gameLevel;
+
+  layout = LevelLayout();
+  layout.level = params.level;
+  layout.gameLevel = gameLevel;
+  layout.bubbleRadius = radius;
+  grid.Reset(boundaries, 2 * radius);
+  freeSlots.Reset(boundaries, 2 * radius);
+
+  // First get all the free slots on the top of the game board.
+  for (float x = boundaries.x + radius;
+       !areFloatsGreater(x, boundaries.z - radius); x += radius) {
+    freeSlots.Insert(glm::vec2(x, boundaries.y + radius),
+                     /*isAdjacent=*/false);
+  }
+
+  // Randomly get N colors from the palette
+  std::vector<Color> colorSet;
+  for (int i = 0; i < kNumColors; ++i) {
+    colorSet.push_back(static_cast<Color>(i));
+  }
+  std::vector<Color> colorPool;
+  for (int i = 0; i < gameLevel.numColors; ++i) {
+    size_t randomIndex = GetRandomIndex(colorSet.size());
+    colorPool.push_back(colorSet[randomIndex]);
+    colorSet.erase(colorSet.begin() + randomIndex);
+  }
+
+  glm::vec2 centerForNewBubble(-1.f, -1.f);
+  std::vector<int> addedBubbleIds;
+  int lastAddedBubbleID = -1;
+
+  // Generate bubble one by one
+  for (int i = 0; i < gameLevel.numInitialBubbles; ++i) {
+    bool hasExistingBubble = !layout.centers.empty();
+    bool toBeNeighborOfBubble =
+        GetRandomBool(gameLevel.probabilityNewBubbleIsNeighborOfBubble) &&
+        hasExistingBubble;
+    bool toBeNeighborOfLastAdded =
+        GetRandomBool(gameLevel.probabilityNewBubbleIsNeighborOfLastAdded) &&
+        toBeNeighborOfBubble;
+    bool toBeNeighborOfBubbleOfSameColor =
+        GetRandomBool(
+            gameLevel.probabilityNewBubbleIsNeighborOfBubbleOfSameColor) &&
+        toBeNeighborOfBubble;
+    if (toBeNeighborOfLastAdded) {
+      assert(lastAddedBubbleID != -1 && "Have not added any bubble yet.");
+      // Get potential neighbors of the last added bubble
+      std::vector<glm::vec2> lastAddedFreeSlots =
+          GetPotentialNeighborFreeSlots(layout.centers[lastAddedBubbleID]);
+      while (lastAddedFreeSlots.empty()) {
+        addedBubbleIds.pop_back();
+        assert(!addedBubbleIds.empty() &&
+               "There should always be a static bubble that has available "
+               "neighbor free slots.");
+        lastAddedBubbleID = addedBubbleIds.back();
+        lastAddedFreeSlots =
+            GetPotentialNeighborFreeSlots(layout.centers[lastAddedBubbleID]);
+      }
+      // Get the common free slots of the last added free slots and the
+      // available free slots.
+      std::vector<glm::vec2> commonFreeSlots;
+      for (auto& slot : lastAddedFreeSlots) {
+        if (freeSlots.Contains(slot)) {
+          commonFreeSlots.push_back(slot);
+        }
+      }
+      if (commonFreeSlots.empty()) {
+        // If there is no common free slot, then we simply choose a free slot
+        // that is a neighbor of a bubble;
+        centerForNewBubble = GetRandomFreeSlotNextToPlacedBubbles();
+      } else {
+        //  Randomly select a free slot from the common free slots.
+        centerForNewBubble =
+            commonFreeSlots[GetRandomIndex(commonFreeSlots.size())];
+      }
+    } else if (toBeNeighborOfBubble) {
+      // Randomly select a free slot that is a neighbor of an existing static
+      // bubble.
+      centerForNewBubble = GetRandomFreeSlotNextToPlacedBubbles();
+    } else {
+      // Randomly select a free slot from the provided free slots.
+      centerForNewBubble =
+          freeSlots.GetSlot(GetRandomIndex(freeSlots.Size()));
+    }
+
+    Color color = colorPool[GetRandomIndex(colorPool.size())];
+    if (toBeNeighborOfBubbleOfSameColor) {
+      // Get the ids of the bubbles that are neighbors of the new bubble.
+      std::vector<int> neighborIds = GetNeighborIds(centerForNewBubble);
+      assert(!neighborIds.empty() && "Failed to get neighbor ids");
+      // Set the color of the new bubble to the color of a randomly selected
+      // neighbor.
+      color = layout.colors[neighborIds[GetRandomIndex(neighborIds.size())]];
+    }
+
+    // Place the new bubble.
+    lastAddedBubbleID = static_cast<int>(layout.centers.size());
+    layout.centers.emplace_back(centerForNewBubble);
+    layout.colors.emplace_back(color);
+    grid.Insert(lastAddedBubbleID, centerForNewBubble, radius);
+
+    // Update the free slots
+    UpdateFreeSlots(centerForNewBubble);
+
+    // Memorize the id of the new bubble
+    addedBubbleIds.emplace_back(lastAddedBubbleID);
+  }
+  return layout;
+}
+
+std::vector<int> LevelGenerator::GetNeighborIds(glm::vec2 center) const {
+  std::vector<int> neighborIds;
+  const float neighborDistance = 2 * params.bubbleRadius;
+  grid.ForEachNear(center, neighborDistance + 0.5f,
+                   [&](const BubbleGrid::Entry& entry) {
+                     if (areFloatsEqual(glm::distance(entry.center, center),
+                                        neighborDistance, 0.5f)) {
+                       neighborIds.push_back(entry.id);
+                     }
+                   });
+  return neighborIds;
+}
+
+std::vector<glm::vec2> LevelGenerator::GetPotentialNeighborFreeSlots(
+    glm::vec2 bubbleCenter) const {
+  const float radius = params.bubbleRadius;
+  const glm::vec4 boundaries = params.boundaries;
+  std::vector<glm::vec2> neighborCenters;
+  // The angle between two neighbors is mutiple of 30 degrees.
+  constexpr float angle = glm::radians(30.0f);
+  float totalNeighborNum = std::round(2 * glm::pi<float>() / angle);
+  // The first neighbor is the right neighbor.
+  glm::vec2 rightNeighbor = bubbleCenter + glm::vec2(2 * radius, 0.0f);
+  for (size_t neighborNum = 0; neighborNum < totalNeighborNum; ++neighborNum) {
+    glm::vec2 neighborCenter =
+        neighborNum == 0
+            ? rightNeighbor
+            : rotateVector(rightNeighbor, angle * neighborNum, bubbleCenter);
+    // Skip the neighbors that are outside the boundaries
+    if (areFloatsLess(neighborCenter.x - radius, boundaries[0]) ||
+        areFloatsGreater(neighborCenter.x + radius, boundaries[2]) ||
+        areFloatsLess(neighborCenter.y - radius, boundaries[1]) ||
+        areFloatsGreater(neighborCenter.y + radius, boundaries[3])) {
+      continue;
+    }
+    // Skip the neighbors that are overlapping with the placed bubbles
+    bool overlap = false;
+    grid.ForEachNear(neighborCenter, 2 * radius,
+                     [&](const BubbleGrid::Entry& entry) {
+                       if (areFloatsLess(
+                               glm::distance(neighborCenter, entry.center),
+                               2 * radius)) {
+                         overlap = true;
+                       }
+                     });
+    if (!overlap) {
+      neighborCenters.emplace_back(neighborCenter);
+    }
+  }
+  return neighborCenters;
+}
+
+void LevelGenerator::UpdateFreeSlots(glm::vec2 bubbleCenter) {
+  const float radius = params.bubbleRadius;
+  const GameLevel& gameLevel = params.gameLevel;
+  // Remove the free slots whose distance to the bubble center is less than
+  // 2*radius.
+  freeSlots.RemoveCloserThan(bubbleCenter, 2 * radius);
+
+  // The remaining free slots that are neighbors of the bubble are now adjacent
+  // to a placed bubble.
+  freeSlots.MarkAdjacent(bubbleCenter, 2 * radius - 0.5f, 2 * radius + 0.5f);
+
+  // Add the potential free slots unless they are too close to the bottom or
+  // within the ellipse around the shooter. They are all neighbors of the
+  // bubble.
+  Ellipse ellipse(params.shooterCenter,
+                  gameLevel.minHorizontalDistanceToShooter,
+                  gameLevel.minVerticalDistanceToShooter);
+  float bottomBound = params.boundaries[3] - gameLevel.minDistanceToBottom;
+  for (auto& center : GetPotentialNeighborFreeSlots(bubbleCenter)) {
+    if (center.y > bottomBound || ellipse.isWithin(center)) {
+      continue;
+    }
+    freeSlots.Insert(center, /*isAdjacent=*/true);
+  }
+}
+
+glm::vec2 LevelGenerator::GetRandomFreeSlotNextToPlacedBubbles() {
+  assert(!freeSlots.Empty() && "There should be at least one free slot.");
+  // Fall back to any free slot in case no free slot is next to a placed
+  // bubble.
+  if (freeSlots.AdjacentSize() == 0) {
+    return freeSlots.GetSlot(GetRandomIndex(freeSlots.Size()));
+  }
+  return freeSlots.GetAdjacentSlot(GetRandomIndex(freeSlots.AdjacentSize()));
+}
+
+size_t LevelGenerator::GetRandomIndex(size_t size) {
+  assert(size > 0 && "Cannot select from an empty range.");
+  std::uniform_int_distribution<size_t> distr(0, size - 1);
+  return distr(rng);
+}
+
+bool LevelGenerator::GetRandomBool(float probability) {
+  std::uniform_real_distribution<float> distr(0.f, 1.f);
+  return distr(rng) < probability;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <random>
+#include <vector>
+
+#include "BubbleGrid.h"
+#include "FreeSlotSet.h"
+#include "Random.h"
+#include "SimulationUtils.h"
+
+struct GameLevel {
+  // Num of colors
+  int numColors{};
+  // The number of bubbles that are generated at the beginning of the game
+  int numInitialBubbles{};
+  // The least distance between the bubble and the bottom of the game board
+  float minDistanceToBottom{};
+  // The parameters for the ellipse centered at the shooter and the new bubble
+  // should be generated outside of it.
+  float minHorizontalDistanceToShooter{}, minVerticalDistanceToShooter{};
+  // Probability that a new bubble is generated adjacent to the most recently
+  // added bubble
+  float probabilityNewBubbleIsNeighborOfLastAdded{};
+  // Probability that a new bubble is generated as a neighbor of an existing
+  // bubble
+  float probabilityNewBubbleIsNeighborOfBubble{};
+  // Probability that a new bubble is generated as a neighbor of an existing
+  // bubble of the same color
+  float probabilityNewBubbleIsNeighborOfBubbleOfSameColor{};
+  // possibility that the new bubble is new color compared to the last bubble
+  float probabilityNewBubbleIsNewColor{};
+  // time interval for narrowing the game board vertically
+  float narrowingTimeInterval{};
+};
+
+// Everything needed to generate the static bubbles of a level. It is a plain
+// copy of the game state so that the generation can run on any thread.
+struct LevelGenerationParams {
+  int level{};
+  GameLevel gameLevel;
+  float bubbleRadius{};
+  // Boundaries of the game board (left, upper, right, lower).
+  glm::vec4 boundaries{0.f};
+  // Center of the carried bubble of the shooter when the level starts.
+  glm::vec2 shooterCenter{0.f};
+  // Seed of the random number engine of the generation.
+  unsigned int seed{};
+};
+
+// The generated static bubbles of a level.
+struct LevelLayout {
+  int level{};
+  GameLevel gameLevel;
+  float bubbleRadius{};
+  std::vector<glm::vec2> centers;
+  std::vector<Color> colors;
+};
+
+// LevelGenerator places the static bubbles of a level one by one, either on
+// the top of the game board or as the neighbor of a placed bubble. It only
+// works on its own data and does not touch any global state, so it can run on
+// a worker thread.
+class LevelGenerator {
+ public:
+  explicit LevelGenerator(const LevelGenerationParams& params);
+  ~LevelGenerator() = default;
+
+  // Generate the layout of the level.
+  LevelLayout Generate();
+
+ private:
+  LevelGenerationParams params;
+  Xoshiro256 rng;
+  // Placed bubbles. The ids are the indices in the layout.
+  BubbleGrid grid;
+  FreeSlotSet freeSlots;
+  LevelLayout layout;
+
+  // Get the indices of the placed bubbles that are neighbors of the center.
+  std::vector<int> GetNeighborIds(glm::vec2 center) const;
+
+  // Get potential neighbor free slots of the given bubble.
+  std::vector<glm::vec2> GetPotentialNeighborFreeSlots(
+      glm::vec2 bubbleCenter) const;
+
+  // Update the free slots after placing a bubble at the given center.
+  void UpdateFreeSlots(glm::vec2 bubbleCenter);
+
+  // Randomly select a free slot that is a neighbor of a placed bubble.
+  glm::vec2 GetRandomFreeSlotNextToPlacedBubbles();
+
+  // Get a random index in [0, size).
+  size_t GetRandomIndex(size_t size);
+
+  // Decide true or false with a given probability.
+  bool GetRandomBool(float probability);
+};
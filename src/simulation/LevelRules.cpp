@@ -0,0 +1,149 @@
+/*
+ * LevelRules.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LevelRules.h"
+
+#include <cmath>
+#include <glm/glm.hpp>
+
+#include "SimulationUtils.h"
+
+int getNumGameLevels(Difficulty difficulty) {
+  switch (difficulty) {
+    case Difficulty::EASY:
+      return 15;
+    case Difficulty::MEDIUM:
+      return 30;
+    case Difficulty::HARD:
+      return 45;
+    case Difficulty::EXPERT:
+      return 60;
+    default:
+      return 30;
+  }
+}
+
+int getBubbleNumForLevel(int level, Difficulty difficulty) {
+  if (level <= 10) {
+    int base = 10;
+    if (difficulty == Difficulty::MEDIUM) {
+      base += 5;
+    } else if (difficulty == Difficulty::HARD) {
+      base += 10;
+    } else if (difficulty == Difficulty::EXPERT) {
+      base += 15;
+    }
+    return base + level * 5;
+  } else if (level <= 20) {
+    int base = 40;
+    if (difficulty == Difficulty::MEDIUM) {
+      base += 5;
+    } else if (difficulty == Difficulty::HARD) {
+      base += 10;
+    } else if (difficulty == Difficulty::EXPERT) {
+      base += 15;
+    }
+    return base + (level - 10) * 5;
+  } else if (level <= 30) {
+    int base = 75;
+    if (difficulty == Difficulty::HARD) {
+      base += 10;
+    } else if (difficulty == Difficulty::EXPERT) {
+      base += 15;
+    }
+    return base + (level - 20) * 5;
+  } else if (level <= 40) {
+    int base = 105;
+    if (difficulty == Difficulty::HARD) {
+      base += 10;
+    } else if (difficulty == Difficulty::EXPERT) {
+      base += 15;
+    }
+    return base + (level - 30) * 5;
+  } else if (level <= 50) {
+    int base = 140;
+    if (difficulty == Difficulty::EXPERT) {
+      base += 15;
+    }
+    return base + (level - 40) * 5;
+  } else if (level <= 60) {
+    int base = 170;
+    return base + (level - 50) * 5;
+  } else {
+    return 120;
+  }
+}
+
+float getBubbleRadiusForLevel(int level, float baseUnit) {
+  return baseUnit * std::pow(0.9f, (level - 1) / 10);
+}
+
+float getNarrowingStep(float bubbleRadius) { return bubbleRadius; }
+
+GameLevel makeGameLevel(int level, Difficulty difficulty, float baseUnit) {
+  float bubbleRadius = getBubbleRadiusForLevel(level, baseUnit);
+  int numGameLevels = getNumGameLevels(difficulty);
+  GameLevel gameLevel;
+  gameLevel.numColors =
+      level < kNumColors ? std::sqrt(level * 4.f - 3.f) : kNumColors;
+  gameLevel.numInitialBubbles = getBubbleNumForLevel(level, difficulty);
+  gameLevel.minDistanceToBottom = 4 * baseUnit + bubbleRadius;
+  gameLevel.minHorizontalDistanceToShooter = 3 * baseUnit + bubbleRadius;
+  gameLevel.minVerticalDistanceToShooter = 6 * baseUnit;
+  float difficultyScalingFactor = 0.75f;
+  switch (difficulty) {
+    case Difficulty::MEDIUM:
+      difficultyScalingFactor += 0.03f;
+      break;
+    case Difficulty::HARD:
+      difficultyScalingFactor += 0.06f;
+      break;
+    case Difficulty::EXPERT:
+      difficultyScalingFactor += 0.09f;
+      break;
+    default:
+      break;
+  }
+  gameLevel.probabilityNewBubbleIsNeighborOfLastAdded =
+      1.f - difficultyScalingFactor / numGameLevels * level;
+  gameLevel.probabilityNewBubbleIsNeighborOfBubble =
+      1.f - difficultyScalingFactor / numGameLevels * level;
+  gameLevel.probabilityNewBubbleIsNeighborOfBubbleOfSameColor =
+      1.f - difficultyScalingFactor / numGameLevels * level;
+
+  float baseTime = 9.f, initialTime = 18.f;
+  switch (difficulty) {
+    case Difficulty::MEDIUM:
+      initialTime -= 1.f;
+      break;
+    case Difficulty::HARD:
+      baseTime -= 1.f;
+      initialTime -= 2.f;
+      break;
+    case Difficulty::EXPERT:
+      baseTime -= 2.f;
+      initialTime -= 3.f;
+      break;
+    default:
+      // Easy levels keep the base and initial times as they are.
+      break;
+  }
+  gameLevel.narrowingTimeInterval =
+      glm::mix(initialTime, baseTime, (level - 1) * 1.f / numGameLevels);
+  return gameLevel;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "LevelGenerator.h"
+
+enum class Difficulty { UNDEFINED, EASY, MEDIUM, HARD, EXPERT };
+
+// Get the number of levels of the game at the given difficulty.
+int getNumGameLevels(Difficulty difficulty);
+
+// Get the number of bubbles that are generated at the beginning of the level.
+int getBubbleNumForLevel(int level, Difficulty difficulty);
+
+// Get the radius of the bubbles of the level. It decreases as per 10 levels.
+float getBubbleRadiusForLevel(int level, float baseUnit);
+
+// Get how far the upper and the lower boundaries of the game board move in
+// each time the board narrows. The scroll narrows around its center, so its
+// silk shortens by twice this.
+float getNarrowingStep(float bubbleRadius);
+
+// Get the parameters of the level at the given difficulty, where baseUnit is
+// the base unit of the game that all the distances are measured in.
+GameLevel makeGameLevel(int level, Difficulty difficulty, float baseUnit);
@@ -0,0 +1,111 @@
+/*
+ * Random.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Random.h"
+
+#include <cassert>
+#include <random>
+
+namespace {
+
+constexpr size_t kNumStreams = static_cast<size_t>(RandomStream::kNumStreams);
+
+struct Streams {
+  uint64_t seed{0};
+  std::array<Xoshiro256, kNumStreams> generators;
+
+  void Seed(uint64_t seed) {
+    this->seed = seed;
+    generators[0].Seed(seed);
+    for (size_t i = 1; i < kNumStreams; ++i) {
+      generators[i] = generators[i - 1];
+      generators[i].Jump();
+    }
+  }
+};
+
+Streams& getStreams() {
+  static Streams streams = [] {
+    std::random_device device;
+    Streams seeded;
+    seeded.Seed((static_cast<uint64_t>(device()) << 32) | device());
+    return seeded;
+  }();
+  return streams;
+}
+
+}  // namespace
+
+void Xoshiro256::Seed(uint64_t seed) {
+  for (uint64_t& word : state) {
+    uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    word = z ^ (z >> 31);
+  }
+}
+
+void Xoshiro256::Jump() {
+  static constexpr uint64_t kJump[] = {0x180ec6d33cfd0abaull,
+                                       0xd5a61266f0c9392cull,
+                                       0xa9582618e03fc9aaull,
+                                       0x39abdc4529b1661cull};
+  std::array<uint64_t, 4> jumped{0, 0, 0, 0};
+  for (uint64_t jump : kJump) {
+    for (int bit = 0; bit < 64; ++bit) {
+      if (jump & (1ull << bit)) {
+        for (size_t i = 0; i < state.size(); ++i) {
+          jumped[i] ^= state[i];
+        }
+      }
+      (*this)();
+    }
+  }
+  state = jumped;
+}
+
+int64_t Xoshiro256::UniformInt(int64_t min, int64_t max) {
+  assert(min <= max && "The range is empty.");
+  uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+  if (range == 0) {
+    // The range covers all the 64-bit integers.
+    return static_cast<int64_t>((*this)());
+  }
+  // Reject the lowest draws that would make the lower remainders more likely.
+  uint64_t threshold = (0 - range) % range;
+  uint64_t draw = (*this)();
+  while (draw < threshold) {
+    draw = (*this)();
+  }
+  return static_cast<int64_t>(static_cast<uint64_t>(min) + draw % range);
+}
+
+void Xoshiro256::FillUniform(float* values, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = NextFloat();
+  }
+}
+
+void Random::Seed(uint64_t seed) { getStreams().Seed(seed); }
+
+uint64_t Random::GetSeed() { return getStreams().seed; }
+
+Xoshiro256& Random::Get(RandomStream stream) {
+  assert(stream != RandomStream::kNumStreams && "Invalid random stream.");
+  return getStreams().generators[static_cast<size_t>(stream)];
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Xoshiro256 is the xoshiro256** generator: four 64-bit words of state, a few
+// shifts and rotations per draw, and a period of 2^256 - 1. It meets the
+// requirements of a uniform random bit generator, so the std distributions can
+// draw from it, and it draws uniform floats directly, one at a time or in bulk.
+class Xoshiro256 {
+ public:
+  using result_type = uint64_t;
+
+  explicit Xoshiro256(uint64_t seed = 0) { Seed(seed); }
+
+  // Reset the state from a seed, expanded to the four words with splitmix64.
+  void Seed(uint64_t seed);
+
+  // Advance the state by 2^128 draws. Generators jumped from the same state
+  // by different numbers of jumps draw non-overlapping sequences.
+  void Jump();
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    uint64_t result = Rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = Rotl(state[3], 45);
+    return result;
+  }
+
+  // Draw a float uniformly from [0, 1) out of the upper 24 bits of a draw.
+  float NextFloat() {
+    return static_cast<float>((*this)() >> 40) * (1.f / (1 << 24));
+  }
+
+  // Draw a float uniformly from [min, max).
+  float Uniform(float min, float max) {
+    return min + (max - min) * NextFloat();
+  }
+
+  // Draw an integer uniformly from [min, max].
+  int64_t UniformInt(int64_t min, int64_t max);
+
+  // Fill the values with floats drawn uniformly from [0, 1).
+  void FillUniform(float* values, size_t count);
+
+  // Get or restore the four words of state, to snapshot the generator.
+  const std::array<uint64_t, 4>& GetState() const { return state; }
+  void SetState(const std::array<uint64_t, 4>& state) { this->state = state; }
+
+ private:
+  std::array<uint64_t, 4> state;
+
+  static constexpr uint64_t Rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+// Independent streams of random numbers of the game.
+enum class RandomStream {
+  // Seeds of the generated levels.
+  kLevel,
+  // Colors of the shooter's bubbles, arrows and the other gameplay decisions.
+  kGameplay,
+  // Spawned particles.
+  kParticles,
+  // Choice of the background music.
+  kAudio,
+  kNumStreams,
+};
+
+// Random is the random number service of the game. Every stream has its own
+// generator, and the generators are jumped apart from a single seed, so how
+// many numbers one stream draws never shifts the numbers of another. The
+// audio stream in particular is drawn from whenever a track ends, which
+// depends on the audio device, and does not disturb the gameplay.
+//
+// The service seeds itself from std::random_device until Seed is called. The
+// generators are not locked, so a stream must only be drawn from by one thread
+// at a time.
+class Random {
+ public:
+  // Reseed all the streams.
+  static void Seed(uint64_t seed);
+
+  // Get the seed the streams were last seeded with.
+  static uint64_t GetSeed();
+
+  // Get the generator of a stream.
+  static Xoshiro256& Get(RandomStream stream);
+};
@@ -0,0 +1,49 @@
+/*
+ * Scoring.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "Scoring.h"
+
+#include <cmath>
+
+std::vector<int> calculateScoreIncrements(int numBubbles, float bubbleRadius,
+                                          bool isFalling, int level,
+                                          int numInitialBubbles,
+                                          float timeUsed) {
+  float score = 40.f - 0.5f * bubbleRadius + 0.5f * level * std::sqrt(level) -
+                timeUsed / std::sqrt(numInitialBubbles);
+  if (score < 0.f) {
+    // Map (-inf, 0) to (0, 1).
+    score = std::exp(score);
+  } else {
+    // Map [0, inf) to [1, inf).
+    ++score;
+  }
+  if (isFalling) {
+    score *= 1.5f;
+  }
+  std::vector<int> scoreIncrements;
+  scoreIncrements.reserve(numBubbles);
+  for (int i = 0; i < numBubbles; ++i) {
+    if (i > 2) {
+      score *= 1.2f;
+    }
+    scoreIncrements.push_back(static_cast<int>(std::ceil(score)));
+  }
+  return scoreIncrements;
+}
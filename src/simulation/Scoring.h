@@ -0,0 +1,11 @@
+#pragma once
+#include <vector>
+
+// Get the score increment of each of numBubbles bubbles of the given radius
+// that are exploded, or dropped if isFalling, at the same time. The score of a
+// bubble grows with the level and with the size of the group, and shrinks with
+// the time used to play the level, which has numInitialBubbles bubbles.
+std::vector<int> calculateScoreIncrements(int numBubbles, float bubbleRadius,
+                                          bool isFalling, int level,
+                                          int numInitialBubbles,
+                                          float timeUsed);
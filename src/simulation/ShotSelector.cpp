@@ -0,0 +1,83 @@
+/*
+ * ShotSelector.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ShotSelector.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// The longest a candidate shot is played out, in time steps, before it is
+// given up.
+constexpr int kMaxShotSteps = 10000;
+
+}  // namespace
+
+glm::vec2 selectShotDirection(const BubbleBoard& board, glm::vec2 shooterCenter,
+                              Color color, float speed, float timeStep) {
+  glm::vec2 bestDir(0.f, -1.f);
+  float bestScore = std::numeric_limits<float>::lowest();
+  float radius = board.GetBubbleRadius();
+  for (int i = 0; i < kNumShotCandidates; ++i) {
+    float angle =
+        -kMaxShotAngle + 2 * kMaxShotAngle * i / (kNumShotCandidates - 1);
+    glm::vec2 dir = rotateVector(glm::vec2(0.f, -1.f), glm::radians(angle));
+    glm::vec2 center = shooterCenter;
+    glm::vec2 velocity = dir * speed;
+    bool hasLanded = false;
+    for (int step = 0; step < kMaxShotSteps && !hasLanded; ++step) {
+      hasLanded = BubbleBoard::MoveShot(center, velocity, radius, timeStep,
+                                        board.GetBoundaries(), board.GetGrid());
+    }
+    if (!hasLanded) {
+      continue;
+    }
+    center = board.FindLandingSlot(center, board.GetBoundaries());
+    float score = scoreShotLanding(board, center, color);
+    if (score > bestScore) {
+      bestScore = score;
+      bestDir = dir;
+    }
+  }
+  return bestDir;
+}
+
+float scoreShotLanding(const BubbleBoard& board, glm::vec2 center,
+                       Color color) {
+  const BubbleStore& bubbles = board.GetStore();
+  // Collect the groups of the same color the shot would join.
+  std::vector<int> groupIds;
+  for (int neighborId : board.GetNeighborIds(center)) {
+    if (bubbles.GetColor(neighborId) != color ||
+        std::find(groupIds.begin(), groupIds.end(), neighborId) !=
+            groupIds.end()) {
+      continue;
+    }
+    std::vector<int> connectedIds =
+        board.FindConnectedBubblesOfSameColor(neighborId);
+    groupIds.insert(groupIds.end(), connectedIds.begin(), connectedIds.end());
+  }
+  int groupSize = static_cast<int>(groupIds.size()) + 1;
+  float score = groupSize >= 3 ? 1000.f + 100.f * groupSize : 10.f * groupSize;
+  // Penalize landing low by the number of bubble radii below the top.
+  glm::vec4 boundaries = board.GetBoundaries();
+  score -= (center.y - boundaries.y) / board.GetBubbleRadius();
+  return score;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include "BubbleBoard.h"
+
+// Number of directions a bot tries for a shot, spread evenly within
+// kMaxShotAngle degrees of straight up.
+constexpr int kNumShotCandidates = 31;
+constexpr float kMaxShotAngle = 75.f;
+
+// Pick the direction in which a bot shoots a bubble of the given color from
+// the shooter. Every candidate direction is played out with the physics of
+// the game, BubbleBoard::MoveShot at the given time step as Bubble::Move does,
+// and the direction whose landing scores best is picked.
+glm::vec2 selectShotDirection(const BubbleBoard& board, glm::vec2 shooterCenter,
+                              Color color, float speed, float timeStep);
+
+// Score a shot of the given color that lands at the center. Completing a
+// group of three or more bubbles that pops scores the most, then landing next
+// to bubbles of the same color. Landing lower on the board, closer to the
+// shooter, lowers the score.
+float scoreShotLanding(const BubbleBoard& board, glm::vec2 center,
+                       Color color);
@@ -0,0 +1,150 @@
+/*
+ * SimulationUtils.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SimulationUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtx/rotate_vector.hpp>
+
+bool areFloatsEqual(float a, float b, float epsilon) {
+  return std::abs(a - b) < epsilon;
+}
+
+bool areFloatsEqual(const glm::vec2& a, const glm::vec2& b, float epsilon) {
+  return areFloatsEqual(a.x, b.x, epsilon) && areFloatsEqual(a.y, b.y, epsilon);
+}
+
+bool areFloatsEqual(const glm::vec3& a, const glm::vec3& b, float epsilon) {
+  return areFloatsEqual(a.r, b.r, epsilon) &&
+         areFloatsEqual(a.g, b.g, epsilon) && areFloatsEqual(a.b, b.b, epsilon);
+}
+
+bool areFloatsLess(float a, float b, float epsilon) {
+  return a < b && !areFloatsEqual(a, b, epsilon);
+}
+
+bool areFloatsGreater(float a, float b, float epsilon) {
+  return a > b && !areFloatsEqual(a, b, epsilon);
+}
+
+float lawOfCosines(float a, float b, float cosgamma) {
+  return std::sqrt(a * a + b * b - 2 * a * b * cosgamma);
+}
+
+std::pair<float, float> lawOfCosinesB(float a, float c, float cosgamma) {
+  float firstPart = a * cosgamma;
+  float secondPart = a * std::sqrt(cosgamma * cosgamma - 1 + (c * c) / (a * a));
+  return std::make_pair(firstPart - secondPart, firstPart + secondPart);
+}
+
+float lawOfCosinesCos(float a, float b, float c) {
+  return (a * a + b * b - c * c) / (2 * a * b);
+}
+
+float lawOfCosinesAngle(float a, float b, float c) {
+  return glm::acos(lawOfCosinesCos(a, b, c));
+}
+
+glm::vec2 rotateVector(glm::vec2 point, float angle, glm::vec2 pivot) {
+  // translate the vector so that the point is at the origin
+  point -= pivot;
+  // rotate the vector using glm::rotate
+  point = glm::rotate(point, angle);
+  // translate the vector back to its original position
+  point += pivot;
+  return point;
+}
+
+int getSignOfCrossProduct(glm::vec2 a, glm::vec2 b) {
+  // Use glm::cross to calculate the cross product of a and b
+  float crossProduct = glm::cross(glm::vec3(a, 0.0f), glm::vec3(b, 0.0f)).z;
+  // return 1 if crossProduct is positive, -1 if crossProduct is negative, and 0
+  // if crossProduct is 0
+  if (crossProduct > 0) {
+    return 1;
+  } else if (crossProduct < 0) {
+    return -1;
+  } else {
+    return 0;
+  }
+}
+
+bool isSameColor(glm::vec3 rgb1, glm::vec3 rgb2) {
+  return areFloatsEqual(rgb1.r, rgb2.r) && areFloatsEqual(rgb1.g, rgb2.g) &&
+         areFloatsEqual(rgb1.b, rgb2.b);
+}
+
+Color colorToEnum(glm::vec3 rgb) {
+  for (int i = 0; i < kNumColors; ++i) {
+    if (isSameColor(toRgb(static_cast<Color>(i)), rgb)) {
+      return static_cast<Color>(i);
+    }
+  }
+  return Color::Red;
+}
+
+bool isDeepColor(Color color) {
+  return color == Color::Pink || color == Color::Purple ||
+         color == Color::Blue || color == Color::Red || color == Color::Brown ||
+         color == Color::JadeGreen;
+}
+
+bool isDeepColor(glm::vec3 rgb) { return isDeepColor(colorToEnum(rgb)); }
+
+std::optional<std::pair<float, float>> solveQuadratic(float a, float b,
+                                                      float c) {
+  float discriminant = b * b - 4 * a * c;
+  if (discriminant < 0) {
+    // No real roots
+    return std::nullopt;
+  }
+  float sqrtDiscriminant = std::sqrt(discriminant);
+  float root1 = (-b + sqrtDiscriminant) / (2 * a);
+  float root2 = (-b - sqrtDiscriminant) / (2 * a);
+  return std::make_pair(root1, root2);
+}
+
+std::optional<float> sweptCircleTimeOfImpact(glm::vec2 center,
+                                             glm::vec2 displacement,
+                                             glm::vec2 otherCenter,
+                                             float sumOfRadius) {
+  // Solve |center + displacement * t - otherCenter| = sumOfRadius for t.
+  glm::vec2 offset = center - otherCenter;
+  float a = glm::dot(displacement, displacement);
+  float b = 2.f * glm::dot(offset, displacement);
+  float c = glm::dot(offset, offset) - sumOfRadius * sumOfRadius;
+  if (c <= 0.f) {
+    // Already touching. Only report it if the circles are getting closer.
+    return b < 0.f ? std::optional<float>(0.f) : std::nullopt;
+  }
+  if (a == 0.f || b >= 0.f) {
+    // Not moving or moving away from the other circle.
+    return std::nullopt;
+  }
+  auto roots = solveQuadratic(a, b, c);
+  if (!roots.has_value()) {
+    return std::nullopt;
+  }
+  // The smaller root is the time when the circles start touching.
+  float t = std::min(roots->first, roots->second);
+  if (t < 0.f || t > 1.f) {
+    return std::nullopt;
+  }
+  return t;
+}
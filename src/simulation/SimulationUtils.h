@@ -0,0 +1,134 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+// Math and color helpers shared by the board simulation and the rest of the
+// game. Nothing in here depends on OpenGL, audio or any window state.
+
+// Colors of the bubbles. A bubble carries its color as an index into the
+// palette, which is turned into RGB only when it is drawn.
+enum class Color : uint8_t {
+  Red,
+  Green,
+  Blue,
+  Yellow,
+  Pink,
+  Purple,
+  Orange,
+  Cyan,
+  White,
+  LightBlue,
+  Brown,
+  JadeGreen,
+};
+
+// Number of colors of the palette.
+constexpr int kNumColors = static_cast<int>(Color::JadeGreen) + 1;
+
+// RGB values of the colors, indexed by the colors.
+struct PaletteColor {
+  float r, g, b;
+};
+constexpr std::array<PaletteColor, kNumColors> kColorPalette = {{
+    {1.0f, 0.0f, 0.0f},
+    {0.0f, 1.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f},
+    {1.0f, 1.0f, 0.0f},
+    {0.949f, 0.4078f, 0.5725f},
+    {0.5f, 0.0f, 0.5f},
+    {1.0f, 0.65f, 0.0f},
+    {0.0f, 1.0f, 1.0f},
+    {1.0f, 1.0f, 1.0f},
+    {0.678f, 0.847f, 0.902f},
+    {0.6471f, 0.1647f, 0.1647f},
+    {0.0f, 0.6588f, 0.4196f},
+}};
+
+// Values kept per color, such as tallies of the bubbles of each color, indexed
+// by toIndex.
+template <typename T>
+using ColorArray = std::array<T, kNumColors>;
+
+// Get the index of a color in the palette and in a ColorArray.
+constexpr size_t toIndex(Color color) { return static_cast<size_t>(color); }
+
+// Get the RGB value of a color.
+inline glm::vec3 toRgb(Color color) {
+  const PaletteColor& rgb = kColorPalette[toIndex(color)];
+  return glm::vec3(rgb.r, rgb.g, rgb.b);
+}
+
+// number of directions of a neighbor bubble
+const int kNumNeighborDirections = 12;
+
+struct Ellipse {
+  glm::vec2 center;
+  float a;
+  float b;
+  // Checks if a point is within the ellipse (including the boundary).
+  bool isWithin(const glm::vec2& point) const {
+    return (point.x - center.x) * (point.x - center.x) / (a * a) +
+               (point.y - center.y) * (point.y - center.y) / (b * b) <=
+           1;
+  }
+};
+
+bool areFloatsEqual(float a, float b, float epsilon = 1e-4);
+
+bool areFloatsEqual(const glm::vec2& a, const glm::vec2& b,
+                    float epsilon = 1e-4);
+
+bool areFloatsEqual(const glm::vec3& a, const glm::vec3& b,
+                    float epsilon = 1e-4);
+
+bool areFloatsLess(float a, float b, float epsilon = 1e-4);
+
+bool areFloatsGreater(float a, float b, float epsilon = 1e-4);
+
+// Calculate the length of C using the law of cosines
+float lawOfCosines(float a, float b, float cosgamma);
+
+// Calculate the lengthn of B using the law of cosines
+std::pair<float, float> lawOfCosinesB(float a, float c, float cosgamma);
+
+// Calculate the cosine of the angle using the law of cosines
+float lawOfCosinesCos(float a, float b, float c);
+
+// Calculate the angle using the law of cosines
+float lawOfCosinesAngle(float a, float b, float c);
+
+// Rotate a vector by a given angle around a point. clockwise is positive while
+// counter-clockwise is negative
+glm::vec2 rotateVector(glm::vec2 point, float angle,
+                       glm::vec2 pivot = glm::vec2(0.0f, 0.0f));
+
+// Get the sign of the cross product of two vectors
+int getSignOfCrossProduct(glm::vec2 a, glm::vec2 b);
+
+// Check if two colors are the same
+bool isSameColor(glm::vec3 rgb1, glm::vec3 rgb2);
+
+// Convert a color to a Color enum
+Color colorToEnum(glm::vec3 rgb);
+
+// Color is deep or not
+bool isDeepColor(Color color);
+bool isDeepColor(glm::vec3 rgb);
+
+// Solve a quadratic equation
+std::optional<std::pair<float, float>> solveQuadratic(float a, float b,
+                                                      float c);
+
+// Get the fraction of the displacement at which a circle moving from center by
+// displacement first touches a static circle, where sumOfRadius is the sum of
+// the two radii. Returns nothing if they do not touch within the displacement.
+// If the circles already overlap and are getting closer, the fraction is 0.
+std::optional<float> sweptCircleTimeOfImpact(glm::vec2 center,
+                                             glm::vec2 displacement,
+                                             glm::vec2 otherCenter,
+                                             float sumOfRadius);
@@ -0,0 +1,33 @@
+/*
+ * Snapshot.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Snapshot.h"
+
+SnapshotWriter::SnapshotWriter() {
+  Write(kSnapshotMagic);
+  Write(kSnapshotVersion);
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size)
+    : data(data), size(size) {
+  uint32_t magic = 0, version = 0;
+  if (!Read(magic) || !Read(version) || magic != kSnapshotMagic ||
+      version != kSnapshotVersion) {
+    isValid = false;
+  }
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// A snapshot is a flat binary image of the state of a game, written field by
+// field into a byte buffer and read back in the same order. Fields are copied
+// with the byte order of the machine, which is little endian on every platform
+// the game ships on, and dense arrays are copied in one go, so saving and
+// loading a full board is a few memcpy calls.
+//
+// Every snapshot starts with a magic number and a version. A reader refuses a
+// snapshot of another version, so the version must be bumped whenever the
+// layout of any saved state changes.
+//
+// A snapshot may come from anywhere, so the bytes of bools and enums are
+// checked before they are used: bools are read by Read and enums by ReadEnum,
+// and those within structs and arrays are checked with isValidBool and
+// isEnumInRange once read.
+constexpr uint32_t kSnapshotMagic = 0x53534444;  // "DDSS"
+constexpr uint32_t kSnapshotVersion = 3;
+
+// Check if a bool copied from a snapshot, possibly within a struct, holds 0 or
+// 1. Its byte is inspected, as using a bool of any other byte is undefined.
+inline bool isValidBool(const bool& value) {
+  uint8_t byte = 0;
+  std::memcpy(&byte, &value, sizeof(byte));
+  return byte <= 1;
+}
+
+// Check if an enum copied from a snapshot, possibly within a struct or an
+// array, is one of the enumerators from 0 to last.
+template <typename T>
+bool isEnumInRange(T value, T last) {
+  static_assert(std::is_enum_v<T>, "Only enums can be checked.");
+  auto underlying = static_cast<int64_t>(value);
+  return underlying >= 0 && underlying <= static_cast<int64_t>(last);
+}
+
+// SnapshotWriter appends fields to a byte buffer.
+class SnapshotWriter {
+ public:
+  // Start a snapshot with the magic number and the version.
+  SnapshotWriter();
+  ~SnapshotWriter() = default;
+
+  // Append a field of a trivially copyable type.
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable fields can be written.");
+    size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+  }
+
+  // Append the number of values and then the values of a dense array.
+  template <typename T>
+  void WriteArray(const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable arrays can be written.");
+    Write(static_cast<uint64_t>(values.size()));
+    size_t offset = buffer.size();
+    buffer.resize(offset + values.size() * sizeof(T));
+    if (!values.empty()) {
+      std::memcpy(buffer.data() + offset, values.data(),
+                  values.size() * sizeof(T));
+    }
+  }
+
+  // Get the bytes written so far.
+  const std::vector<uint8_t>& GetBuffer() const { return buffer; }
+
+ private:
+  std::vector<uint8_t> buffer;
+};
+
+// SnapshotReader reads the fields of a snapshot in the order they were
+// written. Once a read runs past the end of the snapshot, it and all the
+// following reads fail and leave their values untouched.
+class SnapshotReader {
+ public:
+  // Check the magic number and the version of the snapshot. IsValid tells
+  // whether they match.
+  SnapshotReader(const uint8_t* data, size_t size);
+  explicit SnapshotReader(const std::vector<uint8_t>& buffer)
+      : SnapshotReader(buffer.data(), buffer.size()) {}
+  ~SnapshotReader() = default;
+
+  // Read a field of a trivially copyable type. Return false if the snapshot
+  // is too short or a previous read failed.
+  template <typename T>
+  bool Read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable fields can be read.");
+    if (!isValid || size - offset < sizeof(T)) {
+      isValid = false;
+      return false;
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+      if (data[offset] > 1) {
+        isValid = false;
+        return false;
+      }
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+  }
+
+  // Read an enum, which must be one of the enumerators from 0 to last.
+  template <typename T>
+  bool ReadEnum(T& value, T last) {
+    static_assert(std::is_enum_v<T>, "Only enums can be read as enums.");
+    std::underlying_type_t<T> underlying{};
+    if (!Read(underlying) || static_cast<int64_t>(underlying) < 0 ||
+        static_cast<int64_t>(underlying) > static_cast<int64_t>(last)) {
+      isValid = false;
+      return false;
+    }
+    value = static_cast<T>(underlying);
+    return true;
+  }
+
+  // Read a dense array written by WriteArray.
+  template <typename T>
+  bool ReadArray(std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable arrays can be read.");
+    uint64_t count = 0;
+    if (!Read(count) || count > (size - offset) / sizeof(T)) {
+      isValid = false;
+      return false;
+    }
+    values.resize(count);
+    if (count > 0) {
+      std::memcpy(values.data(), data + offset, count * sizeof(T));
+    }
+    offset += count * sizeof(T);
+    return true;
+  }
+
+  // Check if the header matched and every read so far succeeded.
+  bool IsValid() const { return isValid; }
+
+  // Check if the whole snapshot has been read.
+  bool IsAtEnd() const { return offset == size; }
+
+ private:
+  const uint8_t* data;
+  size_t size;
+  size_t offset{0};
+  bool isValid{true};
+};
@@ -0,0 +1,87 @@
+/*
+ * WorkStealingPool.cpp
+ * Copyright (C) 2024 Oliver Liu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int numThreads) {
+  if (numThreads <= 0) {
+    numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  this->numThreads = std::max(numThreads, 1);
+  for (int i = 0; i < this->numThreads; ++i) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+}
+
+void WorkStealingPool::ParallelFor(
+    size_t numTasks, const std::function<void(size_t, int)>& task) {
+  // Deal the tasks out in contiguous blocks.
+  for (int i = 0; i < numThreads; ++i) {
+    size_t begin = numTasks * i / numThreads;
+    size_t end = numTasks * (i + 1) / numThreads;
+    std::lock_guard<std::mutex> lock(workers[i]->mutex);
+    for (size_t index = begin; index < end; ++index) {
+      workers[i]->tasks.push_back(index);
+    }
+  }
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numThreads; ++i) {
+    threads.emplace_back(&WorkStealingPool::Work, this, i, std::cref(task));
+  }
+  Work(0, task);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::Work(int thread,
+                            const std::function<void(size_t, int)>& task) {
+  size_t index = 0;
+  while (PopTask(thread, index) || StealTask(thread, index)) {
+    task(index, thread);
+  }
+}
+
+bool WorkStealingPool::PopTask(int thread, size_t& task) {
+  Worker& worker = *workers[thread];
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  if (worker.tasks.empty()) {
+    return false;
+  }
+  task = worker.tasks.back();
+  worker.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingPool::StealTask(int thread, size_t& task) {
+  // No tasks are added while the loop runs, so the loop is over for this
+  // thread once a round over the other threads finds nothing to steal.
+  for (int i = 1; i < numThreads; ++i) {
+    Worker& victim = *workers[(thread + i) % numThreads];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// WorkStealingPool runs the tasks of a parallel loop on a number of threads.
+// The tasks are dealt out to the threads in contiguous blocks. A thread runs
+// its own tasks from the back of its deque and, once it runs out, steals tasks
+// from the front of the deques of the other threads, so that threads whose
+// tasks are quick help with the tasks that take long.
+class WorkStealingPool {
+ public:
+  // Constructor. A numThreads of 0 uses a thread per hardware thread.
+  explicit WorkStealingPool(int numThreads = 0);
+  ~WorkStealingPool() = default;
+
+  int GetNumThreads() const { return numThreads; }
+
+  // Run task(index, thread) for every index in [0, numTasks) and return once
+  // all of them have run. thread is the index of the thread in [0,
+  // GetNumThreads()) that runs the task, and the calling thread is one of
+  // them.
+  void ParallelFor(size_t numTasks,
+                   const std::function<void(size_t, int)>& task);
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  int numThreads{1};
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  // Run the tasks of a thread and steal the tasks of the others until none
+  // are left.
+  void Work(int thread, const std::function<void(size_t, int)>& task);
+  bool PopTask(int thread, size_t& task);
+  bool StealTask(int thread, size_t& task);
+};
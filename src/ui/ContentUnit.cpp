@@ -267,15 +267,15 @@ void OptionUnit::SetState(OptionState state) {
   switch (state_) {
     case OptionState::kClicked:
       // Set color to green
-      icon_->SetColor(glm::vec4(colorMap.at(Color::Green), 1.0f));
+      icon_->SetColor(glm::vec4(toRgb(Color::Green), 1.0f));
       break;
     case OptionState::kHovered:
       // Set color to yellow
-      icon_->SetColor(glm::vec4(colorMap.at(Color::Yellow), 1.0f));
+      icon_->SetColor(glm::vec4(toRgb(Color::Yellow), 1.0f));
       break;
     default:
       // Set color to white
-      icon_->SetColor(glm::vec4(colorMap.at(Color::White), 1.0f));
+      icon_->SetColor(glm::vec4(toRgb(Color::White), 1.0f));
       break;
   }
 }
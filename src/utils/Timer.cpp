@@ -18,94 +18,283 @@
 
 #include "Timer.h"
 
-void Timer::SetEventTimer(std::string eventName, float time) {
-  eventTimers[eventName] = time;
+#include <utility>
+
+Timer::Timer(float tickDuration) : tickDuration(tickDuration) {
+  assert(tickDuration > 0.f && "Tick duration must be positive");
+  buckets.fill(-1);
+}
+
+void Timer::Tick() {
+  ++currentTick;
+
+  // Cascade the bucket of each outer wheel whose span starts at this tick
+  // into the inner wheels.
+  for (int wheel = 1; wheel < kNumWheels; ++wheel) {
+    int shift = wheel * kWheelBits;
+    if ((currentTick & ((int64_t{1} << shift) - 1)) != 0) {
+      break;
+    }
+    int bucket = wheel * kWheelSize +
+                 static_cast<int>((currentTick >> shift) & (kWheelSize - 1));
+    int event = buckets[bucket];
+    buckets[bucket] = -1;
+    while (event != -1) {
+      int next = events[event].next;
+      events[event].bucket = -1;
+      events[event].prev = -1;
+      events[event].next = -1;
+      Schedule(event);
+      event = next;
+    }
+  }
+
+  // Flag the events in the bucket of this tick as expired.
+  int bucket = static_cast<int>(currentTick & (kWheelSize - 1));
+  int event = buckets[bucket];
+  buckets[bucket] = -1;
+  while (event != -1) {
+    Event& e = events[event];
+    assert(e.expiryTick == currentTick && "Event is in the wrong bucket");
+    int next = e.next;
+    e.bucket = -1;
+    e.prev = -1;
+    e.next = -1;
+    e.expired = true;
+    event = next;
+  }
 }
 
-void Timer::StartEventTimer(std::string eventName) {
-  assert(eventTimers.find(eventName) != eventTimers.end() &&
-         "Event timer not found");
-  startTimes[eventName] = glfwGetTime();
-  usedTimes[eventName] = 0.0f;
+void Timer::SetEventTimer(int event, float time) {
+  assert(event >= 0 && "Invalid event");
+  if (static_cast<size_t>(event) >= events.size()) {
+    events.resize(event + 1);
+  }
+  Event& e = events[event];
+  e.time = time;
+  e.durationTicks = std::llround(time / tickDuration);
+  if (e.state == EventState::kUnset) {
+    e.state = EventState::kSet;
+  } else if (e.state == EventState::kRunning) {
+    // Move the running event to its new expiry tick.
+    Unlink(event);
+    e.expired = false;
+    e.expiryTick = e.startTick - e.usedTicks + e.durationTicks;
+    Schedule(event);
+  }
 }
 
-void Timer::PauseEventTimer(std::string eventName) {
-  assert(startTimes.find(eventName) != startTimes.end() &&
-         "Event start time not found");
-  assert(startTimes[eventName] >= 0.f && "Event timer is already paused");
-  usedTimes[eventName] += glfwGetTime() - startTimes[eventName];
-  startTimes[eventName] =
-      -1.0f;  // -1.0f means the timer for this event is paused.
+void Timer::StartEventTimer(int event) {
+  assert(HasEvent(event) && "Event timer not found");
+  Event& e = events[event];
+  Unlink(event);
+  e.state = EventState::kRunning;
+  e.expired = false;
+  e.startTick = currentTick;
+  e.usedTicks = 0;
+  e.expiryTick = currentTick + e.durationTicks;
+  Schedule(event);
 }
 
-void Timer::ResumeEventTimer(std::string eventName) {
-  assert(startTimes.find(eventName) != startTimes.end() &&
-         "Event start time not found");
-  assert(startTimes[eventName] < 0.f && "Event timer is not paused");
-  assert(usedTimes.find(eventName) != usedTimes.end() &&
-         "Event used time not found");
-  startTimes[eventName] = glfwGetTime();
+void Timer::PauseEventTimer(int event) {
+  assert(HasEvent(event) && "Event timer not found");
+  Event& e = events[event];
+  assert(e.state == EventState::kRunning && "Event timer is not running");
+  e.usedTicks += currentTick - e.startTick;
+  e.state = EventState::kPaused;
+  Unlink(event);
 }
 
-bool Timer::IsEventTimerExpired(std::string eventName) {
-  assert(eventTimers.find(eventName) != eventTimers.end() &&
-         "Event timer not found");
-  assert(startTimes.find(eventName) != startTimes.end() &&
-         "Event start time not found");
-  assert(usedTimes.find(eventName) != usedTimes.end() &&
-         "Event used time not found");
-  assert(startTimes[eventName] >= 0.f && "Event timer is paused");
-  if (glfwGetTime() - startTimes[eventName] + usedTimes[eventName] >
-      eventTimers[eventName]) {
-    return true;
+void Timer::ResumeEventTimer(int event) {
+  assert(HasEvent(event) && "Event timer not found");
+  Event& e = events[event];
+  assert(e.state == EventState::kPaused && "Event timer is not paused");
+  e.state = EventState::kRunning;
+  e.expired = false;
+  e.startTick = currentTick;
+  e.expiryTick = currentTick + e.durationTicks - e.usedTicks;
+  Schedule(event);
+}
+
+bool Timer::IsEventTimerExpired(int event) const {
+  const Event& e = GetEvent(event);
+  assert(e.state != EventState::kSet && "Event timer is not started");
+  assert(e.state != EventState::kPaused && "Event timer is paused");
+  return e.expired;
+}
+
+float Timer::GetEventUsedTime(int event) const {
+  const Event& e = GetEvent(event);
+  assert(e.state != EventState::kSet && "Event timer is not started");
+  return static_cast<float>(GetUsedTicks(e)) * tickDuration;
+}
+
+float Timer::GetEventTimer(int event) const { return GetEvent(event).time; }
+
+float Timer::GetEventRemainingTime(int event) const {
+  const Event& e = GetEvent(event);
+  assert(e.state == EventState::kRunning && "Event timer is not running");
+  return e.time - static_cast<float>(GetUsedTicks(e)) * tickDuration;
+}
+
+void Timer::CleanEvent(int event) {
+  if (!HasEvent(event)) {
+    return;
   }
-  return false;
+  Unlink(event);
+  events[event] = Event();
 }
 
-float Timer::GetEventStartTime(std::string eventName) {
-  assert(startTimes.find(eventName) != startTimes.end() &&
-         "Event timer not found");
-  return startTimes[eventName];
+bool Timer::HasEvent(int event) const {
+  return event >= 0 && static_cast<size_t>(event) < events.size() &&
+         events[event].state != EventState::kUnset;
 }
 
-float Timer::GetEventUsedTime(std::string eventName) {
-  assert(startTimes.find(eventName) != startTimes.end() &&
-         "Event start time not found");
-  assert(usedTimes.find(eventName) != usedTimes.end() &&
-         "Event used time not found");
-  return usedTimes[eventName] + glfwGetTime() - startTimes[eventName];
+bool Timer::IsPaused(int event) const {
+  const Event& e = GetEvent(event);
+  assert(e.state != EventState::kSet && "Event timer is not started");
+  return e.state == EventState::kPaused;
 }
 
-float Timer::GetEventTimer(std::string eventName) {
-  assert(eventTimers.find(eventName) != eventTimers.end() &&
-         "Event timer not found");
-  return eventTimers[eventName];
+int64_t Timer::GetCurrentTick() const { return currentTick; }
+
+void Timer::Save(SnapshotWriter& writer) const {
+  writer.Write(tickDuration);
+  writer.Write(currentTick);
+  writer.WriteArray(events);
+  writer.Write(buckets);
 }
 
-float Timer::GetEventRemainingTime(std::string eventName) {
-  assert(eventTimers.find(eventName) != eventTimers.end() &&
-         "Event timer not found");
-  assert(startTimes.find(eventName) != startTimes.end() &&
-         "Event start time not found");
-  assert(usedTimes.find(eventName) != usedTimes.end() &&
-         "Event used time not found");
-  assert(startTimes[eventName] >= 0.f && "Event timer is paused");
-  return eventTimers[eventName] -
-         (glfwGetTime() - startTimes[eventName] + usedTimes[eventName]);
+bool Timer::Load(SnapshotReader& reader) {
+  float tickDuration = 0.f;
+  int64_t currentTick = 0;
+  std::vector<Event> events;
+  std::array<int, kNumWheels * kWheelSize> buckets;
+  if (!reader.Read(tickDuration) || !reader.Read(currentTick) ||
+      !reader.ReadArray(events) || !reader.Read(buckets) ||
+      tickDuration != this->tickDuration) {
+    return false;
+  }
+  // The links must stay within the events and the buckets.
+  int numEvents = static_cast<int>(events.size());
+  for (const Event& e : events) {
+    if (!isEnumInRange(e.state, EventState::kPaused) ||
+        !isValidBool(e.expired) || e.bucket < -1 ||
+        e.bucket >= static_cast<int>(buckets.size()) || e.prev < -1 ||
+        e.prev >= numEvents || e.next < -1 || e.next >= numEvents) {
+      return false;
+    }
+  }
+  for (int head : buckets) {
+    if (head < -1 || head >= numEvents) {
+      return false;
+    }
+  }
+  // Walk the bucket lists. Every event must be listed at most once, in the
+  // bucket it names, with links that agree both ways, and the bucket must be
+  // the next one to expire or cascade at or before the expiry tick of the
+  // event. Only the outermost wheel may hold events due beyond its next
+  // cascade, as those are scheduled again when it comes.
+  std::vector<bool> isListed(events.size(), false);
+  for (int bucket = 0; bucket < static_cast<int>(buckets.size()); ++bucket) {
+    int wheel = bucket / kWheelSize;
+    int shift = wheel * kWheelBits;
+    int64_t slot = bucket % kWheelSize;
+    int64_t nextSpan = (currentTick >> shift) + 1;
+    int64_t dueTick = (nextSpan + ((slot - nextSpan) & (kWheelSize - 1)))
+                      << shift;
+    int prev = -1;
+    for (int event = buckets[bucket]; event != -1;
+         prev = event, event = events[event].next) {
+      const Event& e = events[event];
+      if (isListed[event] || e.bucket != bucket || e.prev != prev ||
+          e.state != EventState::kRunning || e.expired ||
+          e.expiryTick < dueTick ||
+          (wheel < kNumWheels - 1 &&
+           e.expiryTick >= dueTick + (int64_t{1} << shift))) {
+        return false;
+      }
+      isListed[event] = true;
+    }
+  }
+  // Every running event that has not expired is listed, and no other.
+  for (size_t i = 0; i < events.size(); ++i) {
+    const Event& e = events[i];
+    bool isScheduled = e.state == EventState::kRunning && !e.expired;
+    if (isListed[i] != isScheduled || (!isListed[i] && e.bucket != -1)) {
+      return false;
+    }
+  }
+  // The links of the bucket lists are indices of events and buckets, so they
+  // are restored as they are.
+  this->currentTick = currentTick;
+  this->events = std::move(events);
+  this->buckets = buckets;
+  return true;
+}
+
+const Timer::Event& Timer::GetEvent(int event) const {
+  assert(HasEvent(event) && "Event timer not found");
+  return events[event];
+}
+
+int64_t Timer::GetUsedTicks(const Event& e) const {
+  if (e.state == EventState::kRunning) {
+    return e.usedTicks + currentTick - e.startTick;
+  }
+  return e.usedTicks;
 }
 
-void Timer::CleanEvent(std::string eventName) {
-  eventTimers.erase(eventName);
-  startTimes.erase(eventName);
-  usedTimes.erase(eventName);
+void Timer::Schedule(int event) {
+  Event& e = events[event];
+  int64_t delta = e.expiryTick - currentTick;
+  if (delta <= 0) {
+    e.expired = true;
+    return;
+  }
+  // Pick the innermost wheel whose span covers the delay.
+  int wheel = 0;
+  while (wheel < kNumWheels - 1 &&
+         delta >= (int64_t{1} << ((wheel + 1) * kWheelBits))) {
+    ++wheel;
+  }
+  // An event beyond the span of the outermost wheel waits in its furthest
+  // bucket and is scheduled again when that bucket is cascaded.
+  int64_t tick = e.expiryTick;
+  int64_t maxDelta = (int64_t{1} << (kNumWheels * kWheelBits)) - 1;
+  if (delta > maxDelta) {
+    tick = currentTick + maxDelta;
+  }
+  int slot = static_cast<int>((tick >> (wheel * kWheelBits)) &
+                              (kWheelSize - 1));
+  Link(event, wheel * kWheelSize + slot);
 }
 
-bool Timer::HasEvent(std::string eventName) {
-  return eventTimers.find(eventName) != eventTimers.end();
+void Timer::Link(int event, int bucket) {
+  Event& e = events[event];
+  e.bucket = bucket;
+  e.prev = -1;
+  e.next = buckets[bucket];
+  if (e.next != -1) {
+    events[e.next].prev = event;
+  }
+  buckets[bucket] = event;
 }
 
-bool Timer::IsPaused(std::string eventName) {
-  assert(startTimes.find(eventName) != startTimes.end() &&
-         "Event start time not found");
-  return startTimes[eventName] < 0.f;
-}
\ No newline at end of file
+void Timer::Unlink(int event) {
+  Event& e = events[event];
+  if (e.bucket == -1) {
+    return;
+  }
+  if (e.prev != -1) {
+    events[e.prev].next = e.next;
+  } else {
+    buckets[e.bucket] = e.next;
+  }
+  if (e.next != -1) {
+    events[e.next].prev = e.prev;
+  }
+  e.bucket = -1;
+  e.prev = -1;
+  e.next = -1;
+}
@@ -1,57 +1,111 @@
 #pragma once
-#include <GLFW/glfw3.h>
-
+#include <array>
 #include <cassert>
-#include <string>
-#include <unordered_map>
-#include <utility>
-
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Snapshot.h"
+
+// Timer schedules the timed events of the game on the simulation ticks. Events
+// are referred to by small non-negative integer handles chosen by the caller.
+// Time only passes when Tick is called, so a replay of the same ticks expires
+// the same events on the same ticks.
+//
+// Running events are kept in a hierarchical timer wheel of kNumWheels wheels
+// with kWheelSize buckets each. An event due within kWheelSize ticks sits in
+// the bucket of its expiry tick on the innermost wheel, and later events sit
+// on an outer wheel until they are cascaded inward, so starting, pausing and
+// expiring an event takes constant time.
 class Timer {
  public:
-  // Constructor
-  Timer() = default;
+  static constexpr int kWheelBits = 6;
+  static constexpr int kWheelSize = 1 << kWheelBits;
+  static constexpr int kNumWheels = 4;
+
+  // Constructor. tickDuration is the time in seconds that passes per tick.
+  explicit Timer(float tickDuration);
 
   // Destructor
   ~Timer() = default;
 
+  // Advance the time by one tick and flag the events that expire.
+  void Tick();
+
   // Set timer for an event
-  void SetEventTimer(std::string eventName, float time);
+  void SetEventTimer(int event, float time);
 
   // Start the timer for an event
-  void StartEventTimer(std::string eventName);
+  void StartEventTimer(int event);
 
   // pause the timer for an event
-  void PauseEventTimer(std::string eventName);
+  void PauseEventTimer(int event);
 
   // resume the timer for an event
-  void ResumeEventTimer(std::string eventName);
+  void ResumeEventTimer(int event);
 
   // Check if the timer for an event has expired
-  bool IsEventTimerExpired(std::string eventName);
+  bool IsEventTimerExpired(int event) const;
 
   // clean an event
-  void CleanEvent(std::string eventName);
-
-  // Get event start time
-  float GetEventStartTime(std::string eventName);
+  void CleanEvent(int event);
 
   // Get event used time
-  float GetEventUsedTime(std::string eventName);
+  float GetEventUsedTime(int event) const;
 
   // Get event timer
-  float GetEventTimer(std::string eventName);
+  float GetEventTimer(int event) const;
 
   // Get event remaining time
-  float GetEventRemainingTime(std::string eventName);
+  float GetEventRemainingTime(int event) const;
 
   // Check if an event exists
-  bool HasEvent(std::string eventName);
+  bool HasEvent(int event) const;
 
   // It's paused
-  bool IsPaused(std::string eventName);
+  bool IsPaused(int event) const;
+
+  // Get the number of ticks since the timer was created.
+  int64_t GetCurrentTick() const;
+
+  // Write the current tick, the events and the wheels to a snapshot, or
+  // replace them with those read from one. Return false if the snapshot is
+  // invalid or was taken with another tick duration, in which case the timer
+  // is left as it was.
+  void Save(SnapshotWriter& writer) const;
+  bool Load(SnapshotReader& reader);
 
  private:
-  std::unordered_map<std::string, float> eventTimers;
-  std::unordered_map<std::string, float> usedTimes;
-  std::unordered_map<std::string, float> startTimes;
+  enum class EventState { kUnset, kSet, kRunning, kPaused };
+
+  struct Event {
+    EventState state{EventState::kUnset};
+    bool expired{false};
+    float time{0.f};
+    int64_t durationTicks{0};
+    // Tick at which the event was started or resumed, and the ticks it ran
+    // before it was last paused.
+    int64_t startTick{0};
+    int64_t usedTicks{0};
+    int64_t expiryTick{0};
+    // Links of the bucket list that holds the running event. bucket is -1
+    // when the event is not in the wheel.
+    int bucket{-1};
+    int prev{-1};
+    int next{-1};
+  };
+
+  float tickDuration;
+  int64_t currentTick{0};
+  std::vector<Event> events;
+  // Heads of the bucket lists, wheel by wheel. -1 means the bucket is empty.
+  std::array<int, kNumWheels * kWheelSize> buckets;
+
+  const Event& GetEvent(int event) const;
+  int64_t GetUsedTicks(const Event& e) const;
+  // Put a running event into the bucket of its expiry tick, or flag it as
+  // expired if that tick has been reached.
+  void Schedule(int event);
+  void Link(int event, int bucket);
+  void Unlink(int event);
 };